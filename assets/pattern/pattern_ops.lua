@@ -0,0 +1,25 @@
+-- Builders of the ops compiled by load_pattern_library (src/bullet_pattern/pattern_compiler.hpp)
+-- Registers: "angle", "speed", "spread", "offset"
+local ops = {}
+
+function ops.wait(ticks)            return { op = "wait", ticks = ticks } end
+function ops.set(register, value)   return { op = "set", register = register, value = value } end
+function ops.add(register, value)   return { op = "add", register = register, value = value } end
+
+-- Adds a random amount within [-amount, amount), the same for every run with the same seed
+function ops.jitter(register, amount) return { op = "jitter", register = register, value = amount } end
+
+-- Points the angle register at the target, plus 'offset' radians
+function ops.aim(offset)            return { op = "aim", value = offset or 0 } end
+
+-- 'count' bullets over a full turn / over the spread register
+function ops.ring(count)            return { op = "ring", count = count } end
+function ops.fan(count)             return { op = "fan", count = count } end
+
+function ops.bullet(name, radius)   return { op = "bullet", name = name, radius = radius } end
+
+-- 'rep' runs 'body' a number of times, 'loop' forever (it has to wait)
+function ops.rep(times, body)       return { op = "repeat", times = times, body = body } end
+function ops.loop(body)             return { op = "loop", body = body } end
+
+return ops
@@ -0,0 +1,56 @@
+local game_vars = require("game_vars")
+local ops = require("pattern_ops")
+
+local patterns = game_vars.attack_patterns
+local bullets = game_vars.bullet_names
+
+return {
+    -- 24 bullets every half a second, turning a little each time
+    {
+        id = patterns.ring,
+        program = {
+            ops.bullet(bullets.unknown, 5),
+            ops.set("speed", 1.5),
+            ops.loop {
+                ops.ring(24),
+                ops.add("angle", 0.13),
+                ops.wait(30)
+            }
+        }
+    },
+
+    -- Four arms turning continuously
+    {
+        id = patterns.spiral,
+        program = {
+            ops.bullet(bullets.unknown, 4),
+            ops.set("speed", 2),
+            ops.set("offset", 8),
+            ops.loop {
+                ops.ring(4),
+                ops.add("angle", 0.21),
+                ops.wait(3)
+            }
+        }
+    },
+
+    -- Three fans at the target, each faster than the last, then a pause
+    {
+        id = patterns.aimed_burst,
+        program = {
+            ops.bullet(bullets.unknown, 5),
+            ops.set("spread", 0.6),
+            ops.loop {
+                ops.aim(),
+                ops.jitter("angle", 0.05),
+                ops.set("speed", 2),
+                ops.rep(3, {
+                    ops.fan(5),
+                    ops.add("speed", 0.75),
+                    ops.wait(4)
+                }),
+                ops.wait(60)
+            }
+        }
+    }
+}
@@ -3,11 +3,20 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
-out vec2 TexCoord;
+// Per-instance attributes, see SpriteInstanceData
+layout (location = 2) in vec2 iOffset;
+layout (location = 3) in vec2 iScale;
+layout (location = 4) in float iRotation;
+layout (location = 5) in vec4 iUVRegion;
 
-uniform vec2 offset;
+out vec2 TexCoord;
 
 void main() {
-    gl_Position = vec4(aPos.xy + offset, aPos.z, 1.0f);
-    TexCoord = aTexCoord;
-}
\ No newline at end of file
+    float c = cos(iRotation);
+    float s = sin(iRotation);
+
+    vec2 pos = mat2(c, s, -s, c) * (aPos.xy * iScale) + iOffset;
+
+    gl_Position = vec4(pos, aPos.z, 1.0f);
+    TexCoord = mix(iUVRegion.xy, iUVRegion.zw, aTexCoord);
+}
@@ -25,5 +25,11 @@ return {
     },
     item_names = {
         unknown = 0
+    },
+    attack_patterns = {
+        none        = 0,
+        ring        = 1,
+        spiral      = 2,
+        aimed_burst = 3
     }
 }
\ No newline at end of file
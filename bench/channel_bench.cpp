@@ -0,0 +1,163 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "async_channel.hpp"
+#include "lock_free_channel.hpp"
+
+/*
+    Messages per millisecond and round trip latency of the channels
+
+    Usage: channel_bench [messages]
+
+    1p1c        one sender thread, one receiver thread, 'messages' messages
+    4p4c        four sender threads and four receiver threads sharing the ends, 'messages' in total
+                (not for SPSC, it allows a single thread per end)
+    ping-pong   a message back and forth over two channels, 'messages' / 10 round trips
+
+    Compares the mutex AsyncChannel with the lock-free SPSC and MPMC channels.
+    The lock-free channels hold LOCK_FREE_CAPACITY messages, a full channel makes the sender spin.
+    The receivers add up the messages, a wrong sum means lost or duplicated messages.
+*/
+namespace {
+    constexpr size_t LOCK_FREE_CAPACITY = 1024;
+
+    struct BenchResult {
+        size_t  messages;
+        double  msec;
+        bool    valid;
+    };
+
+    // Sum of 0 .. count - 1
+    uint64_t expected_sum(size_t count) {
+        return static_cast<uint64_t>(count) * (count - 1) / 2;
+    }
+
+    template <typename MakeChannel>
+    BenchResult run_throughput(MakeChannel make_channel, size_t producer_count, size_t consumer_count, size_t messages) {
+        auto [sender, receiver] = make_channel();
+
+        std::atomic<uint64_t> sum{0};
+        std::vector<std::thread> threads;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t c = 0; c < consumer_count; c++)
+        {
+            threads.emplace_back([&receiver = receiver, &sum] {
+                uint64_t local_sum = 0;
+
+                while (auto item = receiver.recv())
+                {
+                    local_sum += item.value();
+                }
+
+                sum += local_sum;
+            });
+        }
+
+        std::vector<std::thread> producers;
+
+        for (size_t p = 0; p < producer_count; p++)
+        {
+            // Producer 'p' sends every producer_count-th message
+            producers.emplace_back([&sender = sender, p, producer_count, messages] {
+                for (uint64_t i = p; i < messages; i += producer_count)
+                {
+                    sender.send(i);
+                }
+            });
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        // The receivers drain the channel, then see it closed
+        sender.close();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        return BenchResult{ messages, std::chrono::duration<double, std::milli>(elapsed).count(), sum == expected_sum(messages) };
+    }
+
+    template <typename MakeChannel>
+    BenchResult run_ping_pong(MakeChannel make_channel, size_t round_trips) {
+        auto [ping_sender, ping_receiver] = make_channel();
+        auto [pong_sender, pong_receiver] = make_channel();
+
+        std::thread echo([&ping_receiver = ping_receiver, &pong_sender = pong_sender] {
+            while (auto item = ping_receiver.recv())
+            {
+                pong_sender.send(item.value());
+            }
+        });
+
+        uint64_t sum = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t i = 0; i < round_trips; i++)
+        {
+            ping_sender.send(i);
+
+            if (auto item = pong_receiver.recv())
+            {
+                sum += item.value();
+            }
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        ping_sender.close();
+        echo.join();
+
+        return BenchResult{ round_trips, std::chrono::duration<double, std::milli>(elapsed).count(), sum == expected_sum(round_trips) };
+    }
+
+    void print_throughput(const std::string& name, const BenchResult& result) {
+        std::cout << name << ": " << result.messages << " messages in " << result.msec << " ms, "
+                  << (result.msec > 0.0 ? static_cast<double>(result.messages) / result.msec : 0.0) << " messages/ms"
+                  << (result.valid ? "" : " (WRONG SUM)") << "\n";
+    }
+
+    void print_round_trips(const std::string& name, const BenchResult& result) {
+        std::cout << name << ": " << result.messages << " round trips in " << result.msec << " ms, "
+                  << (result.messages > 0 ? result.msec * 1'000'000.0 / static_cast<double>(result.messages) : 0.0) << " ns per round trip"
+                  << (result.valid ? "" : " (WRONG SUM)") << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    const size_t round_trips = messages / 10;
+
+    const auto make_mutex = [] { return channel<uint64_t>(); };
+    const auto make_spsc = [] { return spsc_channel<uint64_t>(LOCK_FREE_CAPACITY); };
+    const auto make_mpmc = [] { return mpmc_channel<uint64_t>(LOCK_FREE_CAPACITY); };
+
+    std::cout << messages << " messages, " << std::thread::hardware_concurrency() << " hardware threads" << "\n";
+
+    print_throughput("mutex 1p1c", run_throughput(make_mutex, 1, 1, messages));
+    print_throughput("spsc 1p1c", run_throughput(make_spsc, 1, 1, messages));
+    print_throughput("mpmc 1p1c", run_throughput(make_mpmc, 1, 1, messages));
+
+    print_throughput("mutex 4p4c", run_throughput(make_mutex, 4, 4, messages));
+    print_throughput("mpmc 4p4c", run_throughput(make_mpmc, 4, 4, messages));
+
+    print_round_trips("mutex ping-pong", run_ping_pong(make_mutex, round_trips));
+    print_round_trips("spsc ping-pong", run_ping_pong(make_spsc, round_trips));
+    print_round_trips("mpmc ping-pong", run_ping_pong(make_mpmc, round_trips));
+
+    return EXIT_SUCCESS;
+}
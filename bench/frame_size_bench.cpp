@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include "packet_template/frame.hpp"
+#include "packet_serializer/frame_serializer.hpp"
+#include "packet_serializer/frame_delta_serializer.hpp"
+#include "game_server/game_logic_constants.hpp"
+
+/*
+    Bytes per bullet of every frame encoding, on synthetic frames
+
+    Usage: frame_size_bench [iterations]
+
+    The frames hold a player, 8 enemies and rings of 32 bullets flying out of the enemies,
+    the way the attack patterns fire them (same kind per ring, evenly spread angles).
+    The delta frame is one tick later: every bullet moved, 1/32 of the rings are gone and as many are new.
+    For each encoding prints the payload size, bytes per bullet, the bandwidth of one client
+    at the tick rate and the serialization time averaged over 'iterations'.
+    Every payload is decoded once, a failure is reported next to its size.
+*/
+namespace {
+    constexpr size_t BULLET_COUNTS[] = { 100, 1000, 5000, 20000 };
+    constexpr size_t RING_SIZE = 32;
+    constexpr size_t ENEMY_COUNT = 8;
+    constexpr float TWO_PI = 6.28318530718f;
+
+    struct BenchResult {
+        size_t  bytes;
+        double  usec;
+        bool    decoded;
+    };
+
+    BulletSnapshot make_bullet(uint32_t id, size_t ring, size_t index, uint32_t age) {
+        const auto angle = TWO_PI * static_cast<float>(index) / static_cast<float>(RING_SIZE);
+        const auto speed = 1.0f + static_cast<float>(ring % 4) * 0.5f;
+        const auto origin_x = (static_cast<float>(ring % ENEMY_COUNT) + 0.5f) / ENEMY_COUNT * game_logic_constants::GAME_WIDTH - game_logic_constants::GAME_WIDTH_HALF;
+        const auto origin_y = 120.0f;
+
+        auto bullet = BulletSnapshot{};
+        bullet.id               = id;
+        bullet.vel              = { std::cos(angle) * speed, std::sin(angle) * speed };
+        bullet.pos              = { origin_x + bullet.vel.x * static_cast<float>(age), origin_y + bullet.vel.y * static_cast<float>(age) };
+        bullet.radius           = game_logic_constants::ENEMY_BULLET_RADIUS;
+        bullet.angle            = angle;
+        bullet.damage           = 1;
+        bullet.name             = static_cast<uint8_t>(ring % 3);
+        bullet.state            = static_cast<uint8_t>(BulletState::Visible);
+        bullet.flight_pattern   = 0;
+        bullet.owner            = BULLET_OWNER_ENEMY;
+
+        return bullet;
+    }
+
+    /*
+        Ring 'r' was fired 'r % 60' ticks before 'tick', rings from 'first_ring' on are alive.
+        Bullet ids follow the rings, so a later frame keeps the ids of the surviving bullets.
+    */
+    FrameSnapshot make_frame(size_t bullet_count, size_t first_ring, uint32_t tick) {
+        auto frame = FrameSnapshot{};
+        frame.timestamp = tick;
+        frame.state     = GameState::Playing;
+
+        auto player = PlayerSnapshot{};
+        player.pos      = { 0.0f, -160.0f };
+        player.radius   = game_logic_constants::PLAYER_RADIUS;
+
+        frame.player_vector.push_back(player);
+
+        for (size_t i = 0; i < ENEMY_COUNT; i++)
+        {
+            auto enemy = EnemySnapshot{};
+            enemy.id        = static_cast<uint8_t>(i + 1);
+            enemy.pos       = { (static_cast<float>(i) + 0.5f) / ENEMY_COUNT * game_logic_constants::GAME_WIDTH - game_logic_constants::GAME_WIDTH_HALF, 120.0f };
+            enemy.radius    = game_logic_constants::ENEMY_RADIUS;
+            enemy.health    = 100;
+
+            frame.enemy_vector.push_back(enemy);
+        }
+
+        const auto ring_count = bullet_count / RING_SIZE;
+
+        for (size_t ring = first_ring; ring < first_ring + ring_count; ring++)
+        {
+            const auto age = static_cast<uint32_t>(ring % 60) + tick;
+
+            for (size_t i = 0; i < RING_SIZE; i++)
+            {
+                frame.bullet_vector.push_back(make_bullet(static_cast<uint32_t>(ring * RING_SIZE + i), ring, i, age));
+            }
+        }
+
+        frame.player_count  = static_cast<uint32_t>(frame.player_vector.size());
+        frame.enemy_count   = static_cast<uint32_t>(frame.enemy_vector.size());
+        frame.bullet_count  = static_cast<uint32_t>(frame.bullet_vector.size());
+
+        return frame;
+    }
+
+    template <typename Serialize, typename Deserialize>
+    BenchResult run(size_t iterations, Serialize serialize, Deserialize deserialize) {
+        std::vector<std::byte> buffer;
+        auto result = BenchResult{};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < iterations; i++)
+        {
+            buffer.clear();
+            serialize(buffer);
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        result.bytes    = buffer.size();
+        result.usec     = std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(iterations);
+        result.decoded  = deserialize(buffer);
+
+        return result;
+    }
+
+    void print_result(const std::string& name, size_t bullet_count, const BenchResult& result) {
+        const auto kbit_per_sec = static_cast<double>(result.bytes) * 8.0 * game_logic_constants::TICK_RATE / 1000.0;
+
+        std::cout << "  " << name << ": " << result.bytes << " bytes, "
+                  << static_cast<double>(result.bytes) / static_cast<double>(bullet_count) << " bytes/bullet, "
+                  << kbit_per_sec << " kbit/s, " << result.usec << " us"
+                  << (result.decoded ? "" : " (DECODE FAILED)") << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t iterations = std::max<size_t>(1, argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100);
+
+    for (const auto bullet_count : BULLET_COUNTS)
+    {
+        const auto baseline = make_frame(bullet_count, 0, 0);
+
+        // One tick later, the oldest rings are gone and as many new ones are fired
+        const auto replaced_rings = std::max<size_t>(1, bullet_count / RING_SIZE / 32);
+        const auto frame = make_frame(bullet_count, replaced_rings, 1);
+
+        std::cout << frame.bullet_count << " bullets" << "\n";
+
+        FrameSnapshot decoded;
+
+        print_result("keyframe", frame.bullet_count, run(iterations,
+            [&](std::vector<std::byte>& out) { serialize_frame_into(frame, out); },
+            [&](const std::vector<std::byte>& bytes) { return deserialize_frame_into(decoded, bytes.data(), bytes.size()); }
+        ));
+
+        print_result("compact keyframe", frame.bullet_count, run(iterations,
+            [&](std::vector<std::byte>& out) { serialize_frame_compact_into(frame, out); },
+            [&](const std::vector<std::byte>& bytes) { return deserialize_frame_compact_into(decoded, bytes.data(), bytes.size()); }
+        ));
+
+        print_result("delta", frame.bullet_count, run(iterations,
+            [&](std::vector<std::byte>& out) { serialize_frame_delta_into(baseline, frame, out, FrameEncoding::Full); },
+            [&](const std::vector<std::byte>& bytes) { return deserialize_frame_delta_into(decoded, baseline, bytes.data(), bytes.size(), FrameEncoding::Full); }
+        ));
+
+        print_result("compact delta", frame.bullet_count, run(iterations,
+            [&](std::vector<std::byte>& out) { serialize_frame_delta_into(baseline, frame, out, FrameEncoding::Compact); },
+            [&](const std::vector<std::byte>& bytes) { return deserialize_frame_delta_into(decoded, baseline, bytes.data(), bytes.size(), FrameEncoding::Compact); }
+        ));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <sol/sol.hpp>
+#include "config_constants.hpp"
+#include "bullet_pattern/pattern_compiler.hpp"
+#include "bullet_pattern/pattern_emitter.hpp"
+
+/*
+    Bullets emitted per millisecond by the attack patterns
+
+    Usage: pattern_bench [emitters] [ticks]
+
+    Every pattern of assets/pattern/patterns.lua runs on 'emitters' emitters for 'ticks' ticks,
+    plus a synthetic pattern that fires a ring of 256 bullets every tick (the peak rate).
+    The pool is cleared after every tick, only the emission is measured.
+*/
+namespace {
+    constexpr uint8_t PEAK_PATTERN = 255;
+
+    struct BenchResult {
+        size_t  bullets;
+        double  msec;
+    };
+
+    BenchResult run_pattern(const PatternLibrary& library, uint8_t pattern, size_t emitter_count, size_t ticks) {
+        std::vector<PatternEmitter> emitters(emitter_count, PatternEmitter(pattern));
+        std::vector<PatternContext> contexts(emitter_count);
+
+        for (size_t i = 0; i < emitter_count; i++)
+        {
+            const auto x = static_cast<float>(i % 16) * 20.0f - 160.0f;
+            const auto y = static_cast<float>(i / 16 % 16) * 10.0f;
+
+            contexts[i] = PatternContext{ { x, y }, { 0.0f, -180.0f }, BULLET_OWNER_ENEMY };
+        }
+
+        BulletPool bullets(4096);
+        size_t total = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t tick = 0; tick < ticks; tick++)
+        {
+            for (size_t i = 0; i < emitter_count; i++)
+            {
+                total += emitters[i].step(library, contexts[i], bullets);
+            }
+
+            bullets.clear();
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        return BenchResult{ total, std::chrono::duration<double, std::milli>(elapsed).count() };
+    }
+
+    void print_result(const std::string& name, const BenchResult& result) {
+        std::cout << name << ": " << result.bullets << " bullets in " << result.msec << " ms, "
+                  << (result.msec > 0.0 ? static_cast<double>(result.bullets) / result.msec : 0.0) << " bullets/ms" << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t emitter_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const size_t ticks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 600;
+
+    sol::state lua;
+    lua.open_libraries(
+        sol::lib::base,
+        sol::lib::package,
+        sol::lib::math
+    );
+
+    std::string lua_package_path = std::string(assets_constants::PATTERN_DIR)   + "/?.lua;"
+                                 + std::string(assets_constants::SPRITE_DIR)    + "/?.lua;";
+
+    lua.script("package.path = package.path .. \";" + lua_package_path + "\"");
+
+    const auto compile_start = std::chrono::steady_clock::now();
+    auto library_opt = load_pattern_library(lua, std::string(assets_constants::PATTERN_DIR) + "/patterns.lua");
+    const auto compile_elapsed = std::chrono::steady_clock::now() - compile_start;
+
+    if (!library_opt.has_value())
+    {
+        return EXIT_FAILURE;
+    }
+
+    auto& library = library_opt.value();
+
+    library.add(PEAK_PATTERN, {
+        { PatternOpcode::Ring, 0, 256, 0.0f },
+        { PatternOpcode::Wait, 0, 1,   0.0f },
+        { PatternOpcode::Jump, 0, 0,   0.0f }
+    });
+
+    std::cout << library.get_pattern_count() << " patterns, " << library.get_code_size() << " instructions, compiled in "
+              << std::chrono::duration<double, std::milli>(compile_elapsed).count() << " ms" << "\n";
+    std::cout << emitter_count << " emitters, " << ticks << " ticks" << "\n";
+
+    for (size_t id = 1; id < PATTERN_ID_COUNT; id++)
+    {
+        const auto pattern = static_cast<uint8_t>(id);
+
+        if (library.has_pattern(pattern))
+        {
+            const auto name = pattern == PEAK_PATTERN ? std::string("peak (ring of 256 every tick)") : "pattern " + std::to_string(id);
+
+            print_result(name, run_pattern(library, pattern, emitter_count, ticks));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
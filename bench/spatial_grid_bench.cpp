@@ -0,0 +1,174 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include "game_server/bullet_pool.hpp"
+#include "game_server/spatial_grid.hpp"
+
+/*
+    Broad-phase cost per tick at 1k, 10k and 50k bullets
+
+    Usage: spatial_grid_bench [ticks]
+
+    Every tick rebuilds both grids (enemy bullets and player shots) like GameSimulation,
+    then runs the player query with its graze radius and one query per enemy.
+    The bullets are spread uniformly over the field, 90% enemy bullets and 10% player shots,
+    and don't move, so every tick does the same work. The player query is also run as a
+    linear scan over the pool for comparison.
+*/
+namespace {
+    constexpr size_t BULLET_COUNTS[] = { 1000, 10000, 50000 };
+    constexpr size_t ENEMY_COUNT = 16;
+
+    struct BenchResult {
+        double  rebuild_msec    = 0.0;
+        double  player_msec     = 0.0;
+        double  enemy_msec      = 0.0;
+        double  scan_msec       = 0.0;
+        size_t  hits            = 0;
+        size_t  grazes          = 0;
+        size_t  enemy_hits      = 0;
+    };
+
+    double elapsed_msec(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void fill_pool(BulletPool& bullets, size_t count) {
+        // Fixed seed, every run measures the same field
+        std::mt19937 engine(12345);
+        std::uniform_real_distribution<float> x_dist(-game_logic_constants::GAME_WIDTH_HALF, game_logic_constants::GAME_WIDTH_HALF);
+        std::uniform_real_distribution<float> y_dist(-game_logic_constants::GAME_HEIGHT_HALF, game_logic_constants::GAME_HEIGHT_HALF);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            auto bullet = BulletSnapshot{};
+            bullet.pos      = { x_dist(engine), y_dist(engine) };
+            bullet.owner    = i % 10 == 0 ? BULLET_OWNER_PLAYER : BULLET_OWNER_ENEMY;
+            bullet.radius   = bullet.owner == BULLET_OWNER_PLAYER
+                ? game_logic_constants::PLAYER_BULLET_RADIUS
+                : game_logic_constants::ENEMY_BULLET_RADIUS;
+
+            bullets.spawn(bullet);
+        }
+    }
+
+    // Collisions only need the circles to overlap, the same test as SpatialGrid
+    size_t scan_player(const BulletPool& bullets, float x, float y, float radius, std::vector<uint32_t>& hits) {
+        const auto* pos_x = bullets.get_pos_x();
+        const auto* pos_y = bullets.get_pos_y();
+        const auto* radii = bullets.get_radius();
+        const auto* owners = bullets.get_owners();
+        const auto before = hits.size();
+
+        for (size_t i = 0; i < bullets.size(); i++)
+        {
+            const auto dx = pos_x[i] - x;
+            const auto dy = pos_y[i] - y;
+            const auto reach = radius + radii[i];
+
+            if (owners[i] == BULLET_OWNER_ENEMY && dx * dx + dy * dy < reach * reach)
+            {
+                hits.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        return hits.size() - before;
+    }
+
+    BenchResult run(size_t bullet_count, size_t ticks) {
+        BulletPool bullets(bullet_count);
+        fill_pool(bullets, bullet_count);
+
+        SpatialGrid enemy_bullet_grid;
+        SpatialGrid player_shot_grid;
+
+        std::vector<uint32_t> hits;
+        std::vector<uint32_t> grazes;
+
+        const auto player_x = 0.0f;
+        const auto player_y = -160.0f;
+
+        BenchResult result;
+
+        for (size_t tick = 0; tick < ticks; tick++)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            enemy_bullet_grid.rebuild(bullets, BULLET_OWNER_ENEMY);
+            player_shot_grid.rebuild(bullets, BULLET_OWNER_PLAYER);
+
+            result.rebuild_msec += elapsed_msec(start);
+
+            hits.clear();
+            grazes.clear();
+
+            start = std::chrono::steady_clock::now();
+
+            enemy_bullet_grid.query(
+                player_x,
+                player_y,
+                game_logic_constants::PLAYER_RADIUS,
+                game_logic_constants::PLAYER_GRAZE_RADIUS,
+                hits,
+                grazes
+            );
+
+            result.player_msec += elapsed_msec(start);
+            result.hits = hits.size();
+            result.grazes = grazes.size();
+
+            hits.clear();
+
+            start = std::chrono::steady_clock::now();
+
+            // The enemies line up across the upper half of the field
+            for (size_t i = 0; i < ENEMY_COUNT; i++)
+            {
+                const auto x = (static_cast<float>(i) + 0.5f) / ENEMY_COUNT * game_logic_constants::GAME_WIDTH - game_logic_constants::GAME_WIDTH_HALF;
+
+                player_shot_grid.query(x, 120.0f, game_logic_constants::ENEMY_RADIUS, hits);
+            }
+
+            result.enemy_msec += elapsed_msec(start);
+            result.enemy_hits = hits.size();
+
+            hits.clear();
+
+            start = std::chrono::steady_clock::now();
+            scan_player(bullets, player_x, player_y, game_logic_constants::PLAYER_RADIUS, hits);
+            result.scan_msec += elapsed_msec(start);
+        }
+
+        return result;
+    }
+
+    double to_usec_per_tick(double msec, size_t ticks) {
+        return ticks > 0 ? msec * 1000.0 / static_cast<double>(ticks) : 0.0;
+    }
+
+    void print_result(size_t bullet_count, size_t ticks, const BenchResult& result) {
+        std::cout << bullet_count << " bullets: "
+                  << "rebuild " << to_usec_per_tick(result.rebuild_msec, ticks) << " us, "
+                  << "player query " << to_usec_per_tick(result.player_msec, ticks) << " us "
+                  << "(" << result.hits << " hits, " << result.grazes << " grazes), "
+                  << ENEMY_COUNT << " enemy queries " << to_usec_per_tick(result.enemy_msec, ticks) << " us "
+                  << "(" << result.enemy_hits << " hits), "
+                  << "linear player scan " << to_usec_per_tick(result.scan_msec, ticks) << " us per tick" << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t ticks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 600;
+
+    std::cout << SPATIAL_GRID_COLUMNS << "x" << SPATIAL_GRID_ROWS << " cells, " << ticks << " ticks" << "\n";
+
+    for (const auto bullet_count : BULLET_COUNTS)
+    {
+        print_result(bullet_count, ticks, run(bullet_count, ticks));
+    }
+
+    return EXIT_SUCCESS;
+}
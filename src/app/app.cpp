@@ -1,13 +1,21 @@
 #include <iostream>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include <sol/sol.hpp>
 #include "app.hpp"
 #include "../config_constants.hpp"
 #include "../logger/logger.hpp"
 #include "../input_manager/input_manager.hpp"
 #include "../packet_stream/packet_stream.hpp"
+#include "../packet_stream/datagram_transport.hpp"
 #include "../renderer/renderer.hpp"
+#include "../renderer/render_list_buffer.hpp"
 #include "../renderable_resolver/renderable_resolver.hpp"
+#include "../snapshot_interpolator/snapshot_interpolator.hpp"
+#include "../player_predictor/player_predictor.hpp"
+#include "../game_server/game_logic_constants.hpp"
 
 App::App()
     : m_sdl_window(nullptr)
@@ -26,26 +34,40 @@ App::~App() {
     stop_async_logger();
 }
 
-AppResult App::run() {
+AppResult App::run(std::shared_ptr<ClientTransport> transport) {
     InputManager input_manager;
 
-    auto client_socket = std::make_shared<ClientSocket>(
-        socket_constants::SERVER_ADDR,
-        socket_constants::SERVER_PORT
-    );
+    std::shared_ptr<ClientSocket> client_socket;
 
-    if (!client_socket->connect_to_server())
+    if (transport == nullptr)
     {
-        async_log(LogLevel::Error, "Failed to connect to server");
+        client_socket = std::make_shared<ClientSocket>(
+            socket_constants::SERVER_ADDR,
+            socket_constants::SERVER_PORT
+        );
 
-        return AppResult {
-            AppExitStatus::SocketError
-        };
+        if (!client_socket->connect_to_server())
+        {
+            async_log(LogLevel::Error, "Failed to connect to server");
+
+            return AppResult {
+                AppExitStatus::SocketError
+            };
+        }
+
+        transport = std::make_shared<PacketStreamClient>(client_socket);
+
+        const auto datagram_address = DatagramSocket::resolve(socket_constants::SERVER_ADDR, socket_constants::SERVER_PORT);
+
+        if (socket_constants::ENABLE_DATAGRAM_TRANSPORT && datagram_address.has_value())
+        {
+            transport = std::make_shared<DatagramClientTransport>(transport, datagram_address.value());
+        }
     }
 
     show_window();
 
-    PacketStreamClient packet_stream(client_socket);
+    ClientTransport& packet_stream = *transport;
     packet_stream.start();
 
     // A closure that waits for a specific packet to arrive.
@@ -75,7 +97,15 @@ AppResult App::run() {
     };
 
     // Send client hello
-    packet_stream.send_packet(make_packet<ClientHello>({}));
+    auto hello = ClientHello{};
+    hello.frame_encodings = frame_encoding_bit(FrameEncoding::Full);
+
+    if (socket_constants::ENABLE_COMPACT_FRAMES)
+    {
+        hello.frame_encodings |= frame_encoding_bit(FrameEncoding::Compact);
+    }
+
+    packet_stream.send_packet(make_packet(hello));
     async_log(LogLevel::Debug, "Client hello has been sent");
 
     // Wait for server accept
@@ -111,9 +141,26 @@ AppResult App::run() {
     /*
         Renderable resolver
     */
-    auto renderer = Renderer{};
     auto resolver = RenderableResolver{};
-    auto renderable = std::vector<RenderableInstance>{};
+    auto render_lists = RenderListBuffer{};
+
+    /*
+        Snapshot interpolation
+    */
+    auto interpolator_config = SnapshotInterpolatorConfig{};
+    interpolator_config.interpolation_delay = std::chrono::milliseconds(render_constants::INTERPOLATION_DELAY_MSEC);
+
+    auto interpolator = SnapshotInterpolator(interpolator_config);
+    auto received_frames = std::vector<FrameSnapshot>{};
+    auto interpolated_frame = FrameSnapshot{};
+
+    /*
+        Client side prediction of the local player, stepped at the server tick rate
+    */
+    constexpr auto input_tick_interval = std::chrono::nanoseconds(1'000'000'000 / game_logic_constants::TICK_RATE);
+    constexpr auto max_input_backlog = 5 * input_tick_interval;
+
+    auto predictor = PlayerPredictor{};
 
     auto registry_path = std::string(assets_constants::REGISTRY_DIR) + "/game.lua";
     
@@ -142,11 +189,54 @@ AppResult App::run() {
         };
     }
 
-    bool render_quit = false;
+    /*
+        Render thread
+
+        Takes over the GL context and draws each new render list, at most at the swap rate.
+        It sleeps while no new list has been published, instead of redrawing the same one.
+        This thread keeps sampling input and polling frames, so a slow swap never delays input.
+    */
+    constexpr auto render_wait_timeout = std::chrono::milliseconds(100);
+
+    std::atomic<bool> render_quit = false;
+
+    SDL_GL_MakeCurrent(m_sdl_window, nullptr);
 
-    while (!render_quit)
+    std::thread render_thread([&]() {
+        SDL_GL_MakeCurrent(m_sdl_window, m_sdl_gl_context);
+
+        {
+            auto renderer = Renderer{};
+
+            while (!render_quit)
+            {
+                // Woken up now and then without a new list, to see 'render_quit'
+                if (!render_lists.acquire(render_wait_timeout))
+                {
+                    continue;
+                }
+
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                // Draw and swap buffer
+                renderer.draw(render_lists.front());
+
+                SDL_GL_SwapWindow(m_sdl_window);
+            }
+        }
+
+        SDL_GL_MakeCurrent(m_sdl_window, nullptr);
+    });
+
+    bool quit = false;
+    auto next_input_tick = std::chrono::steady_clock::now();
+
+    // The server keeps moving the ship in the last received direction, so releasing the arrows sends a stop
+    bool was_moving = false;
+
+    while (!quit)
     {
-        glClear(GL_COLOR_BUFFER_BIT);
+        const auto loop_start = std::chrono::steady_clock::now();
 
         input_manager.collect_input_events();
         const auto game_input = input_manager.get_game_input();
@@ -163,14 +253,32 @@ AppResult App::run() {
             async_log(LogLevel::Debug, "Quit has been pressed");
             async_log(LogLevel::Debug, "Exiting the draw loop");
 
-            render_quit = true;
+            quit = true;
         } 
 
-        // Send client input
-        if (game_input.arrows.pressed.any() || game_input.arrows.released.any())
+        // Don't replay a long stall as a burst of movement
+        if (loop_start - next_input_tick > max_input_backlog)
+        {
+            next_input_tick = loop_start;
+        }
+
+        // Send one client input per tick while moving, each one is predicted locally right away
+        while (next_input_tick <= loop_start)
         {
-            ClientInput input;
+            next_input_tick += input_tick_interval;
+
+            const auto is_moving = game_input.arrows.held.any();
+
+            if (!is_moving && !was_moving)
+            {
+                continue;
+            }
+
+            was_moving = is_moving;
+
+            ClientInput input = {};
             input.game_input = game_input;
+            input.input_sequence = predictor.apply_input(game_input.arrows);
 
             const auto packet = make_packet(input);
             const auto send_result = packet_stream.send_packet(packet);
@@ -181,20 +289,40 @@ AppResult App::run() {
             }
         }
 
-        // Get frame
-        auto frame_opt = packet_stream.poll_frame();
+        // Buffer every received frame
+        received_frames.clear();
+        packet_stream.poll_frames(received_frames);
 
-        if (frame_opt.has_value())
+        const auto now = std::chrono::steady_clock::now();
+
+        for (auto& frame : received_frames)
         {
-            renderable = resolver.resolve(frame_opt.value());
+            predictor.reconcile(frame);
+            interpolator.push(std::move(frame), now);
         }
 
-        // Draw and swap buffer
-        renderer.draw(renderable);
+        // A fresh render list every iteration, the render thread draws the latest one it finds
+        if (interpolator.sample(now, interpolated_frame))
+        {
+            // The local player is drawn where it is predicted now, not where the delayed snapshot has it
+            if (predictor.has_state() && !interpolated_frame.player_vector.empty())
+            {
+                interpolated_frame.player_vector[0] = predictor.get_player();
+            }
 
-        SDL_GL_SwapWindow(m_sdl_window);
+            resolver.resolve(FrameView(interpolated_frame), render_lists.back());
+            render_lists.publish();
+        }
+
+        std::this_thread::sleep_until(loop_start + std::chrono::milliseconds(input_constants::INPUT_POLL_INTERVAL_MSEC));
     }
 
+    render_quit = true;
+    render_thread.join();
+
+    // Take the context back, the resolver's GL resources are released on this thread
+    SDL_GL_MakeCurrent(m_sdl_window, m_sdl_gl_context);
+
     // Wait for server goodbye
     if (!wait_packet(PayloadType::ServerGoodbye, 1000, 10))
     {
@@ -206,7 +334,11 @@ AppResult App::run() {
     }
 
     packet_stream.stop();
-    client_socket->disconnect();
+
+    if (client_socket != nullptr)
+    {
+        client_socket->disconnect();
+    }
 
     return AppResult {
         AppExitStatus::Success
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <memory>
 #include <glad/glad.h>
 #include <SDL2/SDL.h>
+#include "../packet_stream/transport.hpp"
 
 struct SDLConfig {
     int             gl_context_major_version    = 4;
@@ -65,7 +67,8 @@ public:
 
     void cleanup();
 
-    AppResult run();
+    // Connects to the server over TCP unless a transport (e.g. a local loopback) is given
+    AppResult run(std::shared_ptr<ClientTransport> transport = nullptr);
 
 private:
     SDL_Window*     m_sdl_window;
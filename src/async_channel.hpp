@@ -4,6 +4,10 @@
 
 #include <iostream>
 #include <queue>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <utility>
 #include <mutex>
 #include <condition_variable>
@@ -19,8 +23,6 @@ std::pair<AsyncChannel<T>, AsyncChannel<T>> channel() {
     AsyncChannel<T> sender(state, true);
     AsyncChannel<T> receiver(std::move(state), false);
 
-    std::cerr << "[AsyncChannel] DEBUG: AsyncChannel has been established" << "\n";
-
     return {
         std::move(sender),
         std::move(receiver)
@@ -28,6 +30,10 @@ std::pair<AsyncChannel<T>, AsyncChannel<T>> channel() {
 }
 
 /*
+    Unbounded channel guarded by a mutex.
+    See lock_free_channel.hpp for the bounded lock-free SPSC / MPMC variants,
+    they share this interface.
+
     NOTE: AsyncChannel is not intended to be used as an instance.
     Be aware the constructor is private, It means the class is
     suppose to be created by the call of 'channel()'
@@ -65,6 +71,11 @@ public:
         return success;
     }
 
+    // The channel is unbounded, so this only fails if the channel is closed
+    bool try_send(T item) {
+        return send(std::move(item));
+    }
+
     std::optional<T> recv() {
         bool success = true;
         std::optional<T> item = std::nullopt;
@@ -95,6 +106,72 @@ public:
         return success ? item : std::nullopt;
     }
 
+    // Same as 'recv()', but returns std::nullopt instead of waiting if the queue is empty
+    std::optional<T> try_recv() {
+        if (is_sender_ || state_ == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        std::lock_guard lock(state_->mtx);
+
+        if (state_->queue.empty())
+        {
+            return std::nullopt;
+        }
+
+        std::optional<T> item = std::move(state_->queue.front());
+        state_->queue.pop();
+
+        return item;
+    }
+
+    // Moves up to 'max_items' items to the back of 'out' without waiting, returns the number of items
+    size_t recv_many(std::vector<T>& out, size_t max_items) {
+        if (is_sender_ || state_ == nullptr)
+        {
+            return 0;
+        }
+
+        std::lock_guard lock(state_->mtx);
+
+        size_t count = 0;
+
+        while (count < max_items && !state_->queue.empty())
+        {
+            out.push_back(std::move(state_->queue.front()));
+            state_->queue.pop();
+            count++;
+        }
+
+        return count;
+    }
+
+    // Same as 'recv()', but gives up after 'timeout'
+    template <typename Rep, typename Period>
+    std::optional<T> recv_for(const std::chrono::duration<Rep, Period>& timeout) {
+        if (is_sender_ || state_ == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        std::unique_lock lock(state_->mtx);
+
+        state_->cv.wait_for(lock, timeout, [this] {
+            return !state_->queue.empty() || state_->closed;
+        });
+
+        if (state_->queue.empty())
+        {
+            return std::nullopt;
+        }
+
+        std::optional<T> item = std::move(state_->queue.front());
+        state_->queue.pop();
+
+        return item;
+    }
+
     bool closed() {
         if (!state_)
         {
@@ -0,0 +1,267 @@
+#include <cmath>
+#include <iostream>
+#include "pattern_compiler.hpp"
+#include "../game_server/game_logic_constants.hpp"
+
+namespace {
+    struct CompileState {
+        std::vector<PatternInstruction>     program;
+        uint32_t                            loop_depth = 0;
+        std::string                         error;
+    };
+
+    bool compile_block(sol::table block, CompileState& state, bool& waits);
+
+    void emit(CompileState& state, PatternOpcode opcode, uint8_t reg = 0, uint32_t count = 0, float value = 0.0f) {
+        state.program.push_back(PatternInstruction{ opcode, reg, static_cast<uint16_t>(count), value });
+    }
+
+    // Reads an integer field within [min, max]
+    bool get_integer(sol::table op, const char* key, uint32_t min, uint32_t max, uint32_t& out, CompileState& state) {
+        const double value = op.get_or(key, -1.0);
+
+        if (std::floor(value) != value || value < min || value > max)
+        {
+            state.error = "'" + std::string(key) + "' must be an integer within [" + std::to_string(min) + ", " + std::to_string(max) + "]";
+
+            return false;
+        }
+
+        out = static_cast<uint32_t>(value);
+
+        return true;
+    }
+
+    bool get_register(sol::table op, uint8_t& out, CompileState& state) {
+        const auto name = op.get_or("register", std::string{});
+
+        if      (name == "angle")   { out = PATTERN_REGISTER_ANGLE;     }
+        else if (name == "speed")   { out = PATTERN_REGISTER_SPEED;     }
+        else if (name == "spread")  { out = PATTERN_REGISTER_SPREAD;    }
+        else if (name == "offset")  { out = PATTERN_REGISTER_OFFSET;    }
+        else
+        {
+            state.error = "Unknown register '" + name + "'";
+
+            return false;
+        }
+
+        return true;
+    }
+
+    bool get_body(sol::table op, sol::table& out, CompileState& state) {
+        sol::optional<sol::table> body_opt = op["body"];
+
+        if (!body_opt.has_value() || body_opt.value().size() == 0)
+        {
+            state.error = "'body' must be a non-empty list of ops";
+
+            return false;
+        }
+
+        out = body_opt.value();
+
+        return true;
+    }
+
+    bool compile_op(sol::table op, CompileState& state, bool& waits) {
+        const auto name = op.get_or("op", std::string{});
+        uint32_t count = 0;
+        uint8_t reg = 0;
+
+        if (name == "wait")
+        {
+            if (!get_integer(op, "ticks", 1, UINT16_MAX, count, state))
+                return false;
+
+            emit(state, PatternOpcode::Wait, 0, count);
+            waits = true;
+        }
+        else if (name == "set" || name == "add")
+        {
+            if (!get_register(op, reg, state))
+                return false;
+
+            emit(state, name == "set" ? PatternOpcode::Set : PatternOpcode::Add, reg, 0, op.get_or("value", 0.0f));
+        }
+        else if (name == "jitter")
+        {
+            if (!get_register(op, reg, state))
+                return false;
+
+            emit(state, PatternOpcode::Jitter, reg, 0, op.get_or("value", 0.0f));
+        }
+        else if (name == "aim")
+        {
+            emit(state, PatternOpcode::Aim, PATTERN_REGISTER_ANGLE, 0, op.get_or("value", 0.0f));
+        }
+        else if (name == "ring" || name == "fan")
+        {
+            if (!get_integer(op, "count", 1, PATTERN_MAX_SHOTS, count, state))
+                return false;
+
+            emit(state, name == "ring" ? PatternOpcode::Ring : PatternOpcode::Fan, 0, count);
+        }
+        else if (name == "bullet")
+        {
+            if (!get_integer(op, "name", 0, UINT8_MAX, count, state))
+                return false;
+
+            emit(state, PatternOpcode::Bullet, 0, count, op.get_or("radius", game_logic_constants::ENEMY_BULLET_RADIUS));
+        }
+        else if (name == "repeat")
+        {
+            sol::table body;
+
+            if (!get_integer(op, "times", 1, UINT16_MAX, count, state) || !get_body(op, body, state))
+                return false;
+
+            if (state.loop_depth == PATTERN_MAX_LOOP_DEPTH)
+            {
+                state.error = "Repeats are nested deeper than " + std::to_string(PATTERN_MAX_LOOP_DEPTH);
+
+                return false;
+            }
+
+            emit(state, PatternOpcode::Repeat, 0, count);
+            const auto body_start = state.program.size();
+
+            state.loop_depth++;
+
+            if (!compile_block(body, state, waits))
+                return false;
+
+            state.loop_depth--;
+
+            emit(state, PatternOpcode::Next, 0, static_cast<uint32_t>(body_start));
+        }
+        else if (name == "loop")
+        {
+            sol::table body;
+
+            if (!get_body(op, body, state))
+                return false;
+
+            const auto body_start = state.program.size();
+            auto body_waits = false;
+
+            if (!compile_block(body, state, body_waits))
+                return false;
+
+            // Otherwise the emitter would spin until PATTERN_MAX_STEPS_PER_TICK every tick
+            if (!body_waits)
+            {
+                state.error = "'loop' must wait";
+
+                return false;
+            }
+
+            emit(state, PatternOpcode::Jump, 0, static_cast<uint32_t>(body_start));
+            waits = true;
+        }
+        else
+        {
+            state.error = "Unknown op '" + name + "'";
+
+            return false;
+        }
+
+        // Targets are 16 bit
+        if (state.program.size() > PATTERN_MAX_CODE_SIZE)
+        {
+            state.error = "The program is longer than " + std::to_string(PATTERN_MAX_CODE_SIZE) + " instructions";
+
+            return false;
+        }
+
+        return true;
+    }
+
+    // 'waits' is set if the block contains a Wait, a block has no branches so every pass waits
+    bool compile_block(sol::table block, CompileState& state, bool& waits) {
+        for (std::size_t i = 1; i <= block.size(); i++)
+        {
+            if (!block[i].is<sol::table>())
+            {
+                state.error = "Op " + std::to_string(i) + " is not a table";
+
+                return false;
+            }
+
+            if (!compile_op(block[i], state, waits))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+std::optional<PatternLibrary> load_pattern_library(sol::state& lua, const std::string& library_path) {
+    sol::protected_function_result result = lua.safe_script_file(library_path, &sol::script_pass_on_error);
+
+    if (!result.valid())
+    {
+        sol::error err = result;
+        std::cerr << "[load_pattern_library] ERROR: Failed to load '" << library_path << "'\n";
+        std::cerr << "Lua error: " << err.what() << "\n";
+
+        return std::nullopt;
+    }
+
+    sol::object obj = result;
+
+    if (!obj.is<sol::table>())
+    {
+        std::cerr << "[load_pattern_library] ERROR: Lua file did not return a table.\n";
+
+        return std::nullopt;
+    }
+
+    sol::table pattern_list = obj.as<sol::table>();
+    PatternLibrary library;
+
+    for (std::size_t i = 1; i <= pattern_list.size(); i++)
+    {
+        if (!pattern_list[i].is<sol::table>())
+        {
+            std::cerr << "[load_pattern_library] WARNING: Invalid pattern entry at index " << i << ". Skipped." << "\n";
+
+            continue;
+        }
+
+        sol::table pattern_tbl = pattern_list[i];
+        sol::optional<sol::table> program_opt = pattern_tbl["program"];
+
+        const double id = pattern_tbl.get_or("id", -1.0);
+
+        if (std::floor(id) != id || id <= PATTERN_NONE || id >= PATTERN_ID_COUNT || !program_opt.has_value())
+        {
+            std::cerr << "[load_pattern_library] WARNING: Pattern at index " << i << " needs an 'id' within [1, 255] and a 'program'. Skipped." << "\n";
+
+            continue;
+        }
+
+        CompileState state;
+        auto waits = false;
+
+        if (!compile_block(program_opt.value(), state, waits))
+        {
+            std::cerr << "[load_pattern_library] ERROR: Pattern " << id << ": " << state.error << ". Skipped." << "\n";
+
+            continue;
+        }
+
+        emit(state, PatternOpcode::End);
+
+        if (!library.add(static_cast<uint8_t>(id), state.program))
+        {
+            std::cerr << "[load_pattern_library] ERROR: Pattern " << id << " is defined twice or the library is full. Skipped." << "\n";
+
+            continue;
+        }
+    }
+
+    return library;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <sol/sol.hpp>
+#include "pattern_program.hpp"
+
+/*
+    Runs the Lua script at 'library_path' and compiles the patterns it returns.
+
+    The script returns a list of { id = <1..255>, program = { <op>, ... } }, where the ops
+    are the tables built by assets/pattern/pattern_ops.lua, e.g.
+
+        { op = "ring", count = 24 }
+        { op = "loop", body = { <op>, ... } }
+
+    Lua only runs here, the programs are executed by PatternEmitter.
+    Invalid patterns are skipped with an error, std::nullopt is returned if the script fails.
+*/
+std::optional<PatternLibrary> load_pattern_library(sol::state& lua, const std::string& library_path);
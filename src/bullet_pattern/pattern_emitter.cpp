@@ -0,0 +1,264 @@
+#include <cmath>
+#include <iostream>
+#include "pattern_emitter.hpp"
+#include "../game_server/game_logic_constants.hpp"
+#include "../game_simulation/deterministic_math.hpp"
+
+namespace {
+    constexpr float PI      = 3.14159265358979f;
+    constexpr float TWO_PI  = 2.0f * PI;
+}
+
+PatternEmitter::PatternEmitter()
+    : PatternEmitter(PATTERN_NONE)
+{}
+
+PatternEmitter::PatternEmitter(uint8_t pattern) {
+    reset(pattern);
+}
+
+void PatternEmitter::reset(uint8_t pattern) {
+    m_pattern   = pattern;
+    m_started   = false;
+    m_finished  = pattern == PATTERN_NONE;
+
+    m_pc        = 0;
+    m_wait      = 0;
+
+    m_registers.fill(0.0f);
+    m_registers[PATTERN_REGISTER_SPEED]     = PATTERN_DEFAULT_SPEED;
+    m_registers[PATTERN_REGISTER_SPREAD]    = PATTERN_DEFAULT_SPREAD;
+
+    m_loop_counters.fill(0);
+    m_loop_depth = 0;
+
+    m_bullet_name   = 0;
+    m_bullet_radius = game_logic_constants::ENEMY_BULLET_RADIUS;
+}
+
+size_t PatternEmitter::step(const PatternLibrary& library, const PatternContext& context, BulletPool& bullets) {
+    if (m_finished)
+    {
+        return 0;
+    }
+
+    // The entry is resolved on the first step, the emitter may be created before the library is loaded
+    if (!m_started)
+    {
+        if (!library.has_pattern(m_pattern))
+        {
+            m_finished = true;
+
+            return 0;
+        }
+
+        m_started = true;
+        m_pc = library.get_entry(m_pattern);
+    }
+
+    if (m_wait > 0 && --m_wait > 0)
+    {
+        return 0;
+    }
+
+    const auto* code = library.get_code();
+    size_t spawned = 0;
+
+    for (uint32_t steps = 0; steps < PATTERN_MAX_STEPS_PER_TICK; steps++)
+    {
+        const auto& instruction = code[m_pc++];
+
+        switch (instruction.opcode)
+        {
+            case PatternOpcode::End:
+            {
+                m_finished = true;
+
+                return spawned;
+            }
+
+            case PatternOpcode::Wait:
+            {
+                m_wait = instruction.count;
+
+                return spawned;
+            }
+
+            case PatternOpcode::Set:
+            {
+                m_registers[instruction.reg] = instruction.value;
+
+                break;
+            }
+
+            case PatternOpcode::Add:
+            {
+                m_registers[instruction.reg] += instruction.value;
+
+                // Spirals add to the angle forever, keep it where floats are precise
+                if (instruction.reg == PATTERN_REGISTER_ANGLE)
+                {
+                    m_registers[instruction.reg] = std::remainder(m_registers[instruction.reg], TWO_PI);
+                }
+
+                break;
+            }
+
+            case PatternOpcode::Aim:
+            {
+                const auto dx = context.target.x - context.origin.x;
+                const auto dy = context.target.y - context.origin.y;
+
+                m_registers[instruction.reg] = std::remainder(deterministic_atan2(dy, dx) + instruction.value, TWO_PI);
+
+                break;
+            }
+
+            case PatternOpcode::Ring:
+            {
+                const auto angle_step = TWO_PI / static_cast<float>(instruction.count);
+
+                spawned += fire(instruction.count, m_registers[PATTERN_REGISTER_ANGLE], angle_step, context, bullets);
+
+                break;
+            }
+
+            case PatternOpcode::Fan:
+            {
+                const auto spread = m_registers[PATTERN_REGISTER_SPREAD];
+                const auto angle_step = instruction.count > 1 ? spread / static_cast<float>(instruction.count - 1) : 0.0f;
+                const auto first_angle = instruction.count > 1 ? m_registers[PATTERN_REGISTER_ANGLE] - spread * 0.5f : m_registers[PATTERN_REGISTER_ANGLE];
+
+                spawned += fire(instruction.count, first_angle, angle_step, context, bullets);
+
+                break;
+            }
+
+            case PatternOpcode::Bullet:
+            {
+                m_bullet_name   = static_cast<uint8_t>(instruction.count);
+                m_bullet_radius = instruction.value;
+
+                break;
+            }
+
+            case PatternOpcode::Repeat:
+            {
+                // The library only holds validated programs, this is the last line of defense
+                if (m_loop_depth == PATTERN_MAX_LOOP_DEPTH)
+                {
+                    std::cerr << "[PatternEmitter] ERROR: Pattern " << static_cast<uint32_t>(m_pattern)
+                              << " nested Repeats deeper than " << PATTERN_MAX_LOOP_DEPTH << " and has been stopped" << "\n";
+
+                    m_finished = true;
+
+                    return spawned;
+                }
+
+                m_loop_counters[m_loop_depth++] = instruction.count;
+
+                break;
+            }
+
+            case PatternOpcode::Next:
+            {
+                if (m_loop_depth == 0)
+                {
+                    std::cerr << "[PatternEmitter] ERROR: Pattern " << static_cast<uint32_t>(m_pattern)
+                              << " reached a Next outside of any Repeat and has been stopped" << "\n";
+
+                    m_finished = true;
+
+                    return spawned;
+                }
+
+                if (--m_loop_counters[m_loop_depth - 1] > 0)
+                {
+                    m_pc = instruction.count;
+                }
+                else
+                {
+                    m_loop_depth--;
+                }
+
+                break;
+            }
+
+            case PatternOpcode::Jump:
+            {
+                m_pc = instruction.count;
+
+                break;
+            }
+
+            case PatternOpcode::Jitter:
+            {
+                if (context.random != nullptr)
+                {
+                    m_registers[instruction.reg] += context.random->next_range(-instruction.value, instruction.value);
+                }
+
+                // Jittered every cycle, the angle would random walk away like a spiral
+                if (instruction.reg == PATTERN_REGISTER_ANGLE)
+                {
+                    m_registers[instruction.reg] = std::remainder(m_registers[instruction.reg], TWO_PI);
+                }
+
+                break;
+            }
+        }
+    }
+
+    // The compiler makes every loop wait, only huge Repeats end up here
+    std::cerr << "[PatternEmitter] ERROR: Pattern " << static_cast<uint32_t>(m_pattern)
+              << " ran " << PATTERN_MAX_STEPS_PER_TICK << " instructions in one tick and has been stopped" << "\n";
+
+    m_finished = true;
+
+    return spawned;
+}
+
+uint8_t PatternEmitter::get_pattern() const {
+    return m_pattern;
+}
+
+bool PatternEmitter::is_finished() const {
+    return m_finished;
+}
+
+size_t PatternEmitter::fire(uint32_t count, float first_angle, float angle_step, const PatternContext& context, BulletPool& bullets) {
+    const auto speed = m_registers[PATTERN_REGISTER_SPEED];
+    const auto offset = m_registers[PATTERN_REGISTER_OFFSET];
+
+    // The directions are rotated along instead of calling cos and sin per bullet
+    auto dir_x = deterministic_cos(first_angle);
+    auto dir_y = deterministic_sin(first_angle);
+
+    const auto step_cos = deterministic_cos(angle_step);
+    const auto step_sin = deterministic_sin(angle_step);
+
+    auto bullet = BulletSnapshot{};
+    bullet.damage           = 1;
+    bullet.name             = m_bullet_name;
+    bullet.radius           = m_bullet_radius;
+    bullet.state            = static_cast<uint8_t>(BulletState::Visible);
+    bullet.flight_pattern   = m_pattern;
+    bullet.owner            = context.owner;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bullet.pos      = { context.origin.x + dir_x * offset, context.origin.y + dir_y * offset };
+        bullet.vel      = { dir_x * speed, dir_y * speed };
+        bullet.angle    = first_angle + angle_step * static_cast<float>(i);
+
+        bullets.spawn(bullet);
+
+        const auto next_x = dir_x * step_cos - dir_y * step_sin;
+        const auto next_y = dir_x * step_sin + dir_y * step_cos;
+
+        dir_x = next_x;
+        dir_y = next_y;
+    }
+
+    return count;
+}
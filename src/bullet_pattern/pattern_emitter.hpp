@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "pattern_program.hpp"
+#include "../game_server/bullet_pool.hpp"
+#include "../game_simulation/simulation_random.hpp"
+
+// Registers of a fresh emitter, the angle and the offset start at zero
+constexpr float PATTERN_DEFAULT_SPEED   = 2.0f;
+constexpr float PATTERN_DEFAULT_SPREAD  = 0.5f;
+
+// Where an emitter fires from and at, updated by its owner every tick
+struct PatternContext {
+    Position2D          origin;
+    Position2D          target;
+    uint8_t             owner;              // BulletOwner of the spawned bullets
+    SimulationRandom*   random = nullptr;   // Jitter does nothing without it
+};
+
+/*
+    Runs one pattern of a PatternLibrary.
+
+    'step()' is called once per tick and interprets instructions until the pattern
+    waits or ends, the bullets of its shots are spawned straight into the pool.
+    No Lua is involved at run time, and no libm: the same program gives bit-identical
+    bullets on every build (see deterministic_math.hpp).
+*/
+class PatternEmitter {
+public:
+    PatternEmitter();
+    explicit PatternEmitter(uint8_t pattern);
+
+    // Starts 'pattern' from its first instruction
+    void reset(uint8_t pattern);
+
+    // Returns the number of spawned bullets
+    size_t step(const PatternLibrary& library, const PatternContext& context, BulletPool& bullets);
+
+    uint8_t get_pattern() const;
+    bool is_finished() const;
+
+private:
+    size_t fire(uint32_t count, float first_angle, float angle_step, const PatternContext& context, BulletPool& bullets);
+
+    uint8_t                                         m_pattern;
+    bool                                            m_started;
+    bool                                            m_finished;
+
+    uint32_t                                        m_pc;
+    uint32_t                                        m_wait;
+
+    std::array<float, PATTERN_REGISTER_COUNT>       m_registers;
+    std::array<uint32_t, PATTERN_MAX_LOOP_DEPTH>    m_loop_counters;
+    uint32_t                                        m_loop_depth;
+
+    uint8_t                                         m_bullet_name;
+    float                                           m_bullet_radius;
+};
@@ -0,0 +1,172 @@
+#include "pattern_program.hpp"
+
+namespace {
+    /*
+        The checks PatternEmitter relies on: registers exist, targets stay in the program,
+        Repeat and Next are nested properly, Jumps stay in their loop and the last
+        instruction never falls through.
+    */
+    bool is_valid_program(const std::vector<PatternInstruction>& program) {
+        std::array<size_t, PATTERN_MAX_LOOP_DEPTH> open_loops{};
+        size_t depth = 0;
+
+        // Innermost loop around every instruction, as the index of its body (0 outside of any loop)
+        std::vector<size_t> enclosing_loops(program.size(), 0);
+
+        for (size_t i = 0; i < program.size(); i++)
+        {
+            const auto& instruction = program[i];
+
+            // A Repeat belongs to the outer loop, a Next to the one it closes
+            enclosing_loops[i] = depth > 0 ? open_loops[depth - 1] : 0;
+
+            switch (instruction.opcode)
+            {
+                case PatternOpcode::Set:
+                case PatternOpcode::Add:
+                case PatternOpcode::Aim:
+                case PatternOpcode::Jitter:
+                {
+                    if (instruction.reg >= PATTERN_REGISTER_COUNT)
+                    {
+                        return false;
+                    }
+
+                    break;
+                }
+
+                case PatternOpcode::Wait:
+                case PatternOpcode::Ring:
+                case PatternOpcode::Fan:
+                {
+                    if (instruction.count == 0 || (instruction.opcode != PatternOpcode::Wait && instruction.count > PATTERN_MAX_SHOTS))
+                    {
+                        return false;
+                    }
+
+                    break;
+                }
+
+                case PatternOpcode::Repeat:
+                {
+                    if (instruction.count == 0 || depth == PATTERN_MAX_LOOP_DEPTH)
+                    {
+                        return false;
+                    }
+
+                    open_loops[depth++] = i + 1;
+
+                    break;
+                }
+
+                case PatternOpcode::Next:
+                {
+                    if (depth == 0 || instruction.count != open_loops[--depth])
+                    {
+                        return false;
+                    }
+
+                    break;
+                }
+
+                case PatternOpcode::Jump:
+                {
+                    if (instruction.count >= program.size())
+                    {
+                        return false;
+                    }
+
+                    break;
+                }
+
+                case PatternOpcode::End:
+                case PatternOpcode::Bullet:
+                {
+                    break;
+                }
+
+                default:
+                {
+                    return false;
+                }
+            }
+        }
+
+        const auto last = program.back().opcode;
+
+        if (depth != 0 || (last != PatternOpcode::End && last != PatternOpcode::Jump))
+        {
+            return false;
+        }
+
+        /*
+            The emitter keeps a counter per open Repeat, a Jump into or out of a loop
+            would leave the counters of another loop (or none at all) to its Next
+        */
+        for (size_t i = 0; i < program.size(); i++)
+        {
+            if (program[i].opcode == PatternOpcode::Jump && enclosing_loops[program[i].count] != enclosing_loops[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+PatternLibrary::PatternLibrary()
+    : m_pattern_count(0)
+{
+    m_entries.fill(NO_ENTRY);
+}
+
+bool PatternLibrary::add(uint8_t id, const std::vector<PatternInstruction>& program) {
+    if (id == PATTERN_NONE || has_pattern(id) || program.empty() || !is_valid_program(program))
+    {
+        return false;
+    }
+
+    if (m_code.size() + program.size() > PATTERN_MAX_CODE_SIZE)
+    {
+        return false;
+    }
+
+    const auto entry = static_cast<uint32_t>(m_code.size());
+
+    // Relocate the targets into the stream
+    for (auto instruction : program)
+    {
+        if (instruction.opcode == PatternOpcode::Next || instruction.opcode == PatternOpcode::Jump)
+        {
+            instruction.count = static_cast<uint16_t>(instruction.count + entry);
+        }
+
+        m_code.push_back(instruction);
+    }
+
+    m_entries[id] = entry;
+    m_pattern_count++;
+
+    return true;
+}
+
+bool PatternLibrary::has_pattern(uint8_t id) const {
+    return m_entries[id] != NO_ENTRY;
+}
+
+uint32_t PatternLibrary::get_entry(uint8_t id) const {
+    return m_entries[id];
+}
+
+const PatternInstruction* PatternLibrary::get_code() const {
+    return m_code.data();
+}
+
+size_t PatternLibrary::get_code_size() const {
+    return m_code.size();
+}
+
+size_t PatternLibrary::get_pattern_count() const {
+    return m_pattern_count;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Instruction set of the bullet patterns
+
+    The patterns are written in Lua (assets/pattern), compiled once at load time
+    by 'load_pattern_library()' and executed by PatternEmitter once per tick.
+*/
+enum class PatternOpcode : uint8_t {
+    End,        // Stops the emitter
+    Wait,       // Suspends the emitter for 'count' ticks
+    Set,        // registers[reg] = value
+    Add,        // registers[reg] += value
+    Aim,        // registers[reg] = direction from the emitter to the target + value
+    Ring,       // 'count' bullets evenly over a full turn, the first one at the angle register
+    Fan,        // 'count' bullets over the spread register, centered on the angle register
+    Bullet,     // Bullet kind of the following shots, name = 'count', radius = 'value'
+    Repeat,     // Runs the instructions up to the matching Next 'count' times
+    Next,       // Back to instruction 'count' (the first after the Repeat), until the Repeat is done
+    Jump,       // Continues at instruction 'count'
+    Jitter      // registers[reg] += uniform random in [-value, value), from the simulation's seeded generator
+};
+
+enum PatternRegister : uint8_t {
+    PATTERN_REGISTER_ANGLE      = 0,    // Radians, kept within [-pi, pi]
+    PATTERN_REGISTER_SPEED      = 1,    // Pixels per tick
+    PATTERN_REGISTER_SPREAD     = 2,    // Radians covered by a Fan
+    PATTERN_REGISTER_OFFSET     = 3,    // Distance from the emitter at which the bullets spawn
+    PATTERN_REGISTER_COUNT      = 4
+};
+
+/*
+    Pattern instruction (8bytes)
+*/
+struct PatternInstruction {
+    PatternOpcode   opcode;
+    uint8_t         reg;
+    uint16_t        count;
+    float           value;
+};
+
+static_assert(sizeof(PatternInstruction) == 8);
+
+constexpr size_t    PATTERN_ID_COUNT            = 256;      // Patterns are selected by a uint8_t attack_pattern
+constexpr uint8_t   PATTERN_NONE                = 0;        // attack_pattern of an entity that doesn't fire
+constexpr size_t    PATTERN_MAX_CODE_SIZE       = 65535;    // Jump targets are 16 bit
+constexpr uint32_t  PATTERN_MAX_SHOTS           = 1024;     // Bullets of a single Ring or Fan
+constexpr uint32_t  PATTERN_MAX_LOOP_DEPTH      = 4;        // Nested Repeats
+constexpr uint32_t  PATTERN_MAX_STEPS_PER_TICK  = 4096;     // Instructions an emitter may run in one tick
+
+/*
+    Every compiled pattern in a single instruction stream.
+    Jump and Next targets are indices into the whole stream.
+*/
+class PatternLibrary {
+public:
+    PatternLibrary();
+
+    /*
+        'program' is compiled from index 0, its targets are relocated.
+        Returns false if 'id' is taken, the program is malformed or the stream would outgrow PATTERN_MAX_CODE_SIZE.
+    */
+    bool add(uint8_t id, const std::vector<PatternInstruction>& program);
+
+    bool has_pattern(uint8_t id) const;
+
+    // Index of the first instruction of the pattern, 'has_pattern(id)' must be true
+    uint32_t get_entry(uint8_t id) const;
+
+    const PatternInstruction* get_code() const;
+    size_t get_code_size() const;
+    size_t get_pattern_count() const;
+
+private:
+    static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+    std::vector<PatternInstruction>             m_code;
+    std::array<uint32_t, PATTERN_ID_COUNT>      m_entries;
+    size_t                                      m_pattern_count;
+};
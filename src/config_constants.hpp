@@ -22,6 +22,7 @@ namespace assets_constants {
     constexpr std::string_view  MESH_DIR        = PROJECT_ROOT_DIR "/assets/mesh";
     constexpr std::string_view  SHADER_DIR      = PROJECT_ROOT_DIR "/assets/shader";
     constexpr std::string_view  TEXTURE_DIR     = PROJECT_ROOT_DIR "/assets/texture";
+    constexpr std::string_view  PATTERN_DIR     = PROJECT_ROOT_DIR "/assets/pattern";
 }
 
 namespace logger_constants {
@@ -33,6 +34,30 @@ namespace render_constants {
     constexpr std::string_view  WINDOW_NAME     = "bullet_hell";
     constexpr size_t            WINDOW_WIDTH    = 600;
     constexpr size_t            WINDOW_HEIGHT   = 800;
+
+    // Frames are rendered this far behind the newest snapshot and interpolated
+    constexpr size_t            INTERPOLATION_DELAY_MSEC    = 50;
+}
+
+namespace input_constants {
+    // Input is sampled and sent at this interval, independent of the swap rate
+    constexpr size_t            INPUT_POLL_INTERVAL_MSEC    = 2;
+}
+
+namespace replay_constants {
+    // Game sessions write an input log per session here, see game_simulation/input_log.hpp
+    constexpr std::string_view  INPUT_LOG_DIR   = PROJECT_ROOT_DIR "/replay";
+
+#ifdef BUILD_SERVER
+    constexpr bool              ENABLE_INPUT_LOG    = true;
+#else
+    constexpr bool              ENABLE_INPUT_LOG    = false;
+#endif
+}
+
+namespace profiling_constants {
+    // The server prints the phase histograms of the session ticks at this interval
+    constexpr uint64_t          TICK_PROFILE_DUMP_INTERVAL_SEC  = 10;
 }
 
 namespace socket_constants {
@@ -52,5 +77,12 @@ namespace socket_constants {
     constexpr size_t                SERVER_MAX_INSTANCES    = 10;
 #endif
 
-    constexpr uint32_t  SERVER_MAX_PACKET_SIZE  = 10 * 1024 * 1024; // 10MB
+    constexpr uint32_t  SERVER_MAX_PACKET_SIZE  = 10 * 1024 * 1024; // 10MB, frames with tens of thousands of bullets
+    constexpr uint32_t  CLIENT_MAX_PACKET_SIZE  = 4 * 1024;         // 4KB, hello, input, ack and goodbye
+
+    // Send frames and inputs over UDP next to the TCP stream, on the same port number
+    constexpr bool      ENABLE_DATAGRAM_TRANSPORT   = true;
+
+    // Offer FrameEncoding::Compact (quantized positions, bit-packed entities) in ClientHello
+    constexpr bool      ENABLE_COMPACT_FRAMES       = true;
 }
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include <cmath>
+#include "bullet_pool.hpp"
+#include "game_logic_constants.hpp"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define BULLET_POOL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define BULLET_POOL_SSE
+#endif
+
+namespace {
+    constexpr float CULL_HALF_WIDTH     = game_logic_constants::GAME_WIDTH_HALF;
+    constexpr float CULL_HALF_HEIGHT    = game_logic_constants::GAME_HEIGHT_HALF;
+
+    /*
+        Scalar kernel, also used for the tail of the SIMD kernels
+        A bullet is culled once it is entirely outside of the playfield
+    */
+    void integrate_scalar(
+        float* pos_x, float* pos_y,
+        const float* vel_x, const float* vel_y,
+        const float* radius,
+        size_t begin, size_t end,
+        float dt,
+        std::vector<uint32_t>& culled
+    ) {
+        for (size_t i = begin; i < end; i++)
+        {
+            pos_x[i] += vel_x[i] * dt;
+            pos_y[i] += vel_y[i] * dt;
+
+            const auto out_x = std::fabs(pos_x[i]) > CULL_HALF_WIDTH + radius[i];
+            const auto out_y = std::fabs(pos_y[i]) > CULL_HALF_HEIGHT + radius[i];
+
+            if (out_x || out_y)
+            {
+                culled.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    // 'mask' holds one bit per SIMD lane, set if the bullet has to be culled
+    void push_culled_lanes(int mask, size_t base, std::vector<uint32_t>& culled) {
+        for (size_t lane = 0; mask != 0; lane++, mask >>= 1)
+        {
+            if (mask & 1)
+            {
+                culled.push_back(static_cast<uint32_t>(base + lane));
+            }
+        }
+    }
+
+#if defined(BULLET_POOL_AVX)
+    void integrate(
+        float* pos_x, float* pos_y,
+        const float* vel_x, const float* vel_y,
+        const float* radius,
+        size_t count,
+        float dt,
+        std::vector<uint32_t>& culled
+    ) {
+        const auto dt_v         = _mm256_set1_ps(dt);
+        const auto half_w       = _mm256_set1_ps(CULL_HALF_WIDTH);
+        const auto half_h       = _mm256_set1_ps(CULL_HALF_HEIGHT);
+        const auto abs_mask     = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            auto x = _mm256_loadu_ps(pos_x + i);
+            auto y = _mm256_loadu_ps(pos_y + i);
+
+            x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(vel_x + i), dt_v));
+            y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(vel_y + i), dt_v));
+
+            _mm256_storeu_ps(pos_x + i, x);
+            _mm256_storeu_ps(pos_y + i, y);
+
+            const auto r = _mm256_loadu_ps(radius + i);
+
+            const auto out_x = _mm256_cmp_ps(_mm256_and_ps(x, abs_mask), _mm256_add_ps(half_w, r), _CMP_GT_OQ);
+            const auto out_y = _mm256_cmp_ps(_mm256_and_ps(y, abs_mask), _mm256_add_ps(half_h, r), _CMP_GT_OQ);
+
+            push_culled_lanes(_mm256_movemask_ps(_mm256_or_ps(out_x, out_y)), i, culled);
+        }
+
+        integrate_scalar(pos_x, pos_y, vel_x, vel_y, radius, i, count, dt, culled);
+    }
+#elif defined(BULLET_POOL_SSE)
+    void integrate(
+        float* pos_x, float* pos_y,
+        const float* vel_x, const float* vel_y,
+        const float* radius,
+        size_t count,
+        float dt,
+        std::vector<uint32_t>& culled
+    ) {
+        const auto dt_v         = _mm_set1_ps(dt);
+        const auto half_w       = _mm_set1_ps(CULL_HALF_WIDTH);
+        const auto half_h       = _mm_set1_ps(CULL_HALF_HEIGHT);
+        const auto abs_mask     = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            auto x = _mm_loadu_ps(pos_x + i);
+            auto y = _mm_loadu_ps(pos_y + i);
+
+            x = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(vel_x + i), dt_v));
+            y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(vel_y + i), dt_v));
+
+            _mm_storeu_ps(pos_x + i, x);
+            _mm_storeu_ps(pos_y + i, y);
+
+            const auto r = _mm_loadu_ps(radius + i);
+
+            const auto out_x = _mm_cmpgt_ps(_mm_and_ps(x, abs_mask), _mm_add_ps(half_w, r));
+            const auto out_y = _mm_cmpgt_ps(_mm_and_ps(y, abs_mask), _mm_add_ps(half_h, r));
+
+            push_culled_lanes(_mm_movemask_ps(_mm_or_ps(out_x, out_y)), i, culled);
+        }
+
+        integrate_scalar(pos_x, pos_y, vel_x, vel_y, radius, i, count, dt, culled);
+    }
+#else
+    void integrate(
+        float* pos_x, float* pos_y,
+        const float* vel_x, const float* vel_y,
+        const float* radius,
+        size_t count,
+        float dt,
+        std::vector<uint32_t>& culled
+    ) {
+        integrate_scalar(pos_x, pos_y, vel_x, vel_y, radius, 0, count, dt, culled);
+    }
+#endif
+}
+
+BulletPool::BulletPool(size_t capacity)
+    : m_next_id(1)
+{
+    m_pos_x.reserve(capacity);
+    m_pos_y.reserve(capacity);
+    m_vel_x.reserve(capacity);
+    m_vel_y.reserve(capacity);
+    m_radius.reserve(capacity);
+    m_flags.reserve(capacity);
+
+    m_ids.reserve(capacity);
+    m_angle.reserve(capacity);
+    m_damage.reserve(capacity);
+    m_name.reserve(capacity);
+    m_state.reserve(capacity);
+    m_flight_pattern.reserve(capacity);
+    m_owner.reserve(capacity);
+
+    m_culled.reserve(capacity);
+}
+
+uint32_t BulletPool::spawn(const BulletSnapshot& bullet) {
+    const auto id = m_next_id++;
+
+    m_pos_x.push_back(bullet.pos.x);
+    m_pos_y.push_back(bullet.pos.y);
+    m_vel_x.push_back(bullet.vel.x);
+    m_vel_y.push_back(bullet.vel.y);
+    m_radius.push_back(bullet.radius);
+    m_flags.push_back(BULLET_FLAG_NONE);
+
+    m_ids.push_back(id);
+    m_angle.push_back(bullet.angle);
+    m_damage.push_back(bullet.damage);
+    m_name.push_back(bullet.name);
+    m_state.push_back(bullet.state);
+    m_flight_pattern.push_back(bullet.flight_pattern);
+    m_owner.push_back(bullet.owner);
+
+    return id;
+}
+
+void BulletPool::remove(size_t index) {
+    const auto last = size() - 1;
+
+    if (index != last)
+    {
+        m_pos_x[index]          = m_pos_x[last];
+        m_pos_y[index]          = m_pos_y[last];
+        m_vel_x[index]          = m_vel_x[last];
+        m_vel_y[index]          = m_vel_y[last];
+        m_radius[index]         = m_radius[last];
+        m_flags[index]          = m_flags[last];
+
+        m_ids[index]            = m_ids[last];
+        m_angle[index]          = m_angle[last];
+        m_damage[index]         = m_damage[last];
+        m_name[index]           = m_name[last];
+        m_state[index]          = m_state[last];
+        m_flight_pattern[index] = m_flight_pattern[last];
+        m_owner[index]          = m_owner[last];
+    }
+
+    m_pos_x.pop_back();
+    m_pos_y.pop_back();
+    m_vel_x.pop_back();
+    m_vel_y.pop_back();
+    m_radius.pop_back();
+    m_flags.pop_back();
+
+    m_ids.pop_back();
+    m_angle.pop_back();
+    m_damage.pop_back();
+    m_name.pop_back();
+    m_state.pop_back();
+    m_flight_pattern.pop_back();
+    m_owner.pop_back();
+}
+
+void BulletPool::clear() {
+    m_pos_x.clear();
+    m_pos_y.clear();
+    m_vel_x.clear();
+    m_vel_y.clear();
+    m_radius.clear();
+    m_flags.clear();
+
+    m_ids.clear();
+    m_angle.clear();
+    m_damage.clear();
+    m_name.clear();
+    m_state.clear();
+    m_flight_pattern.clear();
+    m_owner.clear();
+}
+
+void BulletPool::set_flags(size_t index, uint8_t flags) {
+    m_flags[index] = flags;
+}
+
+size_t BulletPool::step(float dt) {
+    m_culled.clear();
+
+    integrate(
+        m_pos_x.data(), m_pos_y.data(),
+        m_vel_x.data(), m_vel_y.data(),
+        m_radius.data(),
+        size(),
+        dt,
+        m_culled
+    );
+
+    /*
+        Remove from the back, so the bullet swapped into a hole
+        has always been checked (and kept) already
+    */
+    size_t removed = 0;
+
+    for (auto it = m_culled.rbegin(); it != m_culled.rend(); ++it)
+    {
+        if (m_flags[*it] & BULLET_FLAG_NO_CULL)
+        {
+            continue;
+        }
+
+        remove(*it);
+        removed++;
+    }
+
+    return removed;
+}
+
+void BulletPool::pack(std::vector<BulletSnapshot>& out) const {
+    const auto count = size();
+
+    out.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto& bullet = out[i];
+
+        bullet.id               = m_ids[i];
+        bullet.pos              = { m_pos_x[i], m_pos_y[i] };
+        bullet.vel              = { m_vel_x[i], m_vel_y[i] };
+        bullet.radius           = m_radius[i];
+        bullet.angle            = m_angle[i];
+        bullet.damage           = m_damage[i];
+        bullet.name             = m_name[i];
+        bullet.state            = m_state[i];
+        bullet.flight_pattern   = m_flight_pattern[i];
+        bullet.owner            = m_owner[i];
+    }
+}
+
+size_t BulletPool::size() const {
+    return m_pos_x.size();
+}
+
+bool BulletPool::empty() const {
+    return m_pos_x.empty();
+}
+
+const float* BulletPool::get_pos_x() const {
+    return m_pos_x.data();
+}
+
+const float* BulletPool::get_pos_y() const {
+    return m_pos_y.data();
+}
+
+const float* BulletPool::get_radius() const {
+    return m_radius.data();
+}
+
+const uint8_t* BulletPool::get_flags() const {
+    return m_flags.data();
+}
+
+const uint8_t* BulletPool::get_owners() const {
+    return m_owner.data();
+}
+
+const uint32_t* BulletPool::get_ids() const {
+    return m_ids.data();
+}
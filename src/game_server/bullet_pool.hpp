@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../packet_template/frame.hpp"
+
+/*
+    Bullet flags
+*/
+enum BulletFlag : uint8_t {
+    BULLET_FLAG_NONE        = 0,
+    BULLET_FLAG_GRAZED      = 1 << 0,   // Already counted as a graze
+    BULLET_FLAG_NO_CULL     = 1 << 1,   // Survives leaving the playfield (e.g. bouncing patterns)
+};
+
+/*
+    Server side bullet storage in structure-of-arrays layout.
+
+    The hot fields (position, velocity, radius, flags) live in separate
+    contiguous arrays so the per-tick integration and culling can be run
+    as SIMD kernels over thousands of bullets. The remaining fields of
+    BulletSnapshot are only touched when packing the frame.
+
+    Bullets are addressed by index, indices are NOT stable:
+    'remove' swaps the last bullet into the hole (O(1)).
+    Use the id to identify a bullet across ticks.
+*/
+class BulletPool {
+public:
+    explicit BulletPool(size_t capacity = 1024);
+
+    // Returns the id assigned to the new bullet ('bullet.id' is ignored)
+    uint32_t spawn(const BulletSnapshot& bullet);
+    void remove(size_t index);
+    void clear();
+
+    void set_flags(size_t index, uint8_t flags);
+
+    /*
+        Advances every bullet by 'vel * dt' and removes the ones that left the playfield.
+        Returns the number of removed bullets.
+    */
+    size_t step(float dt = 1.0f);
+
+    // Writes every bullet to 'out' in one pass, reusing its capacity
+    void pack(std::vector<BulletSnapshot>& out) const;
+
+    size_t size() const;
+    bool empty() const;
+
+    // Read-only views of the arrays, each has 'size()' elements
+    const float* get_pos_x() const;
+    const float* get_pos_y() const;
+    const float* get_radius() const;
+    const uint8_t* get_flags() const;
+    const uint8_t* get_owners() const;
+    const uint32_t* get_ids() const;
+
+private:
+    // Hot data
+    std::vector<float>      m_pos_x;
+    std::vector<float>      m_pos_y;
+    std::vector<float>      m_vel_x;
+    std::vector<float>      m_vel_y;
+    std::vector<float>      m_radius;
+    std::vector<uint8_t>    m_flags;
+
+    // Cold data
+    std::vector<uint32_t>   m_ids;
+    std::vector<float>      m_angle;
+    std::vector<uint32_t>   m_damage;
+    std::vector<uint8_t>    m_name;
+    std::vector<uint8_t>    m_state;
+    std::vector<uint8_t>    m_flight_pattern;
+    std::vector<uint8_t>    m_owner;
+
+    // Indices of the bullets culled by the last step (ascending)
+    std::vector<uint32_t>   m_culled;
+
+    uint32_t                m_next_id;
+};
@@ -1,16 +1,18 @@
 #include <iostream>
-#include <cmath>        // std::sqrt
-#include <algorithm>    // std::clamp
 #include "game_server.hpp"
-#include "game_logic_constants.hpp"
+#include "game_session.hpp"
 #include "../packet_stream/packet_stream.hpp"
-#include "../packet_template/packet_template.hpp"
+#include "../packet_stream/loopback_transport.hpp"
+#include "../bullet_pattern/pattern_compiler.hpp"
+#include "../config_constants.hpp"
 
 GameServerMaster::GameServerMaster(uint16_t server_port, size_t max_instances)
-    : m_ready_to_accept(false)
+    : m_server_port(server_port)
     , m_running(false)
-    , m_max_instances(max_instances)
-    , m_active_instances(0)
+    , m_ready_to_accept(false)
+    , m_patterns(std::make_shared<const PatternLibrary>())
+    , m_datagram_endpoint(std::make_shared<DatagramEndpoint>())
+    , m_scheduler(max_instances)
 {
     m_server_socket = std::make_shared<ServerSocket>(
         server_port
@@ -22,15 +24,50 @@ GameServerMaster::~GameServerMaster() {
 }
 
 bool GameServerMaster::initialize() {
+    load_patterns();
+
     return m_server_socket->initialize();
 }
 
+void GameServerMaster::load_patterns() {
+    // The server has its own state, sol::state is not thread safe
+    sol::state lua;
+    lua.open_libraries(
+        sol::lib::base,
+        sol::lib::package,
+        sol::lib::math
+    );
+
+    // game_vars.lua lives next to the sprites
+    std::string lua_package_path = std::string(assets_constants::PATTERN_DIR)   + "/?.lua;"
+                                 + std::string(assets_constants::SPRITE_DIR)    + "/?.lua;";
+
+    std::string lua_script = "package.path = package.path .. \";" + lua_package_path + "\"";
+    lua.script(lua_script);
+
+    const auto library_path = std::string(assets_constants::PATTERN_DIR) + "/patterns.lua";
+    auto library_opt = load_pattern_library(lua, library_path);
+
+    if (!library_opt.has_value())
+    {
+        std::cerr << "[GameServerMaster] ERROR: Failed to load the attack patterns, enemies will not fire" << "\n";
+
+        return;
+    }
+
+    std::cout << "[GameServerMaster] DEBUG: " << library_opt->get_pattern_count() << " attack patterns have been compiled ("
+              << library_opt->get_code_size() << " instructions)" << "\n";
+
+    m_patterns = std::make_shared<const PatternLibrary>(std::move(library_opt.value()));
+}
+
 void GameServerMaster::run() {
     if (!m_running)
     {
         std::cout << "[GameServerMaster] DEBUG: Game server has been started" << "\n";
 
         m_running = true;
+        start_workers();
         accept_loop();
     }
 }
@@ -39,6 +76,7 @@ void GameServerMaster::run_async() {
     if (!m_running)
     {
         m_running = true;
+        start_workers();
         m_accept_thread = std::thread(&GameServerMaster::accept_loop, this);
 
         std::cout << "[GameServerMaster] DEBUG: Accept thread has been created" << "\n";
@@ -59,7 +97,28 @@ void GameServerMaster::stop() {
 
             std::cout << "[GameServerMaster] DEBUG: Accept thread has been joined" << "\n";
         }
+
+        m_scheduler.stop();
+        m_datagram_endpoint->close();
+        m_reactor.stop();
+    }
+}
+
+void GameServerMaster::start_workers() {
+    if (!m_reactor.start())
+    {
+        std::cout << "[GameServerMaster] DEBUG: Network reactor is not available, "
+                  << "falling back to a receive thread per connection" << "\n";
+    }
+
+    // The same port number as the stream, UDP has its own port space
+    if (!m_datagram_endpoint->open(m_server_port, m_reactor.is_running() ? &m_reactor : nullptr))
+    {
+        std::cout << "[GameServerMaster] DEBUG: Datagram endpoint is not available, "
+                  << "frames and inputs stay on the packet stream" << "\n";
     }
+
+    m_scheduler.start();
 }
 
 bool GameServerMaster::wait_for_accept_ready(size_t timeout_msec, size_t max_attempts) {
@@ -107,11 +166,22 @@ void GameServerMaster::accept_loop() {
         );
 
         std::cout << "[GameServerMaster] DEBUG: client_conn accepted" << "\n";
-        
-        auto current = m_active_instances.load();
 
-        // CAS (Compare-And-Swap)
-        if (m_active_instances >= m_max_instances || !m_active_instances.compare_exchange_strong(current, current + 1))
+        std::shared_ptr<ServerTransport> transport = std::make_shared<PacketStreamServer>(client_conn);
+
+        if (m_datagram_endpoint->is_open())
+        {
+            transport = std::make_shared<DatagramServerTransport>(transport, m_datagram_endpoint);
+        }
+
+        auto session = std::make_shared<GameSession>(
+            transport,
+            m_reactor.is_running() ? &m_reactor : nullptr,
+            m_patterns
+        );
+
+        // The scheduler enforces the maximum number of instances
+        if (!m_scheduler.admit(session))
         {
             std::cerr << "[GameServerMaster] DEBUG: The maximum number of instances has been reached"
                       << " and the client connection has been refused." << "\n";
@@ -121,195 +191,47 @@ void GameServerMaster::accept_loop() {
             continue;
         }
 
-        // Create thread
-        auto worker_thread = std::thread([this, client_conn]() {
-            handle_client(client_conn);
-            m_active_instances.fetch_sub(1);
-        });
-            
-        worker_thread.detach();
-
         std::cout << "[GameServerMaster] DEBUG: Game Instance has been created" << "\n"
-                  << "[GameServerMaster] DEBUG: " << m_active_instances << " instances are active" << "\n";
+                  << "[GameServerMaster] DEBUG: " << m_scheduler.get_active_sessions() << " instances are active" << "\n";
     }
 
     m_ready_to_accept = false;
 }
 
-void apply_player_input(
-    PlayerSnapshot& player,
-    const InputDirection& input,
-    float speed = game_logic_constants::PLAYER_SPEED
-) {
-    constexpr float inv_sqrt2 = 0.70710678f;
-
-    float dx = 0.0f;
-    float dy = 0.0f;
-
-    switch (input)
-    {
-        case InputDirection::Up:        { dy = +1.0f;                       break; }
-        case InputDirection::Down:      { dy = -1.0f;                       break; }
-        case InputDirection::Right:     { dx = +1.0f;                       break; }
-        case InputDirection::Left:      { dx = -1.0f;                       break; }
-        case InputDirection::UpRight:   { dx = +inv_sqrt2; dy = +inv_sqrt2; break; }
-        case InputDirection::DownRight: { dx = +inv_sqrt2; dy = -inv_sqrt2; break; }
-        case InputDirection::UpLeft:    { dx = -inv_sqrt2; dy = +inv_sqrt2; break; }
-        case InputDirection::DownLeft:  { dx = -inv_sqrt2; dy = -inv_sqrt2; break; }
-
-        case InputDirection::Stop:
-        default: return;
-    }
-
-    player.pos = {
-        player.pos.x = std::clamp(player.pos.x + dx * speed, -192.0f, 192.f),
-        player.pos.y = std::clamp(player.pos.y + dy * speed, -224.0f, 224.0f)
-    };
-}
-
-void GameServerMaster::handle_client(std::shared_ptr<ClientConnection> client_conn) {
-    PacketStreamServer packet_stream(client_conn);
-    packet_stream.start();
-
-    // A closure that waits for a specific packet to arrive.
-    auto wait_packet = [&](PayloadType payload_type, size_t timeout_msec, size_t max_attempts) -> bool {
-        for (size_t attempt = 0; attempt < max_attempts; attempt++)
-        {
-            std::optional<Packet> packet_opt = packet_stream.poll_packet();
-
-            if (packet_opt.has_value())
-            {
-                if (packet_opt.value().header.payload_type == payload_type)
-                {
-                    return true;
-                }
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_msec));
-        }
-
-        return false;
-    };
-
-    FrameSnapshot frame = {};
-    frame.player_count = 1;
-
-    PlayerSnapshot player = {};
-    frame.player_vector.push_back(player);
-
-    ArrowState arrow_state = {};
-
-    auto quit = false;
-
-    // msec / FPS
-    constexpr auto target_frame_duration = std::chrono::milliseconds(1000 / 60);
-
-    // Wait for client hello
-    if (!wait_packet(PayloadType::ClientHello, 1000, 10))
+std::shared_ptr<ClientTransport> GameServerMaster::connect_local() {
+    if (!m_running)
     {
-        std::cout << "[GameServerMaster] DEBUG: Client hello timeout" << "\n";
+        std::cerr << "[GameServerMaster] ERROR: The server is not running" << "\n";
 
-        return;
+        return nullptr;
     }
 
-    // Send server accept
-    packet_stream.send_packet(make_packet<ServerAccept>({}));
-    std::cout << "[GameServerMaster] DEBUG: Server accept has been sent" << "\n";
+    auto transport = make_loopback_transport();
+    auto session = std::make_shared<GameSession>(transport.server, nullptr, m_patterns);
 
-    // Wait for client game request
-    if (!wait_packet(PayloadType::ClientGameRequest, 1000, 1000))
+    if (!m_scheduler.admit(session))
     {
-        std::cout << "[GameServerMaster] DEBUG: Client game request timeout" << "\n";
+        std::cerr << "[GameServerMaster] DEBUG: The maximum number of instances has been reached"
+                  << " and the local client has been refused." << "\n";
 
-        return;
+        return nullptr;
     }
 
-    // Send server game response
-    packet_stream.send_packet(make_packet<ServerGameResponse>({}));
-    std::cout << "[GameServerMaster] DEBUG: Server game response has been sent" << "\n";
-
-    // Game logic loop
-    while (m_running && !quit)
-    {
-        auto frame_start = std::chrono::steady_clock::now();
-
-        // Check if the recv thread is alive
-        const auto expr_1 = packet_stream.get_recv_exception() == nullptr;
-        const auto expr_2 = packet_stream.is_running();
-
-        if (!expr_1 || !expr_2)
-        {
-            break;
-        }
-
-        // Process the packet queue
-        while (true)
-        {
-            std::optional<Packet> packet_opt = packet_stream.poll_packet();
-
-            if (!packet_opt.has_value())
-            {
-                break;
-            }
-
-            Packet packet = std::move(*packet_opt);
-
-            switch (packet.header.payload_type)
-            {
-                case PayloadType::ClientInput:
-                {
-                    std::cout << "[GameServerMaster] DEBUG: Received client input" << "\n";
-
-                    const auto input_snapshot = std::get<ClientInput>(packet.payload);
-                    arrow_state.held |= input_snapshot.game_input.arrows.pressed;
-                    arrow_state.held &= ~input_snapshot.game_input.arrows.released;
-
-                    break;
-                }
-
-                case PayloadType::ClientGoodbye:
-                {
-                    std::cout << "[GameServerMaster] DEBUG: Received client goodbye" << "\n";
-
-                    const auto packet = make_packet<ServerGoodbye>({});
-                    packet_stream.send_packet(packet);
-
-                    quit = true;
-
-                    break;
-                }
-
-                default:
-                {
-                    std::cerr << "[GameServerMaster] DEBUG: Unexpected message type: "
-                            << static_cast<uint32_t>(packet.header.payload_type) << "\n";
-                    break;
-                }
-            }
-        }
+    transport.client->start();
 
-        auto direction = get_direction_from_arrows(arrow_state);
-        apply_player_input(frame.player_vector[0], direction);
-                
-        const auto packet = make_packet<FrameSnapshot>(frame);
-        packet_stream.send_packet(packet);
+    std::cout << "[GameServerMaster] DEBUG: Local game instance has been created" << "\n";
 
-        // Adjust the frame rate
-        auto frame_end = std::chrono::steady_clock::now();
-        auto frame_duration = std::chrono::duration_cast<std::chrono::milliseconds>(frame_end - frame_start);
+    return transport.client;
+}
 
-        if (frame_duration < target_frame_duration)
-        {
-            std::this_thread::sleep_for(target_frame_duration - frame_duration);
-        }
-        else
-        {
-            std::cerr << "[GameServerMaster] ERROR: The game logic update could not be completed within the specified FPS" << "\n";
-        }
-    }
+TickStats GameServerMaster::get_tick_stats() const {
+    return m_scheduler.get_tick_stats();
+}
 
-    packet_stream.stop();
-    client_conn->disconnect();
+TickProfile GameServerMaster::get_tick_profile() const {
+    return m_scheduler.get_tick_profile();
+}
 
-    std::cout << "[GameServerMaster] DEBUG: Game Instance has been terminated successfully" << "\n";
-}
\ No newline at end of file
+std::vector<SessionTickSummary> GameServerMaster::get_session_summaries() const {
+    return m_scheduler.get_session_summaries();
+}
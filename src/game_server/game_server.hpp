@@ -5,6 +5,11 @@
 #include <thread>
 #include <atomic>
 #include "../socket/socket.hpp"
+#include "../socket/net_reactor.hpp"
+#include "../packet_stream/transport.hpp"
+#include "../packet_stream/datagram_transport.hpp"
+#include "../bullet_pattern/pattern_program.hpp"
+#include "tick_scheduler.hpp"
 
 class GameServerMaster {
 public:
@@ -17,14 +22,40 @@ public:
     void stop();
     bool wait_for_accept_ready(size_t timeout_msec, size_t max_attempts);
 
+    /*
+        Creates a session connected through an in-process loopback transport
+        instead of a socket. Requires the server to be running.
+        Returns nullptr if the maximum number of instances has been reached.
+    */
+    std::shared_ptr<ClientTransport> connect_local();
+
+    TickStats get_tick_stats() const;
+
+    // Phase histograms of the session ticks, see TickScheduler
+    TickProfile get_tick_profile() const;
+    std::vector<SessionTickSummary> get_session_summaries() const;
+
 private:
     void accept_loop();
-    void handle_client(std::shared_ptr<ClientConnection> client_conn);
+    void start_workers();
+
+    // Compiles assets/pattern/patterns.lua, the server runs without attack patterns if it fails
+    void load_patterns();
 
     std::shared_ptr<ServerSocket>   m_server_socket;
+    uint16_t                        m_server_port;
     std::atomic<bool>               m_running;
     std::atomic<bool>               m_ready_to_accept;
     std::thread                     m_accept_thread;
-    size_t                          m_max_instances;
-    std::atomic<size_t>             m_active_instances;
+
+    // Shared read-only by every session
+    std::shared_ptr<const PatternLibrary>   m_patterns;
+
+    // Declared before the scheduler so it outlives every session
+    NetReactor                      m_reactor;
+
+    // Frames and inputs of socket clients go over UDP when it is open, see DatagramServerTransport
+    std::shared_ptr<DatagramEndpoint>   m_datagram_endpoint;
+
+    TickScheduler                   m_scheduler;
 }; 
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "game_session.hpp"
+#include "game_logic_constants.hpp"
+#include "../config_constants.hpp"
+
+namespace {
+    // Handshake timeouts (in ticks)
+    constexpr uint64_t CLIENT_HELLO_TIMEOUT_TICKS   = 10 * game_logic_constants::TICK_RATE;
+    constexpr uint64_t GAME_REQUEST_TIMEOUT_TICKS   = 1000 * game_logic_constants::TICK_RATE;
+}
+
+GameSession::GameSession(
+    std::shared_ptr<ServerTransport> transport,
+    NetReactor* reactor,
+    std::shared_ptr<const PatternLibrary> patterns
+)
+    : m_transport(std::move(transport))
+    , m_reactor(reactor)
+    , m_state(SessionState::WaitClientHello)
+    , m_phase_start_tick(0)
+    , m_phase_started(false)
+    , m_simulation(std::random_device{}(), std::move(patterns))
+    , m_input_log()
+    , m_phase_timer()
+{
+    m_transport->set_phase_timer(&m_phase_timer);
+}
+
+GameSession::~GameSession() {
+    close();
+}
+
+void GameSession::start() {
+    // Fall back to a receive thread if the reactor is not available
+    if (m_reactor == nullptr || !m_transport->attach(*m_reactor))
+    {
+        m_transport->start();
+    }
+}
+
+void GameSession::close() {
+    if (m_transport->is_running())
+    {
+        m_transport->stop();
+
+        std::cout << "[GameSession] DEBUG: Game Instance has been terminated successfully" << "\n";
+    }
+
+    m_input_log.close();
+
+    m_state = SessionState::Finished;
+}
+
+bool GameSession::is_finished() const {
+    return m_state == SessionState::Finished;
+}
+
+SessionState GameSession::get_state() const {
+    return m_state;
+}
+
+const TickPhaseTimer& GameSession::get_phase_timer() const {
+    return m_phase_timer;
+}
+
+void GameSession::step(uint64_t tick, TickProfile* shared) {
+    if (m_state == SessionState::Finished)
+    {
+        return;
+    }
+
+    // Check if the recv thread is alive
+    const auto expr_1 = m_transport->get_recv_exception() == nullptr;
+    const auto expr_2 = m_transport->is_running();
+
+    if (!expr_1 || !expr_2)
+    {
+        close();
+
+        return;
+    }
+
+    switch (m_state)
+    {
+        case SessionState::WaitClientHello: { step_handshake(PayloadType::ClientHello, tick);        break; }
+        case SessionState::WaitGameRequest: { step_handshake(PayloadType::ClientGameRequest, tick);  break; }
+        case SessionState::Playing:         { step_game(tick, shared);                               break; }
+        default:                            {                                                        break; }
+    }
+}
+
+void GameSession::step_handshake(PayloadType expected, uint64_t tick) {
+    if (!m_phase_started)
+    {
+        m_phase_started = true;
+        m_phase_start_tick = tick;
+    }
+
+    while (true)
+    {
+        std::optional<Packet> packet_opt = m_transport->poll_packet();
+
+        if (!packet_opt.has_value())
+        {
+            break;
+        }
+
+        if (packet_opt.value().header.payload_type != expected)
+        {
+            continue;
+        }
+
+        m_phase_started = false;
+
+        if (expected == PayloadType::ClientHello)
+        {
+            const auto& hello = std::get<ClientHello>(packet_opt.value().payload);
+
+            // Compact frames whenever the client can decode them
+            auto accept = ServerAccept{};
+            accept.frame_encoding = (hello.frame_encodings & frame_encoding_bit(FrameEncoding::Compact)) != 0
+                ? FrameEncoding::Compact
+                : FrameEncoding::Full;
+
+            m_transport->set_frame_encoding(accept.frame_encoding);
+
+            // Send server accept
+            m_transport->send_packet(make_packet(accept));
+            std::cout << "[GameSession] DEBUG: Server accept has been sent" << "\n";
+
+            m_state = SessionState::WaitGameRequest;
+        }
+        else
+        {
+            // Send server game response
+            m_transport->send_packet(make_packet<ServerGameResponse>({}));
+            std::cout << "[GameSession] DEBUG: Server game response has been sent" << "\n";
+
+            if (replay_constants::ENABLE_INPUT_LOG)
+            {
+                open_input_log();
+            }
+
+            m_state = SessionState::Playing;
+        }
+
+        return;
+    }
+
+    const auto timeout = expected == PayloadType::ClientHello
+        ? CLIENT_HELLO_TIMEOUT_TICKS
+        : GAME_REQUEST_TIMEOUT_TICKS;
+
+    if (tick - m_phase_start_tick >= timeout)
+    {
+        std::cout << "[GameSession] DEBUG: Handshake timeout, payload type: "
+                  << static_cast<uint32_t>(expected) << "\n";
+
+        close();
+    }
+}
+
+void GameSession::step_game(uint64_t tick, TickProfile* shared) {
+    auto quit = false;
+
+    m_phase_timer.begin(shared);
+
+    // Process the packet queue
+    while (true)
+    {
+        std::optional<Packet> packet_opt = m_transport->poll_packet();
+
+        if (!packet_opt.has_value())
+        {
+            break;
+        }
+
+        Packet packet = std::move(*packet_opt);
+
+        switch (packet.header.payload_type)
+        {
+            case PayloadType::ClientInput:
+            {
+                const auto& input_snapshot = std::get<ClientInput>(packet.payload);
+
+                m_input_log.append_input(tick, input_snapshot);
+
+                // Applied by the next steps, one per tick, duplicated or reordered inputs are dropped
+                m_simulation.queue_input(input_snapshot);
+
+                break;
+            }
+
+            case PayloadType::ClientGoodbye:
+            {
+                std::cout << "[GameSession] DEBUG: Received client goodbye" << "\n";
+
+                const auto packet = make_packet<ServerGoodbye>({});
+                m_transport->send_packet(packet);
+
+                quit = true;
+
+                break;
+            }
+
+            default:
+            {
+                std::cerr << "[GameSession] DEBUG: Unexpected message type: "
+                          << static_cast<uint32_t>(packet.header.payload_type) << "\n";
+                break;
+            }
+        }
+    }
+
+    m_phase_timer.mark(TickPhase::InputDrain);
+
+    if (quit)
+    {
+        close();
+
+        return;
+    }
+
+    m_simulation.step(static_cast<uint32_t>(tick), &m_phase_timer);
+
+    // Delta against the client's last acknowledged frame, or a keyframe
+    m_transport->send_frame(m_simulation.get_frame());
+    m_phase_timer.mark(TickPhase::Send);
+
+    m_input_log.append_step(tick);
+    m_phase_timer.end();
+}
+
+void GameSession::open_input_log() {
+    // The seed is random per session, so it names the log as well
+    std::ostringstream path;
+    path << replay_constants::INPUT_LOG_DIR << "/session_" << std::hex << m_simulation.get_seed() << ".inputlog";
+
+    if (m_input_log.open(path.str(), m_simulation.get_seed(), m_simulation.compute_patterns_hash()))
+    {
+        std::cout << "[GameSession] DEBUG: Recording inputs to " << path.str() << "\n";
+    }
+}
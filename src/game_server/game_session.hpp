@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "../socket/net_reactor.hpp"
+#include "../packet_stream/transport.hpp"
+#include "../packet_template/packet_template.hpp"
+#include "../game_simulation/game_simulation.hpp"
+#include "../game_simulation/input_log.hpp"
+#include "tick_profiler.hpp"
+
+enum class SessionState : uint8_t {
+    WaitClientHello,
+    WaitGameRequest,
+    Playing,
+    Finished
+};
+
+/*
+    A single game instance.
+    Unlike the old 'handle_client' loop, a session never sleeps or blocks.
+    The TickScheduler calls 'step()' exactly once per server tick and the
+    session advances its handshake or game logic by one step.
+*/
+class GameSession {
+public:
+    /*
+        If a running reactor is given and the transport supports it, the connection is multiplexed on its I/O threads.
+        Enemies and bosses fire the attack patterns of 'patterns', they don't fire without a library.
+    */
+    explicit GameSession(
+        std::shared_ptr<ServerTransport> transport,
+        NetReactor* reactor = nullptr,
+        std::shared_ptr<const PatternLibrary> patterns = nullptr
+    );
+    ~GameSession();
+
+    // Delete copy constructor and copy assignment operator
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    void start();
+
+    // The phases of the tick are recorded in the session's profile and in 'shared' if given
+    void step(uint64_t tick, TickProfile* shared = nullptr);
+    void close();
+
+    bool is_finished() const;
+    SessionState get_state() const;
+
+    // Only to be read between ticks, by the thread that steps the session or after it
+    const TickPhaseTimer& get_phase_timer() const;
+
+private:
+    void step_handshake(PayloadType expected, uint64_t tick);
+    void step_game(uint64_t tick, TickProfile* shared);
+    void open_input_log();
+
+    std::shared_ptr<ServerTransport>    m_transport;
+    NetReactor*                         m_reactor;
+    SessionState                        m_state;
+
+    // The tick at which the current handshake phase has started
+    uint64_t                            m_phase_start_tick;
+    bool                                m_phase_started;
+
+    // The game itself, the session only feeds it inputs and sends its frames
+    GameSimulation                      m_simulation;
+
+    // Every received input and stepped tick, for 'replay_runner' (closed unless ENABLE_INPUT_LOG)
+    InputLogWriter                      m_input_log;
+
+    // Game ticks only, the transport marks the serialization on it as well
+    TickPhaseTimer                      m_phase_timer;
+};
@@ -0,0 +1,40 @@
+#include <algorithm>    // std::clamp
+#include "player_movement.hpp"
+#include "../game_simulation/fixed_point.hpp"
+
+namespace {
+    // 1 / sqrt(2) in Q16.16
+    constexpr fixed32 INV_SQRT2 = 46341;
+
+    constexpr fixed32 FIELD_HALF_WIDTH  = fixed_from_int(static_cast<int32_t>(game_logic_constants::GAME_WIDTH_HALF));
+    constexpr fixed32 FIELD_HALF_HEIGHT = fixed_from_int(static_cast<int32_t>(game_logic_constants::GAME_HEIGHT_HALF));
+}
+
+void apply_player_input(PlayerSnapshot& player, const InputDirection& input, float speed) {
+    const auto step = fixed_from_float(speed);
+    const auto diagonal_step = fixed_mul(step, INV_SQRT2);
+
+    fixed32 dx = 0;
+    fixed32 dy = 0;
+
+    switch (input)
+    {
+        case InputDirection::Up:        { dy = +step;                               break; }
+        case InputDirection::Down:      { dy = -step;                               break; }
+        case InputDirection::Right:     { dx = +step;                               break; }
+        case InputDirection::Left:      { dx = -step;                               break; }
+        case InputDirection::UpRight:   { dx = +diagonal_step; dy = +diagonal_step; break; }
+        case InputDirection::DownRight: { dx = +diagonal_step; dy = -diagonal_step; break; }
+        case InputDirection::UpLeft:    { dx = -diagonal_step; dy = +diagonal_step; break; }
+        case InputDirection::DownLeft:  { dx = -diagonal_step; dy = -diagonal_step; break; }
+
+        case InputDirection::Stop:
+        default: return;
+    }
+
+    // Positions are multiples of 2^-16 within the field, so they survive the round trip through float exactly
+    const auto x = std::clamp(fixed_from_float(player.pos.x) + dx, -FIELD_HALF_WIDTH, FIELD_HALF_WIDTH);
+    const auto y = std::clamp(fixed_from_float(player.pos.y) + dy, -FIELD_HALF_HEIGHT, FIELD_HALF_HEIGHT);
+
+    player.pos = { fixed_to_float(x), fixed_to_float(y) };
+}
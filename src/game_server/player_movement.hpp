@@ -0,0 +1,16 @@
+#pragma once
+
+#include "game_logic_constants.hpp"
+#include "../input_manager/input_snapshot.hpp"
+#include "../packet_template/frame.hpp"
+
+/*
+    Moves the player by one tick of 'input'.
+    Shared by the server and the client prediction, so both must stay bit-identical:
+    the step is computed in Q16.16 fixed point, 'speed' is rounded to it.
+*/
+void apply_player_input(
+    PlayerSnapshot& player,
+    const InputDirection& input,
+    float speed = game_logic_constants::PLAYER_SPEED
+);
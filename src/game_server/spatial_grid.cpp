@@ -0,0 +1,159 @@
+#include <cmath>
+#include <algorithm>
+#include "spatial_grid.hpp"
+
+namespace {
+    constexpr float INV_CELL_SIZE = 1.0f / SPATIAL_GRID_CELL_SIZE;
+
+    /*
+        Clamped while still a float, converting a float beyond the range of the integer
+        (a bullet flung far off the field, or NaN) is undefined behaviour
+    */
+    size_t cell_of(float offset, size_t cell_count) {
+        const auto cell = std::floor(offset * INV_CELL_SIZE);
+
+        // Also catches NaN
+        if (!(cell > 0.0f))
+        {
+            return 0;
+        }
+
+        return static_cast<size_t>(std::min(cell, static_cast<float>(cell_count - 1)));
+    }
+
+    // Field coordinates are centered, (0, 0) is the middle of the field
+    size_t column_of(float x) {
+        return cell_of(x + game_logic_constants::GAME_WIDTH_HALF, SPATIAL_GRID_COLUMNS);
+    }
+
+    size_t row_of(float y) {
+        return cell_of(y + game_logic_constants::GAME_HEIGHT_HALF, SPATIAL_GRID_ROWS);
+    }
+
+    bool overlaps(float dx, float dy, float radius) {
+        return dx * dx + dy * dy < radius * radius;
+    }
+}
+
+SpatialGrid::SpatialGrid()
+    : m_pos_x(nullptr)
+    , m_pos_y(nullptr)
+    , m_radius(nullptr)
+    , m_max_radius(0.0f)
+    , m_cell_start(SPATIAL_GRID_CELLS + 1, 0)
+    , m_cell_cursor(SPATIAL_GRID_CELLS, 0)
+{}
+
+void SpatialGrid::rebuild(const BulletPool& pool, uint8_t owner) {
+    m_pos_x     = pool.get_pos_x();
+    m_pos_y     = pool.get_pos_y();
+    m_radius    = pool.get_radius();
+    m_max_radius = 0.0f;
+
+    const auto* owners = pool.get_owners();
+    const auto count = pool.size();
+
+    m_bullet_cells.clear();
+    m_bullet_refs.clear();
+
+    std::fill(m_cell_start.begin(), m_cell_start.end(), 0);
+
+    // Pass 1: bin the bullets and count them per cell
+    for (size_t i = 0; i < count; i++)
+    {
+        if (owners[i] != owner)
+        {
+            continue;
+        }
+
+        const auto cell = static_cast<uint32_t>(row_of(m_pos_y[i]) * SPATIAL_GRID_COLUMNS + column_of(m_pos_x[i]));
+
+        m_bullet_cells.push_back(cell);
+        m_bullet_refs.push_back(static_cast<uint32_t>(i));
+        m_cell_start[cell + 1]++;
+
+        m_max_radius = std::max(m_max_radius, m_radius[i]);
+    }
+
+    // Pass 2: prefix sum, m_cell_start[c] becomes the first slot of cell 'c'
+    for (size_t c = 0; c < SPATIAL_GRID_CELLS; c++)
+    {
+        m_cell_start[c + 1] += m_cell_start[c];
+    }
+
+    // Pass 3: scatter the indices into their cells
+    std::copy(m_cell_start.begin(), m_cell_start.end() - 1, m_cell_cursor.begin());
+    m_indices.resize(m_bullet_refs.size());
+
+    for (size_t i = 0; i < m_bullet_refs.size(); i++)
+    {
+        m_indices[m_cell_cursor[m_bullet_cells[i]]++] = m_bullet_refs[i];
+    }
+}
+
+size_t SpatialGrid::query(float x, float y, float radius, std::vector<uint32_t>& hits) const {
+    const auto reach = radius + m_max_radius;
+    const auto previous_size = hits.size();
+
+    const auto column_begin = column_of(x - reach);
+    const auto column_end   = column_of(x + reach);
+    const auto row_begin    = row_of(y - reach);
+    const auto row_end      = row_of(y + reach);
+
+    for (size_t row = row_begin; row <= row_end; row++)
+    {
+        // Cells of a row are adjacent, so the whole column range is one slice
+        const auto first = m_cell_start[row * SPATIAL_GRID_COLUMNS + column_begin];
+        const auto last  = m_cell_start[row * SPATIAL_GRID_COLUMNS + column_end + 1];
+
+        for (auto slot = first; slot < last; slot++)
+        {
+            const auto i = m_indices[slot];
+
+            if (overlaps(m_pos_x[i] - x, m_pos_y[i] - y, radius + m_radius[i]))
+            {
+                hits.push_back(i);
+            }
+        }
+    }
+
+    return hits.size() - previous_size;
+}
+
+size_t SpatialGrid::query(float x, float y, float radius, float graze_radius, std::vector<uint32_t>& hits, std::vector<uint32_t>& grazes) const {
+    const auto reach = std::max(radius, graze_radius) + m_max_radius;
+    const auto previous_size = hits.size();
+
+    const auto column_begin = column_of(x - reach);
+    const auto column_end   = column_of(x + reach);
+    const auto row_begin    = row_of(y - reach);
+    const auto row_end      = row_of(y + reach);
+
+    for (size_t row = row_begin; row <= row_end; row++)
+    {
+        const auto first = m_cell_start[row * SPATIAL_GRID_COLUMNS + column_begin];
+        const auto last  = m_cell_start[row * SPATIAL_GRID_COLUMNS + column_end + 1];
+
+        for (auto slot = first; slot < last; slot++)
+        {
+            const auto i = m_indices[slot];
+            const auto dx = m_pos_x[i] - x;
+            const auto dy = m_pos_y[i] - y;
+
+            if (overlaps(dx, dy, radius + m_radius[i]))
+            {
+                hits.push_back(i);
+            }
+            else if (overlaps(dx, dy, graze_radius + m_radius[i]))
+            {
+                grazes.push_back(i);
+            }
+        }
+    }
+
+    return hits.size() - previous_size;
+}
+
+size_t SpatialGrid::size() const {
+    return m_indices.size();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "bullet_pool.hpp"
+#include "game_logic_constants.hpp"
+
+constexpr float     SPATIAL_GRID_CELL_SIZE  = 16.0f;
+constexpr size_t    SPATIAL_GRID_COLUMNS    = static_cast<size_t>(game_logic_constants::GAME_WIDTH / SPATIAL_GRID_CELL_SIZE);    // 24
+constexpr size_t    SPATIAL_GRID_ROWS       = static_cast<size_t>(game_logic_constants::GAME_HEIGHT / SPATIAL_GRID_CELL_SIZE);   // 28
+constexpr size_t    SPATIAL_GRID_CELLS      = SPATIAL_GRID_COLUMNS * SPATIAL_GRID_ROWS;
+
+/*
+    Broad-phase for bullet collisions.
+
+    A uniform grid over the play field, rebuilt from a BulletPool every tick
+    with a counting sort: bullet indices end up grouped by cell in one flat array,
+    so there is no per-cell allocation and a query only walks the cells
+    overlapped by the queried circle.
+    Bullets outside of the field are clamped into the border cells.
+
+    Indices refer to the pool as it was at 'rebuild()', so the pool must not
+    be modified between rebuilding and querying.
+*/
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    // Indexes the bullets of 'pool' fired by 'owner'
+    void rebuild(const BulletPool& pool, uint8_t owner);
+
+    /*
+        Appends the pool indices of the bullets overlapping the circle to 'hits'.
+        Returns the number of appended indices.
+    */
+    size_t query(float x, float y, float radius, std::vector<uint32_t>& hits) const;
+
+    /*
+        Same as 'query', but additionally reports the bullets that are inside of
+        'graze_radius' without touching 'radius' in 'grazes'.
+    */
+    size_t query(float x, float y, float radius, float graze_radius, std::vector<uint32_t>& hits, std::vector<uint32_t>& grazes) const;
+
+    size_t size() const;
+
+private:
+    const float*            m_pos_x;
+    const float*            m_pos_y;
+    const float*            m_radius;
+
+    // Largest bullet radius in the grid, widens the cell range of a query
+    float                   m_max_radius;
+
+    // Bullets of cell 'c' are m_indices[m_cell_start[c] .. m_cell_start[c + 1]]
+    std::vector<uint32_t>   m_cell_start;
+    std::vector<uint32_t>   m_indices;
+    std::vector<uint32_t>   m_cell_cursor;
+
+    // Cell and pool index of each indexed bullet, kept between rebuilds to avoid reallocation
+    std::vector<uint32_t>   m_bullet_cells;
+    std::vector<uint32_t>   m_bullet_refs;
+};
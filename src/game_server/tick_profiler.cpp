@@ -0,0 +1,265 @@
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include "tick_profiler.hpp"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace {
+    constexpr const char* TICK_PHASE_NAMES[TICK_PHASE_COUNT] = {
+        "input_drain",
+        "simulation",
+        "collision",
+        "frame_build",
+        "serialize",
+        "send"
+    };
+
+    constexpr uint64_t MAX_RECORDED_VALUE = (uint64_t(1) << LatencyHistogram::MAX_VALUE_BITS) - 1;
+
+    // Index of the highest set bit, 'value' is not zero
+    size_t highest_bit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+
+        return index;
+#else
+        return 63 - static_cast<size_t>(__builtin_clzll(value));
+#endif
+    }
+
+    size_t get_bucket_index(uint64_t value) {
+        constexpr auto sub_bits = LatencyHistogram::SUB_BUCKET_BITS;
+        constexpr auto sub_count = LatencyHistogram::SUB_BUCKET_COUNT;
+
+        if (value < 2 * sub_count)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        // The top SUB_BUCKET_BITS bits below the highest one pick the sub bucket
+        const auto exponent = highest_bit(value);
+        const auto sub_bucket = static_cast<size_t>(value >> (exponent - sub_bits)) & (sub_count - 1);
+
+        return 2 * sub_count + (exponent - sub_bits - 1) * sub_count + sub_bucket;
+    }
+
+    uint64_t get_bucket_upper_bound(size_t index) {
+        constexpr auto sub_bits = LatencyHistogram::SUB_BUCKET_BITS;
+        constexpr auto sub_count = LatencyHistogram::SUB_BUCKET_COUNT;
+
+        if (index < 2 * sub_count)
+        {
+            return index;
+        }
+
+        const auto exponent = (index - 2 * sub_count) / sub_count + sub_bits + 1;
+        const auto sub_bucket = (index - 2 * sub_count) % sub_count;
+        const auto width = uint64_t(1) << (exponent - sub_bits);
+
+        return ((sub_count + sub_bucket) << (exponent - sub_bits)) + width - 1;
+    }
+
+    double to_usec(uint64_t nsec) {
+        return static_cast<double>(nsec) / 1000.0;
+    }
+
+    void format_histogram(std::ostringstream& out, const char* name, const LatencyHistogram& histogram) {
+        out << std::setw(12) << name << ": " << histogram.get_count() << " samples"
+            << ", p50 "     << to_usec(histogram.get_percentile(0.50))
+            << " us, p99 "  << to_usec(histogram.get_percentile(0.99))
+            << " us, p99.9 " << to_usec(histogram.get_percentile(0.999))
+            << " us, max "  << to_usec(histogram.get_max())
+            << " us, mean " << histogram.get_mean() / 1000.0 << " us" << "\n";
+    }
+}
+
+const char* get_tick_phase_name(TickPhase phase) {
+    const auto index = static_cast<size_t>(phase);
+
+    return index < TICK_PHASE_COUNT ? TICK_PHASE_NAMES[index] : "unknown";
+}
+
+/*
+    LatencyHistogram
+*/
+LatencyHistogram::LatencyHistogram()
+    : m_buckets{}
+    , m_count(0)
+    , m_sum(0)
+    , m_max(0)
+{}
+
+void LatencyHistogram::record(uint64_t nsec) {
+    nsec = std::min(nsec, MAX_RECORDED_VALUE);
+
+    m_buckets[get_bucket_index(nsec)]++;
+    m_count++;
+    m_sum += nsec;
+    m_max = std::max(m_max, nsec);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.m_count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+
+    m_count += other.m_count;
+    m_sum   += other.m_sum;
+    m_max   = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset() {
+    if (m_count == 0)
+    {
+        return;
+    }
+
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum   = 0;
+    m_max   = 0;
+}
+
+uint64_t LatencyHistogram::get_count() const {
+    return m_count;
+}
+
+uint64_t LatencyHistogram::get_max() const {
+    return m_max;
+}
+
+double LatencyHistogram::get_mean() const {
+    return m_count > 0 ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0;
+}
+
+uint64_t LatencyHistogram::get_percentile(double quantile) const {
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the sample, 1-based
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(m_count) + 0.5));
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += m_buckets[i];
+
+        if (seen >= rank)
+        {
+            // The bucket may reach past the largest sample
+            return std::min(get_bucket_upper_bound(i), m_max);
+        }
+    }
+
+    return m_max;
+}
+
+/*
+    TickProfile
+*/
+void TickProfile::merge(const TickProfile& other) {
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++)
+    {
+        phases[i].merge(other.phases[i]);
+    }
+
+    tick.merge(other.tick);
+}
+
+void TickProfile::reset() {
+    for (auto& phase : phases)
+    {
+        phase.reset();
+    }
+
+    tick.reset();
+}
+
+std::string format_tick_profile(const TickProfile& profile) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+
+    format_histogram(out, "tick", profile.tick);
+
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++)
+    {
+        if (profile.phases[i].get_count() > 0)
+        {
+            format_histogram(out, TICK_PHASE_NAMES[i], profile.phases[i]);
+        }
+    }
+
+    return out.str();
+}
+
+/*
+    TickPhaseTimer
+*/
+TickPhaseTimer::TickPhaseTimer()
+    : m_shared(nullptr)
+    , m_tick_start()
+    , m_last_mark()
+    , m_profile()
+    , m_current_tick{}
+    , m_last_tick{}
+{}
+
+void TickPhaseTimer::begin(TickProfile* shared) {
+    m_shared = shared;
+    m_tick_start = Clock::now();
+    m_last_mark = m_tick_start;
+
+    m_current_tick.fill(0);
+}
+
+void TickPhaseTimer::mark(TickPhase phase) {
+    const auto now = Clock::now();
+    const auto nsec = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last_mark).count());
+    const auto index = static_cast<size_t>(phase);
+
+    m_last_mark = now;
+    m_current_tick[index] += nsec;
+
+    m_profile.phases[index].record(nsec);
+
+    if (m_shared != nullptr)
+    {
+        m_shared->phases[index].record(nsec);
+    }
+}
+
+void TickPhaseTimer::end() {
+    const auto nsec = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_tick_start).count());
+
+    m_current_tick[TICK_PHASE_COUNT] = nsec;
+    m_last_tick = m_current_tick;
+
+    m_profile.tick.record(nsec);
+
+    if (m_shared != nullptr)
+    {
+        m_shared->tick.record(nsec);
+    }
+
+    m_shared = nullptr;
+}
+
+const TickProfile& TickPhaseTimer::get_profile() const {
+    return m_profile;
+}
+
+const std::array<uint64_t, TICK_PHASE_COUNT + 1>& TickPhaseTimer::get_last_tick() const {
+    return m_last_tick;
+}
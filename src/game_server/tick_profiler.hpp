@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// The stages of a session tick, in the order they run
+enum class TickPhase : uint8_t {
+    InputDrain,     // Polling the packets and applying the inputs
+    Simulation,     // Bullets and attack patterns
+    Collision,
+    FrameBuild,     // Packing the bullets into the frame
+    Serialize,      // Keyframe or delta, inside the transport (not for the loopback)
+    Send,
+    Count
+};
+
+constexpr size_t TICK_PHASE_COUNT = static_cast<size_t>(TickPhase::Count);
+
+const char* get_tick_phase_name(TickPhase phase);
+
+/*
+    Log-linear histogram of durations in nanoseconds (HDR-style)
+
+    16 buckets per power of two, so a percentile is within 6.25% of the recorded value.
+    Recording is a bit scan and an increment, merging adds the buckets.
+    Values above 2^40 ns (about 18 minutes) go to the last bucket.
+*/
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS     = 4;
+    static constexpr size_t SUB_BUCKET_COUNT    = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t MAX_VALUE_BITS      = 40;
+
+    // Values below 2 * SUB_BUCKET_COUNT have a bucket each
+    static constexpr size_t BUCKET_COUNT        = 2 * SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram();
+
+    void record(uint64_t nsec);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t get_count() const;
+    uint64_t get_max() const;
+    double get_mean() const;
+
+    // Upper bound of the bucket of the sample at 'quantile' (0 to 1), 0 without samples
+    uint64_t get_percentile(double quantile) const;
+
+private:
+    std::array<uint32_t, BUCKET_COUNT>  m_buckets;
+    uint64_t                            m_count;
+    uint64_t                            m_sum;
+    uint64_t                            m_max;
+};
+
+// Histograms of every phase and of the whole session tick
+struct TickProfile {
+    std::array<LatencyHistogram, TICK_PHASE_COUNT>  phases;
+    LatencyHistogram                                tick;
+
+    void merge(const TickProfile& other);
+    void reset();
+};
+
+// One line per phase with samples: count, p50, p99, p99.9, max and mean in microseconds
+std::string format_tick_profile(const TickProfile& profile);
+
+/*
+    Times the phases of a session tick, one clock read per phase.
+
+    'begin()' starts the tick, every 'mark(phase)' attributes the time since the previous mark
+    to 'phase', and 'end()' closes the tick. Samples go to the timer's own profile and to the
+    'shared' one given to 'begin()' (the worker's), both owned by the thread stepping the session.
+*/
+class TickPhaseTimer {
+public:
+    TickPhaseTimer();
+
+    void begin(TickProfile* shared = nullptr);
+    void mark(TickPhase phase);
+    void end();
+
+    // Since the session started
+    const TickProfile& get_profile() const;
+
+    // Nanoseconds per phase of the last completed tick, the whole tick last
+    const std::array<uint64_t, TICK_PHASE_COUNT + 1>& get_last_tick() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    TickProfile*                                m_shared;
+    Clock::time_point                           m_tick_start;
+    Clock::time_point                           m_last_mark;
+
+    TickProfile                                 m_profile;
+    std::array<uint64_t, TICK_PHASE_COUNT + 1>  m_current_tick;
+    std::array<uint64_t, TICK_PHASE_COUNT + 1>  m_last_tick;
+};
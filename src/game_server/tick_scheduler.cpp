@@ -0,0 +1,447 @@
+#include <iostream>
+#include <algorithm>
+#include "tick_scheduler.hpp"
+#include "game_logic_constants.hpp"
+#include "../config_constants.hpp"
+
+namespace {
+    // Worker profiles are merged once per second
+    constexpr uint64_t PROFILE_MERGE_INTERVAL_TICKS = game_logic_constants::TICK_RATE;
+
+    // The sessions with the highest p99 tick are listed in a dump
+    constexpr size_t DUMP_SESSION_COUNT = 5;
+}
+
+TickScheduler::TickScheduler(size_t max_sessions, size_t worker_count)
+    : m_max_sessions(max_sessions)
+    , m_tick_duration(std::chrono::nanoseconds(1'000'000'000 / game_logic_constants::TICK_RATE))
+    , m_running(false)
+    , m_active_sessions(0)
+    , m_tick_generation(0)
+    , m_current_tick(0)
+    , m_pending_workers(0)
+    , m_stats{}
+{
+    if (worker_count == 0)
+    {
+        worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // More workers than sessions would never have anything to do
+    worker_count = std::clamp<size_t>(worker_count, 1, std::max<size_t>(1, max_sessions));
+
+    m_workers.resize(worker_count);
+}
+
+TickScheduler::~TickScheduler() {
+    stop();
+}
+
+void TickScheduler::start() {
+    if (m_running.exchange(true))
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].thread = std::thread(&TickScheduler::worker_loop, this, i);
+    }
+
+    m_timer_thread = std::thread(&TickScheduler::timer_loop, this);
+
+    std::cout << "[TickScheduler] DEBUG: Started with " << m_workers.size() << " worker threads" << "\n";
+}
+
+void TickScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_tick_mutex);
+
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+    }
+
+    m_tick_cv.notify_all();
+    m_done_cv.notify_all();
+
+    if (m_timer_thread.joinable())
+    {
+        m_timer_thread.join();
+    }
+
+    for (auto& worker : m_workers)
+    {
+        if (worker.thread.joinable())
+        {
+            worker.thread.join();
+        }
+    }
+
+    // Close every remaining session
+    for (auto& worker : m_workers)
+    {
+        for (auto& session : worker.sessions)
+        {
+            session->close();
+        }
+
+        worker.sessions.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+
+        for (auto& session : m_pending_sessions)
+        {
+            session->close();
+        }
+
+        m_pending_sessions.clear();
+    }
+
+    m_active_sessions = 0;
+
+    std::cout << "[TickScheduler] DEBUG: Worker threads have been joined" << "\n";
+}
+
+bool TickScheduler::is_running() const {
+    return m_running;
+}
+
+bool TickScheduler::admit(std::shared_ptr<GameSession> session) {
+    if (!m_running || session == nullptr)
+    {
+        return false;
+    }
+
+    auto current = m_active_sessions.load();
+
+    // CAS (Compare-And-Swap)
+    do
+    {
+        if (current >= m_max_sessions)
+        {
+            return false;
+        }
+    }
+    while (!m_active_sessions.compare_exchange_weak(current, current + 1));
+
+    session->start();
+
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    m_pending_sessions.push_back(std::move(session));
+
+    return true;
+}
+
+size_t TickScheduler::get_active_sessions() const {
+    return m_active_sessions;
+}
+
+size_t TickScheduler::get_worker_count() const {
+    return m_workers.size();
+}
+
+TickStats TickScheduler::get_tick_stats() const {
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+    return m_stats;
+}
+
+TickProfile TickScheduler::get_tick_profile() const {
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+    return m_profile;
+}
+
+std::vector<SessionTickSummary> TickScheduler::get_session_summaries() const {
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+    return m_session_summaries;
+}
+
+void TickScheduler::timer_loop() {
+    using namespace std::chrono;
+
+    auto next_deadline = steady_clock::now();
+    uint64_t tick = 0;
+    uint64_t overruns = 0;
+    uint64_t skipped_ticks = 0;
+
+    uint64_t ticks_since_merge = 0;
+    uint64_t merges_since_dump = 0;
+
+    while (m_running)
+    {
+        std::this_thread::sleep_until(next_deadline);
+
+        const auto tick_start = steady_clock::now();
+        auto lag = duration_cast<nanoseconds>(tick_start - next_deadline);
+
+        // Drop the ticks we have completely missed instead of bursting through them
+        if (lag >= m_tick_duration)
+        {
+            const auto missed = static_cast<uint64_t>(lag / m_tick_duration);
+
+            tick            += missed;
+            skipped_ticks   += missed;
+            next_deadline   += m_tick_duration * missed;
+            lag             -= m_tick_duration * missed;
+        }
+
+        distribute_pending_sessions();
+        run_tick(tick);
+
+        // Stopped in the middle of the tick
+        if (!m_running)
+        {
+            break;
+        }
+
+        const auto tick_end = steady_clock::now();
+        const auto duration = duration_cast<nanoseconds>(tick_end - tick_start);
+
+        size_t sessions = 0;
+
+        for (const auto& worker : m_workers)
+        {
+            sessions += worker.sessions.size();
+        }
+
+        if (duration > m_tick_duration)
+        {
+            overruns++;
+
+            std::cerr << "[TickScheduler] ERROR: Tick " << tick
+                      << " could not be completed within the specified FPS ("
+                      << duration_cast<microseconds>(duration).count() << "us, "
+                      << sessions << " sessions)" << "\n"
+                      << "[TickScheduler] ERROR: " << describe_slowest_session() << "\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+            m_stats.tick            = tick;
+            m_stats.lag             = duration_cast<microseconds>(lag);
+            m_stats.duration        = duration_cast<microseconds>(duration);
+            m_stats.sessions        = sessions;
+            m_stats.overruns        = overruns;
+            m_stats.skipped_ticks   = skipped_ticks;
+        }
+
+        if (++ticks_since_merge >= PROFILE_MERGE_INTERVAL_TICKS)
+        {
+            ticks_since_merge = 0;
+            merge_profiles();
+
+            if (++merges_since_dump >= profiling_constants::TICK_PROFILE_DUMP_INTERVAL_SEC)
+            {
+                merges_since_dump = 0;
+                dump_profiles();
+            }
+        }
+
+        tick++;
+        next_deadline += m_tick_duration;
+    }
+}
+
+void TickScheduler::worker_loop(size_t worker_index) {
+    auto& worker = m_workers[worker_index];
+    uint64_t seen_generation = 0;
+
+    while (true)
+    {
+        uint64_t tick = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(m_tick_mutex);
+
+            m_tick_cv.wait(lock, [&] {
+                return !m_running || m_tick_generation != seen_generation;
+            });
+
+            if (!m_running)
+            {
+                break;
+            }
+
+            seen_generation = m_tick_generation;
+            tick = m_current_tick;
+        }
+
+        // Step the shard and swap-remove the sessions that have finished
+        for (size_t i = 0; i < worker.sessions.size();)
+        {
+            auto& session = worker.sessions[i];
+            session->step(tick, &worker.profile);
+
+            if (session->is_finished())
+            {
+                std::swap(session, worker.sessions.back());
+                worker.sessions.pop_back();
+
+                m_active_sessions.fetch_sub(1);
+
+                continue;
+            }
+
+            i++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_tick_mutex);
+
+            if (--m_pending_workers == 0)
+            {
+                m_done_cv.notify_one();
+            }
+        }
+    }
+}
+
+void TickScheduler::run_tick(uint64_t tick) {
+    bool has_sessions = false;
+
+    for (const auto& worker : m_workers)
+    {
+        has_sessions |= !worker.sessions.empty();
+    }
+
+    // Nothing to step, so don't wake the workers up
+    if (!has_sessions)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_tick_mutex);
+
+    m_current_tick = tick;
+    m_pending_workers = m_workers.size();
+    m_tick_generation++;
+
+    m_tick_cv.notify_all();
+
+    m_done_cv.wait(lock, [this] {
+        return !m_running || m_pending_workers == 0;
+    });
+}
+
+void TickScheduler::distribute_pending_sessions() {
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+
+    for (auto& session : m_pending_sessions)
+    {
+        // Assign to the least loaded worker
+        auto worker = std::min_element(m_workers.begin(), m_workers.end(), [](const Worker& lhs, const Worker& rhs) {
+            return lhs.sessions.size() < rhs.sessions.size();
+        });
+
+        worker->sessions.push_back(std::move(session));
+    }
+
+    m_pending_sessions.clear();
+}
+
+void TickScheduler::merge_profiles() {
+    // Only a few numbers per session, the profiles themselves stay with the sessions
+    m_merged_summaries.clear();
+
+    for (auto& worker : m_workers)
+    {
+        m_dump_profile.merge(worker.profile);
+
+        for (const auto& session : worker.sessions)
+        {
+            const auto& tick = session->get_phase_timer().get_profile().tick;
+
+            m_merged_summaries.push_back(SessionTickSummary {
+                tick.get_count(),
+                tick.get_percentile(0.50),
+                tick.get_percentile(0.99),
+                tick.get_max()
+            });
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+    for (auto& worker : m_workers)
+    {
+        m_profile.merge(worker.profile);
+        worker.profile.reset();
+    }
+
+    // Swapped, so both vectors keep their capacity
+    std::swap(m_session_summaries, m_merged_summaries);
+}
+
+void TickScheduler::dump_profiles() {
+    if (m_dump_profile.tick.get_count() == 0)
+    {
+        return;
+    }
+
+    std::cout << "[TickScheduler] DEBUG: Session ticks of the last "
+              << profiling_constants::TICK_PROFILE_DUMP_INTERVAL_SEC << "s" << "\n"
+              << format_tick_profile(m_dump_profile);
+
+    m_dump_profile.reset();
+
+    // The slowest sessions since they started, 'm_merged_summaries' is free until the next merge
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+
+        m_merged_summaries.assign(m_session_summaries.begin(), m_session_summaries.end());
+    }
+
+    auto& slowest = m_merged_summaries;
+    const auto count = std::min(slowest.size(), DUMP_SESSION_COUNT);
+
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), [](const SessionTickSummary& lhs, const SessionTickSummary& rhs) {
+        return lhs.p99 > rhs.p99;
+    });
+
+    for (size_t i = 0; i < count; i++)
+    {
+        std::cout << "[TickScheduler] DEBUG: Session tick p50 " << slowest[i].p50 / 1000
+                  << "us, p99 " << slowest[i].p99 / 1000
+                  << "us, max " << slowest[i].max / 1000 << "us (" << slowest[i].ticks << " ticks)" << "\n";
+    }
+}
+
+std::string TickScheduler::describe_slowest_session() const {
+    const TickPhaseTimer* slowest = nullptr;
+
+    for (const auto& worker : m_workers)
+    {
+        for (const auto& session : worker.sessions)
+        {
+            const auto& timer = session->get_phase_timer();
+
+            if (slowest == nullptr || timer.get_last_tick()[TICK_PHASE_COUNT] > slowest->get_last_tick()[TICK_PHASE_COUNT])
+            {
+                slowest = &timer;
+            }
+        }
+    }
+
+    if (slowest == nullptr)
+    {
+        return "No session has been stepped";
+    }
+
+    const auto& last_tick = slowest->get_last_tick();
+    std::string description = "Slowest session " + std::to_string(last_tick[TICK_PHASE_COUNT] / 1000) + "us:";
+
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++)
+    {
+        description += std::string(" ") + get_tick_phase_name(static_cast<TickPhase>(i))
+                     + " " + std::to_string(last_tick[i] / 1000) + "us";
+    }
+
+    return description;
+}
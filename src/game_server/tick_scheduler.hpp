@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "game_session.hpp"
+#include "tick_profiler.hpp"
+
+/*
+    Timing information about the last completed tick
+*/
+struct TickStats {
+    uint64_t                    tick;
+    std::chrono::microseconds   lag;            // How late the tick started compared to its deadline
+    std::chrono::microseconds   duration;       // Time spent stepping every session
+    size_t                      sessions;
+    uint64_t                    overruns;       // Total number of ticks that exceeded the tick budget
+    uint64_t                    skipped_ticks;  // Total number of ticks dropped to catch up with the clock
+};
+
+/*
+    Tick times of one running session since it started playing, in nanoseconds
+*/
+struct SessionTickSummary {
+    uint64_t    ticks;
+    uint64_t    p50;
+    uint64_t    p99;
+    uint64_t    max;
+};
+
+/*
+    A fixed-tick scheduler that owns a small pool of worker threads.
+
+    A single timer thread keeps the shared tick clock (absolute deadlines,
+    so sleep jitter does not accumulate) and on every tick wakes the workers.
+    Each worker steps its own shard of sessions once, and the timer waits
+    for all of them before the next tick begins.
+
+    If the server falls behind by one or more whole ticks, the missed ticks
+    are skipped instead of being replayed in a burst. The tick number still
+    advances, so clients can observe the gap through the frame timestamp.
+
+    Sessions time the phases of their ticks (see TickPhaseTimer) into their own
+    profile and their worker's. Between ticks, once per second, the timer thread
+    merges the worker profiles into the global one and summarizes each session's
+    profile, and every TICK_PROFILE_DUMP_INTERVAL_SEC it prints what it merged
+    since the last dump.
+*/
+class TickScheduler {
+public:
+    // worker_count = 0 means one worker per hardware thread
+    explicit TickScheduler(size_t max_sessions, size_t worker_count = 0);
+    ~TickScheduler();
+
+    // Delete copy constructor and copy assignment operator
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    void start();
+    void stop();
+    bool is_running() const;
+
+    // Returns false if the scheduler is full (hard admission limit) or stopped
+    bool admit(std::shared_ptr<GameSession> session);
+
+    size_t get_active_sessions() const;
+    size_t get_worker_count() const;
+    TickStats get_tick_stats() const;
+
+    // Every session tick since the start, up to a second old
+    TickProfile get_tick_profile() const;
+
+    // One summary per running session, up to a second old
+    std::vector<SessionTickSummary> get_session_summaries() const;
+
+private:
+    struct Worker {
+        std::thread                                 thread;
+        std::vector<std::shared_ptr<GameSession>>   sessions;
+
+        // Written by the worker during a tick, read and reset by the timer thread between ticks
+        TickProfile                                 profile;
+    };
+
+    void timer_loop();
+    void worker_loop(size_t worker_index);
+    void run_tick(uint64_t tick);
+    void distribute_pending_sessions();
+
+    // Timer thread, between ticks
+    void merge_profiles();
+    void dump_profiles();
+    std::string describe_slowest_session() const;
+
+    const size_t                                m_max_sessions;
+    const std::chrono::nanoseconds              m_tick_duration;
+
+    std::atomic<bool>                           m_running;
+    std::atomic<size_t>                         m_active_sessions;
+
+    std::thread                                 m_timer_thread;
+    std::vector<Worker>                         m_workers;
+
+    // Sessions admitted but not yet assigned to a worker
+    std::mutex                                  m_pending_mutex;
+    std::vector<std::shared_ptr<GameSession>>   m_pending_sessions;
+
+    // Tick barrier
+    std::mutex                                  m_tick_mutex;
+    std::condition_variable                     m_tick_cv;
+    std::condition_variable                     m_done_cv;
+    uint64_t                                    m_tick_generation;
+    uint64_t                                    m_current_tick;
+    size_t                                      m_pending_workers;
+
+    mutable std::mutex                          m_stats_mutex;
+    TickStats                                   m_stats;
+    TickProfile                                 m_profile;
+    std::vector<SessionTickSummary>             m_session_summaries;
+
+    // Merged since the last dump, and the summaries being built (timer thread only)
+    TickProfile                                 m_dump_profile;
+    std::vector<SessionTickSummary>             m_merged_summaries;
+};
@@ -0,0 +1,102 @@
+#include <cmath>
+#include "deterministic_math.hpp"
+
+namespace {
+    constexpr float PI          = 3.14159265358979f;
+    constexpr float HALF_PI     = PI / 2.0f;
+    constexpr float INV_HALF_PI = 2.0f / PI;
+
+    // pi/2 split in three, the first two have few significant bits so 'k * part' is exact (Cody-Waite)
+    constexpr float HALF_PI_1   = 1.5703125f;
+    constexpr float HALF_PI_2   = 4.837512969970703125e-4f;
+    constexpr float HALF_PI_3   = 7.54978995489188216e-8f;
+
+    // Minimax polynomials over [-pi/4, pi/4]
+    float sin_kernel(float x) {
+        const auto x2 = x * x;
+
+        return x + x * x2 * (-1.6666654611e-1f + x2 * (8.3321608736e-3f + x2 * -1.9515295891e-4f));
+    }
+
+    float cos_kernel(float x) {
+        const auto x2 = x * x;
+
+        return 1.0f - 0.5f * x2 + x2 * x2 * (4.166664568298827e-2f + x2 * (-1.388731625493765e-3f + x2 * 2.443315711809948e-5f));
+    }
+
+    // 'quadrant' is the number of quarter turns taken off 'angle', 'reduced' is what remains
+    float reduce(float angle, int& quadrant) {
+        const auto k = std::floor(angle * INV_HALF_PI + 0.5f);
+
+        quadrant = static_cast<int>(static_cast<long long>(k) & 3);
+
+        return ((angle - k * HALF_PI_1) - k * HALF_PI_2) - k * HALF_PI_3;
+    }
+
+    // atan over [0, 1]
+    float atan_kernel(float x) {
+        // atan(x) = pi/4 + atan((x - 1) / (x + 1)) keeps the argument of the polynomial below tan(pi/8)
+        constexpr float TAN_PI_8 = 0.41421356237f;
+
+        auto offset = 0.0f;
+
+        if (x > TAN_PI_8)
+        {
+            x = (x - 1.0f) / (x + 1.0f);
+            offset = PI / 4.0f;
+        }
+
+        const auto x2 = x * x;
+
+        return offset + x + x * x2 * (-3.33329491539e-1f + x2 * (1.99777106478e-1f + x2 * (-1.38776856032e-1f + x2 * 8.05374449538e-2f)));
+    }
+}
+
+float deterministic_sin(float angle) {
+    int quadrant = 0;
+    const auto x = reduce(angle, quadrant);
+
+    switch (quadrant)
+    {
+        case 0:     return sin_kernel(x);
+        case 1:     return cos_kernel(x);
+        case 2:     return -sin_kernel(x);
+        default:    return -cos_kernel(x);
+    }
+}
+
+float deterministic_cos(float angle) {
+    int quadrant = 0;
+    const auto x = reduce(angle, quadrant);
+
+    switch (quadrant)
+    {
+        case 0:     return cos_kernel(x);
+        case 1:     return -sin_kernel(x);
+        case 2:     return -cos_kernel(x);
+        default:    return sin_kernel(x);
+    }
+}
+
+float deterministic_atan2(float y, float x) {
+    const auto abs_x = std::fabs(x);
+    const auto abs_y = std::fabs(y);
+
+    if (abs_x == 0.0f && abs_y == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    // Fold into the first octant
+    const auto swap = abs_y > abs_x;
+    auto angle = swap
+        ? HALF_PI - atan_kernel(abs_x / abs_y)
+        : atan_kernel(abs_y / abs_x);
+
+    if (x < 0.0f)
+    {
+        angle = PI - angle;
+    }
+
+    return y < 0.0f ? -angle : angle;
+}
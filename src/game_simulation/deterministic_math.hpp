@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+    Trigonometry for the simulation
+
+    libm may return different last bits on another libc or CPU, these are polynomials
+    made of float additions, multiplications and divisions only. Built without FMA
+    contraction (see CMakeLists.txt) they give bit-identical results on every x86-64 build.
+
+    Within 3e-7 of the exact values.
+*/
+float deterministic_sin(float angle);
+float deterministic_cos(float angle);
+float deterministic_atan2(float y, float x);
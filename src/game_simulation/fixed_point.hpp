@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/*
+    Q16.16 fixed point
+
+    Integer math gives the same result with every compiler and flag.
+    Values within +-256 convert to float and back exactly (24 significant bits),
+    which covers every position on the playfield.
+*/
+using fixed32 = int32_t;
+
+constexpr int       FIXED_FRACTION_BITS = 16;
+constexpr fixed32   FIXED_ONE           = 1 << FIXED_FRACTION_BITS;
+
+constexpr fixed32 fixed_from_int(int32_t value) {
+    return value * FIXED_ONE;
+}
+
+// Rounds to the nearest step, the scaling by a power of two is exact
+inline fixed32 fixed_from_float(float value) {
+    return static_cast<fixed32>(std::lround(value * static_cast<float>(FIXED_ONE)));
+}
+
+constexpr float fixed_to_float(fixed32 value) {
+    return static_cast<float>(value) / static_cast<float>(FIXED_ONE);
+}
+
+constexpr fixed32 fixed_mul(fixed32 a, fixed32 b) {
+    return static_cast<fixed32>((static_cast<int64_t>(a) * b) >> FIXED_FRACTION_BITS);
+}
@@ -0,0 +1,260 @@
+#include <algorithm>    // std::sort, std::unique, std::find_if, std::remove_if
+#include <functional>   // std::greater
+#include "game_simulation.hpp"
+#include "state_hash.hpp"
+#include "../game_server/game_logic_constants.hpp"
+#include "../game_server/player_movement.hpp"
+#include "../game_server/tick_profiler.hpp"
+
+namespace {
+    // Enemies and bosses fire while they are attacking
+    constexpr uint8_t ATTACKING_STATE_BIT = static_cast<uint8_t>(EnemyState::Attacking);
+    static_assert(ATTACKING_STATE_BIT == static_cast<uint8_t>(BossState::Attacking));
+
+    /*
+        Steps the emitter of every attacking owner, starting it on the first tick the owner attacks
+        and restarting it when the owner switches patterns. Emitters of owners that stopped are dropped.
+    */
+    template <typename T>
+    void run_attack_emitters(
+        const std::vector<T>& owners,
+        std::vector<AttackEmitter>& emitters,
+        const PatternLibrary& library,
+        const Position2D& target,
+        SimulationRandom& random,
+        BulletPool& bullets
+    ) {
+        for (const auto& owner : owners)
+        {
+            if (owner.attack_pattern == PATTERN_NONE || !(owner.state & ATTACKING_STATE_BIT))
+            {
+                continue;
+            }
+
+            // A handful of owners at most, a linear search beats a map
+            auto it = std::find_if(emitters.begin(), emitters.end(), [&](const AttackEmitter& emitter) {
+                return emitter.owner_id == owner.id;
+            });
+
+            if (it == emitters.end())
+            {
+                emitters.push_back(AttackEmitter{ owner.id, false, PatternEmitter(owner.attack_pattern) });
+                it = emitters.end() - 1;
+            }
+            else if (it->emitter.get_pattern() != owner.attack_pattern)
+            {
+                it->emitter.reset(owner.attack_pattern);
+            }
+
+            it->alive = true;
+            it->emitter.step(library, PatternContext{ owner.pos, target, BULLET_OWNER_ENEMY, &random }, bullets);
+        }
+
+        emitters.erase(
+            std::remove_if(emitters.begin(), emitters.end(), [](const AttackEmitter& emitter) { return !emitter.alive; }),
+            emitters.end()
+        );
+
+        for (auto& emitter : emitters)
+        {
+            emitter.alive = false;
+        }
+    }
+}
+
+GameSimulation::GameSimulation(uint64_t seed, std::shared_ptr<const PatternLibrary> patterns)
+    : m_seed(seed)
+    , m_random(seed)
+    , m_frame{}
+    , m_input_queue()
+    , m_last_queued_sequence(0)
+    , m_held_direction(InputDirection::Stop)
+    , m_last_input_sequence(0)
+    , m_bullets()
+    , m_patterns(std::move(patterns))
+    , m_enemy_bullet_grid()
+    , m_player_shot_grid()
+{
+    m_frame.player_count = 1;
+    m_frame.player_vector.push_back(PlayerSnapshot{});
+}
+
+bool GameSimulation::queue_input(const ClientInput& input) {
+    // Duplicated or reordered inputs must not move the player twice
+    if (input.input_sequence <= m_last_queued_sequence)
+    {
+        return false;
+    }
+
+    if (m_input_queue.size() >= MAX_QUEUED_INPUTS)
+    {
+        m_input_queue.pop_front();
+    }
+
+    m_input_queue.push_back(QueuedInput{ input.input_sequence, get_direction_from_arrows(input.game_input.arrows) });
+    m_last_queued_sequence = input.input_sequence;
+
+    return true;
+}
+
+void GameSimulation::step(uint32_t timestamp, TickPhaseTimer* timer) {
+    const auto mark = [timer](TickPhase phase) {
+        if (timer != nullptr)
+        {
+            timer->mark(phase);
+        }
+    };
+
+    move_player();
+    m_bullets.step();
+
+    // New bullets are sent where they spawn, they move from the next tick on
+    run_attack_patterns();
+    mark(TickPhase::Simulation);
+
+    resolve_collisions();
+    mark(TickPhase::Collision);
+
+    // Pack the bullets into the frame in one pass
+    m_bullets.pack(m_frame.bullet_vector);
+    m_frame.bullet_count = static_cast<uint32_t>(m_frame.bullet_vector.size());
+
+    m_frame.timestamp = timestamp;
+    m_frame.last_input_sequence = m_last_input_sequence;
+    mark(TickPhase::FrameBuild);
+}
+
+const FrameSnapshot& GameSimulation::get_frame() const {
+    return m_frame;
+}
+
+uint64_t GameSimulation::get_seed() const {
+    return m_seed;
+}
+
+uint64_t GameSimulation::compute_state_hash() const {
+    StateHasher hasher;
+
+    hash_frame(hasher, m_frame);
+    hasher.update_value(m_random.get_state());
+
+    return hasher.finish();
+}
+
+uint64_t GameSimulation::compute_patterns_hash() const {
+    if (m_patterns == nullptr)
+    {
+        return 0;
+    }
+
+    StateHasher hasher;
+
+    // PatternInstruction has no padding, see pattern_program.hpp
+    hasher.update(m_patterns->get_code(), m_patterns->get_code_size() * sizeof(PatternInstruction));
+
+    // Which pattern starts where, the same code under other ids fires differently
+    for (size_t id = 0; id < PATTERN_ID_COUNT; id++)
+    {
+        const auto pattern = static_cast<uint8_t>(id);
+
+        if (m_patterns->has_pattern(pattern))
+        {
+            hasher.update_value(pattern);
+            hasher.update_value(m_patterns->get_entry(pattern));
+        }
+    }
+
+    return hasher.finish();
+}
+
+void GameSimulation::move_player() {
+    // Every applied input is one tick of movement, the client predicts exactly the same steps
+    if (!m_input_queue.empty())
+    {
+        m_held_direction = m_input_queue.front().direction;
+        m_last_input_sequence = m_input_queue.front().sequence;
+
+        m_input_queue.pop_front();
+    }
+
+    apply_player_input(m_frame.player_vector[0], m_held_direction);
+}
+
+void GameSimulation::run_attack_patterns() {
+    if (m_patterns == nullptr)
+    {
+        return;
+    }
+
+    const auto& target = m_frame.player_vector[0].pos;
+
+    run_attack_emitters(m_frame.enemy_vector, m_enemy_emitters, *m_patterns, target, m_random, m_bullets);
+    run_attack_emitters(m_frame.boss_vector,  m_boss_emitters,  *m_patterns, target, m_random, m_bullets);
+}
+
+void GameSimulation::resolve_collisions() {
+    m_enemy_bullet_grid.rebuild(m_bullets, BULLET_OWNER_ENEMY);
+    m_player_shot_grid.rebuild(m_bullets, BULLET_OWNER_PLAYER);
+
+    m_hits.clear();
+
+    // Enemy bullets vs players
+    for (auto& player : m_frame.player_vector)
+    {
+        m_grazes.clear();
+
+        m_enemy_bullet_grid.query(
+            player.pos.x, player.pos.y,
+            game_logic_constants::PLAYER_RADIUS,
+            game_logic_constants::PLAYER_GRAZE_RADIUS,
+            m_hits, m_grazes
+        );
+
+        // Each bullet can only be grazed once
+        for (const auto i : m_grazes)
+        {
+            const auto flags = m_bullets.get_flags()[i];
+
+            if (!(flags & BULLET_FLAG_GRAZED))
+            {
+                m_bullets.set_flags(i, flags | BULLET_FLAG_GRAZED);
+                m_frame.score++;
+            }
+        }
+    }
+
+    // Player shots vs enemies and bosses
+    const auto hit_target = [&](const Position2D& pos, float radius, uint32_t& health) {
+        const auto first_hit = m_hits.size();
+
+        m_player_shot_grid.query(pos.x, pos.y, radius, m_hits);
+
+        for (auto h = first_hit; h < m_hits.size(); h++)
+        {
+            health = health > 0 ? health - 1 : 0;
+        }
+    };
+
+    for (auto& enemy : m_frame.enemy_vector)
+    {
+        hit_target(enemy.pos, enemy.radius, enemy.health);
+    }
+
+    for (auto& boss : m_frame.boss_vector)
+    {
+        hit_target(boss.pos, boss.radius, boss.health);
+    }
+
+    /*
+        Bullets that hit something are consumed.
+        Remove them from the back, since removing swaps the last bullet into the hole.
+        A bullet may have hit several targets, so drop the duplicates first.
+    */
+    std::sort(m_hits.begin(), m_hits.end(), std::greater<uint32_t>());
+    m_hits.erase(std::unique(m_hits.begin(), m_hits.end()), m_hits.end());
+
+    for (const auto i : m_hits)
+    {
+        m_bullets.remove(i);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "../packet_template/packet_template.hpp"
+#include "../game_server/bullet_pool.hpp"
+#include "../game_server/spatial_grid.hpp"
+#include "../bullet_pattern/pattern_emitter.hpp"
+#include "simulation_random.hpp"
+
+class TickPhaseTimer;
+
+// The attack pattern of an enemy or a boss, matched to its owner by id
+struct AttackEmitter {
+    uint8_t         owner_id;
+    bool            alive;
+    PatternEmitter  emitter;
+};
+
+/*
+    The game state of a session and the rules that advance it, without any I/O.
+
+    Deterministic: the same seed and the same calls give bit-identical frames on every
+    x86-64 build. The player moves in fixed point, everything else is float math without
+    libm and without FMA contraction (see CMakeLists.txt), random numbers come from the
+    seeded SimulationRandom only, and containers are walked in insertion order.
+*/
+class GameSimulation {
+public:
+    // Enemies and bosses fire the attack patterns of 'patterns', they don't fire without a library
+    explicit GameSimulation(uint64_t seed, std::shared_ptr<const PatternLibrary> patterns = nullptr);
+
+    /*
+        Queues the input for the following steps, each step applies at most one queued input.
+        Returns false for a duplicated or reordered input (sequence not above the last queued one).
+        Beyond MAX_QUEUED_INPUTS the oldest input is dropped, the client prediction corrects itself.
+    */
+    bool queue_input(const ClientInput& input);
+
+    /*
+        Advances the player, bullets, attack patterns and collisions by one tick and updates the frame.
+        The Simulation, Collision and FrameBuild phases are marked on 'timer' if given.
+    */
+    void step(uint32_t timestamp, TickPhaseTimer* timer = nullptr);
+
+    // The frame of the last step
+    const FrameSnapshot& get_frame() const;
+
+    uint64_t get_seed() const;
+
+    // Hash of the frame of the last step and the random state, equal hashes mean equal runs so far
+    uint64_t compute_state_hash() const;
+
+    // Hash of the compiled attack patterns, 0 without a library. Runs only match with equal patterns
+    uint64_t compute_patterns_hash() const;
+
+    static constexpr size_t MAX_QUEUED_INPUTS = 4;
+
+private:
+    struct QueuedInput {
+        uint32_t        sequence;
+        InputDirection  direction;
+    };
+
+    // One queued input per step, or the last direction again while the queue is empty
+    void move_player();
+    void run_attack_patterns();
+    void resolve_collisions();
+
+    uint64_t                                m_seed;
+    SimulationRandom                        m_random;
+
+    FrameSnapshot                           m_frame;
+
+    /*
+        The player moves once per tick whatever the client sends, so a client can't move
+        faster by sending more inputs and a burst after a network stall is spread out.
+    */
+    std::deque<QueuedInput>                 m_input_queue;
+    uint32_t                                m_last_queued_sequence;
+    InputDirection                          m_held_direction;
+
+    // Sequence of the last applied ClientInput, echoed in every frame for the client prediction
+    uint32_t                                m_last_input_sequence;
+    BulletPool                              m_bullets;
+
+    std::shared_ptr<const PatternLibrary>   m_patterns;
+    std::vector<AttackEmitter>              m_enemy_emitters;
+    std::vector<AttackEmitter>              m_boss_emitters;
+
+    // Broad-phase, rebuilt every tick
+    SpatialGrid                             m_enemy_bullet_grid;
+    SpatialGrid                             m_player_shot_grid;
+
+    // Scratch buffers for the collision queries
+    std::vector<uint32_t>                   m_hits;
+    std::vector<uint32_t>                   m_grazes;
+};
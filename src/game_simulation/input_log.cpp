@@ -0,0 +1,322 @@
+#include <iostream>
+#include <iterator>
+#include <algorithm>    // std::equal
+#include <filesystem>
+#include "input_log.hpp"
+
+namespace {
+    constexpr char      INPUT_LOG_MAGIC[4]      = { 'B', 'H', 'I', 'L' };
+    constexpr uint16_t  INPUT_LOG_VERSION       = 1;
+    constexpr size_t    INPUT_LOG_HEADER_SIZE   = 24;
+
+    // Every bitset of an input fits in a byte
+    static_assert(static_cast<size_t>(GameAction::Count) <= 8);
+    static_assert(static_cast<size_t>(Arrow::Count) <= 8);
+
+    /*
+        Writing
+    */
+    void write_uint(uint64_t value, size_t size, std::vector<std::byte>& out) {
+        for (size_t i = 0; i < size; i++)
+        {
+            out.push_back(static_cast<std::byte>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void write_varint(uint64_t value, std::vector<std::byte>& out) {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<std::byte>(value));
+    }
+
+    // Small deltas in either direction stay small
+    void write_delta(uint32_t value, uint32_t previous, std::vector<std::byte>& out) {
+        const auto delta = static_cast<int32_t>(value - previous);
+        const auto zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+
+        write_varint(zigzag, out);
+    }
+
+    template <size_t N>
+    void write_bitset(const std::bitset<N>& bits, std::vector<std::byte>& out) {
+        out.push_back(static_cast<std::byte>(bits.to_ulong()));
+    }
+
+    /*
+        Reading, every function returns false at the end of the buffer
+    */
+    struct LogCursor {
+        const std::byte*    bytes;
+        size_t              size;
+        size_t              offset;
+    };
+
+    uint64_t read_uint(LogCursor& cursor, size_t size) {
+        uint64_t value = 0;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            value |= static_cast<uint64_t>(std::to_integer<uint8_t>(cursor.bytes[cursor.offset++])) << (i * 8);
+        }
+
+        return value;
+    }
+
+    bool read_varint(LogCursor& cursor, uint64_t& value) {
+        value = 0;
+
+        for (size_t shift = 0; shift < 64; shift += 7)
+        {
+            if (cursor.offset >= cursor.size)
+            {
+                return false;
+            }
+
+            const auto byte = std::to_integer<uint8_t>(cursor.bytes[cursor.offset++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool read_delta(LogCursor& cursor, uint32_t previous, uint32_t& value) {
+        uint64_t zigzag = 0;
+
+        if (!read_varint(cursor, zigzag) || zigzag > UINT32_MAX)
+        {
+            return false;
+        }
+
+        const auto delta = static_cast<uint32_t>(zigzag >> 1) ^ (0u - static_cast<uint32_t>(zigzag & 1));
+        value = previous + delta;
+
+        return true;
+    }
+
+    template <size_t N>
+    bool read_bitset(LogCursor& cursor, std::bitset<N>& bits) {
+        if (cursor.offset >= cursor.size)
+        {
+            return false;
+        }
+
+        bits = std::bitset<N>(std::to_integer<uint8_t>(cursor.bytes[cursor.offset++]));
+
+        return true;
+    }
+
+    bool read_input(LogCursor& cursor, const ClientInput& previous, ClientInput& input) {
+        auto& game_input = input.game_input;
+
+        return read_delta(cursor, previous.client_id,       input.client_id)
+            && read_delta(cursor, previous.frame_timestamp, input.frame_timestamp)
+            && read_delta(cursor, previous.input_sequence,  input.input_sequence)
+            && read_bitset(cursor, game_input.held)
+            && read_bitset(cursor, game_input.pressed)
+            && read_bitset(cursor, game_input.released)
+            && read_bitset(cursor, game_input.arrows.held)
+            && read_bitset(cursor, game_input.arrows.pressed)
+            && read_bitset(cursor, game_input.arrows.released);
+    }
+}
+
+InputLogWriter::InputLogWriter()
+    : m_last_tick(0)
+    , m_last_input{}
+{}
+
+InputLogWriter::~InputLogWriter() {
+    close();
+}
+
+bool InputLogWriter::open(const std::string& path, uint64_t seed, uint64_t patterns_hash) {
+    close();
+
+    const auto parent = std::filesystem::path(path).parent_path();
+    std::error_code error;
+
+    if (!parent.empty())
+    {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!m_file.is_open())
+    {
+        std::cerr << "[InputLogWriter] ERROR: Failed to open " << path << "\n";
+
+        return false;
+    }
+
+    m_last_tick = 0;
+    m_last_input = ClientInput{};
+
+    m_buffer.clear();
+
+    for (const auto c : INPUT_LOG_MAGIC)
+    {
+        m_buffer.push_back(static_cast<std::byte>(c));
+    }
+
+    write_uint(INPUT_LOG_VERSION,   sizeof(uint16_t), m_buffer);
+    write_uint(0,                   sizeof(uint16_t), m_buffer);
+    write_uint(seed,                sizeof(uint64_t), m_buffer);
+    write_uint(patterns_hash,       sizeof(uint64_t), m_buffer);
+
+    write_buffer();
+
+    return is_open();
+}
+
+void InputLogWriter::close() {
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+bool InputLogWriter::is_open() const {
+    return m_file.is_open();
+}
+
+void InputLogWriter::append_input(uint64_t tick, const ClientInput& input) {
+    if (!is_open())
+    {
+        return;
+    }
+
+    append_record(tick, InputLogRecordKind::Input);
+
+    const auto& game_input = input.game_input;
+
+    write_delta(input.client_id,        m_last_input.client_id,         m_buffer);
+    write_delta(input.frame_timestamp,  m_last_input.frame_timestamp,   m_buffer);
+    write_delta(input.input_sequence,   m_last_input.input_sequence,    m_buffer);
+
+    write_bitset(game_input.held,               m_buffer);
+    write_bitset(game_input.pressed,            m_buffer);
+    write_bitset(game_input.released,           m_buffer);
+    write_bitset(game_input.arrows.held,        m_buffer);
+    write_bitset(game_input.arrows.pressed,     m_buffer);
+    write_bitset(game_input.arrows.released,    m_buffer);
+
+    m_last_input = input;
+
+    write_buffer();
+}
+
+void InputLogWriter::append_step(uint64_t tick) {
+    if (!is_open())
+    {
+        return;
+    }
+
+    append_record(tick, InputLogRecordKind::Step);
+    write_buffer();
+}
+
+void InputLogWriter::append_record(uint64_t tick, InputLogRecordKind kind) {
+    // Ticks never go back, the first record is relative to tick 0
+    const auto delta = tick - m_last_tick;
+
+    m_buffer.clear();
+    write_varint((delta << 1) | static_cast<uint64_t>(kind), m_buffer);
+
+    m_last_tick = tick;
+}
+
+void InputLogWriter::write_buffer() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+
+    // A full disk must not stop the session, the log just ends here
+    if (!m_file)
+    {
+        std::cerr << "[InputLogWriter] ERROR: Failed to write, the input log has been closed" << "\n";
+
+        m_file.close();
+    }
+}
+
+std::optional<InputLog> read_input_log(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        std::cerr << "[read_input_log] ERROR: Failed to open " << path << "\n";
+
+        return std::nullopt;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto cursor = LogCursor{ reinterpret_cast<const std::byte*>(data.data()), data.size(), 0 };
+
+    if (cursor.size < INPUT_LOG_HEADER_SIZE || !std::equal(std::begin(INPUT_LOG_MAGIC), std::end(INPUT_LOG_MAGIC), data.begin()))
+    {
+        std::cerr << "[read_input_log] ERROR: " << path << " is not an input log" << "\n";
+
+        return std::nullopt;
+    }
+
+    cursor.offset = sizeof(INPUT_LOG_MAGIC);
+
+    const auto version = read_uint(cursor, sizeof(uint16_t));
+    read_uint(cursor, sizeof(uint16_t));
+
+    if (version != INPUT_LOG_VERSION)
+    {
+        std::cerr << "[read_input_log] ERROR: Unsupported input log version: " << version << "\n";
+
+        return std::nullopt;
+    }
+
+    auto log = InputLog{};
+    log.seed = read_uint(cursor, sizeof(uint64_t));
+    log.patterns_hash = read_uint(cursor, sizeof(uint64_t));
+
+    // Roughly one byte per step plus ten per input
+    log.records.reserve(cursor.size / 4);
+
+    uint64_t tick = 0;
+    auto last_input = ClientInput{};
+
+    while (cursor.offset < cursor.size)
+    {
+        uint64_t tag = 0;
+        auto record = InputLogRecord{};
+
+        if (!read_varint(cursor, tag))
+        {
+            break;
+        }
+
+        tick += tag >> 1;
+
+        record.tick = tick;
+        record.kind = static_cast<InputLogRecordKind>(tag & 1);
+
+        if (record.kind == InputLogRecordKind::Input)
+        {
+            if (!read_input(cursor, last_input, record.input))
+            {
+                break;
+            }
+
+            last_input = record.input;
+        }
+
+        log.records.push_back(record);
+    }
+
+    return log;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include "../packet_template/input.hpp"
+#include "game_simulation.hpp"
+
+/*
+    Input log (.inputlog)
+
+    Everything a GameSimulation needs to run a session again: the seed, every received
+    ClientInput with the tick it arrived on, and every tick that was stepped (the scheduler
+    may skip ticks, and the tick is the frame timestamp). The attack patterns are not in the
+    log, only their hash, so a replay with other patterns is reported instead of diverging.
+
+    Little endian.
+    Header: magic "BHIL", uint16_t version, uint16_t reserved, uint64_t seed,
+            uint64_t patterns hash (GameSimulation::compute_patterns_hash())
+    Record: varint (tick - tick of the previous record) << 1 | kind, then for an input
+            the varint zigzag deltas of client_id, frame_timestamp and input_sequence
+            against the previous input and one byte per action and arrow bitset.
+
+    A step is one byte and a typical input ten, so an hour at 60 ticks per second with
+    one input per tick is about 2.4MB.
+*/
+enum class InputLogRecordKind : uint8_t {
+    Input,  // Applied before the step of the same tick, in log order
+    Step
+};
+
+struct InputLogRecord {
+    uint64_t            tick;
+    InputLogRecordKind  kind;
+    ClientInput         input;  // Unused for a step
+};
+
+struct InputLog {
+    uint64_t                    seed;
+    uint64_t                    patterns_hash;
+    std::vector<InputLogRecord> records;
+};
+
+/*
+    Appends to an input log file while the session runs.
+    Records are buffered by the stream, nothing is flushed per tick.
+*/
+class InputLogWriter {
+public:
+    InputLogWriter();
+    ~InputLogWriter();
+
+    // Delete copy constructor and copy assignment operator
+    InputLogWriter(const InputLogWriter&) = delete;
+    InputLogWriter& operator=(const InputLogWriter&) = delete;
+
+    // Creates the parent directories, truncates 'path' and writes the header
+    bool open(const std::string& path, uint64_t seed, uint64_t patterns_hash);
+    void close();
+    bool is_open() const;
+
+    void append_input(uint64_t tick, const ClientInput& input);
+    void append_step(uint64_t tick);
+
+private:
+    void append_record(uint64_t tick, InputLogRecordKind kind);
+    void write_buffer();
+
+    std::ofstream           m_file;
+    uint64_t                m_last_tick;
+    ClientInput             m_last_input;
+
+    // Scratch buffer of the record being written
+    std::vector<std::byte>  m_buffer;
+};
+
+// Reads a whole log, a log cut off in the middle of a record ends at the last complete one
+std::optional<InputLog> read_input_log(const std::string& path);
+
+/*
+    Runs 'log' through 'simulation', which must have been created with the seed of the log
+    and the pattern library of the recording server. 'on_step(tick)' is called after every
+    step, with the frame of that tick in 'simulation.get_frame()'.
+    Returns the number of steps.
+*/
+template <typename OnStep>
+size_t replay_input_log(const InputLog& log, GameSimulation& simulation, OnStep&& on_step) {
+    size_t steps = 0;
+
+    for (const auto& record : log.records)
+    {
+        if (record.kind == InputLogRecordKind::Input)
+        {
+            // Duplicated inputs are in the log as they were received, the simulation drops them again
+            simulation.queue_input(record.input);
+
+            continue;
+        }
+
+        simulation.step(static_cast<uint32_t>(record.tick));
+        on_step(record.tick);
+
+        steps++;
+    }
+
+    return steps;
+}
@@ -0,0 +1,60 @@
+#include "simulation_random.hpp"
+
+namespace {
+    uint32_t rotl(uint32_t value, int shift) {
+        return (value << shift) | (value >> (32 - shift));
+    }
+
+    uint64_t splitmix64(uint64_t& state) {
+        auto z = (state += 0x9E3779B97F4A7C15ull);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+        return z ^ (z >> 31);
+    }
+}
+
+SimulationRandom::SimulationRandom(uint64_t seed) {
+    this->seed(seed);
+}
+
+void SimulationRandom::seed(uint64_t seed) {
+    const auto first = splitmix64(seed);
+    const auto second = splitmix64(seed);
+
+    // Never all zero, splitmix64 is a bijection of a moving counter
+    m_state = {
+        static_cast<uint32_t>(first),
+        static_cast<uint32_t>(first >> 32),
+        static_cast<uint32_t>(second),
+        static_cast<uint32_t>(second >> 32)
+    };
+}
+
+uint32_t SimulationRandom::next_u32() {
+    const auto result = rotl(m_state[1] * 5, 7) * 9;
+    const auto t = m_state[1] << 9;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+
+    m_state[2] ^= t;
+    m_state[3] = rotl(m_state[3], 11);
+
+    return result;
+}
+
+float SimulationRandom::next_float() {
+    return static_cast<float>(next_u32() >> 8) * (1.0f / 16777216.0f);
+}
+
+float SimulationRandom::next_range(float min, float max) {
+    return min + (max - min) * next_float();
+}
+
+const std::array<uint32_t, 4>& SimulationRandom::get_state() const {
+    return m_state;
+}
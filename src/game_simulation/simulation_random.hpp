@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/*
+    Seeded random numbers for the simulation (xoshiro128**)
+
+    Integer only, the same seed gives the same sequence on every build.
+    Unlike std::uniform_real_distribution, the float mapping is specified here as well.
+*/
+class SimulationRandom {
+public:
+    explicit SimulationRandom(uint64_t seed = 0);
+
+    // The state is expanded from 'seed' with splitmix64
+    void seed(uint64_t seed);
+
+    uint32_t next_u32();
+
+    // Uniform in [0, 1), multiples of 2^-24
+    float next_float();
+
+    // Uniform in [min, max)
+    float next_range(float min, float max);
+
+    const std::array<uint32_t, 4>& get_state() const;
+
+private:
+    std::array<uint32_t, 4>     m_state;
+};
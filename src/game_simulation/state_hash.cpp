@@ -0,0 +1,75 @@
+#include <cstring>
+#include "state_hash.hpp"
+
+namespace {
+    constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+
+    uint64_t rotl(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    template <typename T>
+    void hash_entities(StateHasher& hasher, const std::vector<T>& entities) {
+        hasher.update_value(static_cast<uint32_t>(entities.size()));
+        hasher.update(entities.data(), entities.size() * sizeof(T));
+    }
+}
+
+StateHasher::StateHasher()
+    : m_hash(PRIME_3)
+    , m_length(0)
+{}
+
+void StateHasher::update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+
+    m_length += size;
+
+    for (; size >= sizeof(uint64_t); bytes += sizeof(uint64_t), size -= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+
+        mix(word);
+    }
+
+    // The tail is zero padded, the length in 'finish()' tells the paddings apart
+    if (size > 0)
+    {
+        uint64_t word = 0;
+        memcpy(&word, bytes, size);
+
+        mix(word);
+    }
+}
+
+uint64_t StateHasher::finish() const {
+    auto hash = m_hash ^ (m_length * PRIME_1);
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+void StateHasher::mix(uint64_t word) {
+    m_hash ^= rotl(word * PRIME_2, 31) * PRIME_1;
+    m_hash = rotl(m_hash, 27) * PRIME_1 + PRIME_3;
+}
+
+void hash_frame(StateHasher& hasher, const FrameSnapshot& frame) {
+    // The fixed header is the first 24 bytes of FrameSnapshot, as in 'serialize_frame_into()'
+    hasher.update(&frame, FRAME_SNAPSHOT_FIXED_HEADER_SIZE);
+    hasher.update_value(frame.stage);
+
+    hash_entities(hasher, frame.player_vector);
+    hash_entities(hasher, frame.enemy_vector);
+    hash_entities(hasher, frame.boss_vector);
+    hash_entities(hasher, frame.bullet_vector);
+    hash_entities(hasher, frame.item_vector);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "../packet_template/frame.hpp"
+
+/*
+    64 bit hash of the simulation state, to compare runs tick by tick (replays, server checksums).
+    Not cryptographic, 8 bytes are mixed at a time.
+*/
+class StateHasher {
+public:
+    StateHasher();
+
+    void update(const void* data, size_t size);
+
+    template <typename T>
+    void update_value(const T& value) {
+        update(&value, sizeof(T));
+    }
+
+    uint64_t finish() const;
+
+private:
+    void mix(uint64_t word);
+
+    uint64_t    m_hash;
+    uint64_t    m_length;
+};
+
+// Hashes every field of 'frame', the entity structs have no padding
+void hash_frame(StateHasher& hasher, const FrameSnapshot& frame);
@@ -0,0 +1,504 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <condition_variable>
+
+/*
+    Bounded lock-free channels
+
+    spsc_channel<T>(capacity)   One sender thread, one receiver thread
+    mpmc_channel<T>(capacity)   Any number of threads on both ends
+
+    Same shape as AsyncChannel: the factory returns a (sender, receiver) pair,
+    each end is move-only and closes the channel when it is destroyed.
+    The ends of an MPMC channel are thread safe, share them by reference.
+
+    The fast path is lock-free. A mutex and a condition_variable are only touched
+    when a receiver actually has to sleep in 'recv' / 'recv_for', and senders only
+    notify when somebody is sleeping.
+    The capacity is rounded up to a power of two, and T must be default constructible.
+*/
+
+namespace channel_detail {
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    inline size_t round_up_to_power_of_two(size_t value) {
+        size_t result = 2;
+
+        while (result < value)
+        {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    /*
+        Lets receivers sleep until something is sent or the channel is closed
+    */
+    struct Waiter {
+        std::mutex                  mtx;
+        std::condition_variable     cv;
+        std::atomic<size_t>         sleepers{0};
+
+        void notify() {
+            // Paired with the seq_cst increment of 'sleepers' in 'wait_until'
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (sleepers.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard lock(mtx);
+                cv.notify_all();
+            }
+        }
+
+        // 'ready' is called again after registering as a sleeper, so a send can't be missed
+        template <typename Predicate, typename Clock, typename Duration>
+        bool wait_until(Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline) {
+            std::unique_lock lock(mtx);
+
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            const auto result = cv.wait_until(lock, deadline, ready);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+            return result;
+        }
+
+        template <typename Predicate>
+        void wait(Predicate ready) {
+            std::unique_lock lock(mtx);
+
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            cv.wait(lock, ready);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    /*
+        Single-producer single-consumer ring
+        Each side caches the other side's index, so the shared cache lines are
+        only read when the cached value says the ring is full / empty.
+    */
+    template <typename T>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(size_t capacity)
+            : m_slots(round_up_to_power_of_two(capacity))
+            , m_mask(m_slots.size() - 1)
+        {}
+
+        template <typename U>
+        bool try_push(U&& item) {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail - m_cached_head >= m_slots.size())
+            {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+
+                if (tail - m_cached_head >= m_slots.size())
+                {
+                    return false;
+                }
+            }
+
+            m_slots[tail & m_mask] = std::forward<U>(item);
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool try_pop(T& out) {
+            const auto head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_cached_tail)
+            {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+
+                if (head == m_cached_tail)
+                {
+                    return false;
+                }
+            }
+
+            out = std::move(m_slots[head & m_mask]);
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool empty() const {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::vector<T>                                      m_slots;
+        const size_t                                        m_mask;
+
+        // Consumer side
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t>        m_head{0};
+        size_t                                              m_cached_tail = 0;
+
+        // Producer side
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t>        m_tail{0};
+        size_t                                              m_cached_head = 0;
+    };
+
+    /*
+        Multi-producer multi-consumer ring (Dmitry Vyukov's bounded queue)
+        Every slot carries a sequence number telling whose turn it is,
+        so producers and consumers only contend on their own index.
+    */
+    template <typename T>
+    class MpmcQueue {
+    public:
+        explicit MpmcQueue(size_t capacity)
+            : m_slots(round_up_to_power_of_two(capacity))
+            , m_mask(m_slots.size() - 1)
+        {
+            for (size_t i = 0; i < m_slots.size(); i++)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        template <typename U>
+        bool try_push(U&& item) {
+            auto position = m_tail.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & m_mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                if (diff == 0)
+                {
+                    if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = std::forward<U>(item);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // Full
+                    return false;
+                }
+                else
+                {
+                    position = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool try_pop(T& out) {
+            auto position = m_head.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & m_mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+                if (diff == 0)
+                {
+                    if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        out = std::move(slot.value);
+                        slot.sequence.store(position + m_slots.size(), std::memory_order_release);
+
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // Empty
+                    return false;
+                }
+                else
+                {
+                    position = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool empty() const {
+            const auto position = m_head.load(std::memory_order_acquire);
+            const auto sequence = m_slots[position & m_mask].sequence.load(std::memory_order_acquire);
+
+            return static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1) < 0;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<size_t>     sequence;
+            T                       value;
+        };
+
+        std::vector<Slot>                                   m_slots;
+        const size_t                                        m_mask;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t>        m_head{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t>        m_tail{0};
+    };
+}
+
+template <typename T, typename Queue>
+class LockFreeChannel;
+
+template <typename T>
+using SpscChannel = LockFreeChannel<T, channel_detail::SpscQueue<T>>;
+
+template <typename T>
+using MpmcChannel = LockFreeChannel<T, channel_detail::MpmcQueue<T>>;
+
+template <typename T>
+std::pair<SpscChannel<T>, SpscChannel<T>> spsc_channel(size_t capacity);
+
+template <typename T>
+std::pair<MpmcChannel<T>, MpmcChannel<T>> mpmc_channel(size_t capacity);
+
+template <typename T, typename Queue>
+class LockFreeChannel {
+public:
+    LockFreeChannel(LockFreeChannel const&) = delete;
+    LockFreeChannel(LockFreeChannel&&) = default;
+    LockFreeChannel& operator = (LockFreeChannel const&) = delete;
+    LockFreeChannel& operator = (LockFreeChannel&&) = default;
+
+    ~LockFreeChannel() { close(); }
+
+    /*
+        Sender
+    */
+
+    // Returns false if the channel is full or closed, 'item' is only moved from on success
+    bool try_send(T&& item) {
+        return try_send_impl(std::move(item));
+    }
+
+    bool try_send(const T& item) {
+        return try_send_impl(item);
+    }
+
+    // Waits (spinning, then yielding) while the channel is full
+    bool send(T item) {
+        for (size_t attempt = 0; ; attempt++)
+        {
+            if (try_send(std::move(item)))
+            {
+                return true;
+            }
+
+            if (!is_sender_ || state_ == nullptr || state_->closed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            if (attempt > SPIN_LIMIT)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /*
+        Receiver
+    */
+    std::optional<T> try_recv() {
+        if (is_sender_ || state_ == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        T item;
+
+        if (!state_->queue.try_pop(item))
+        {
+            return std::nullopt;
+        }
+
+        return item;
+    }
+
+    // Moves up to 'max_items' items to the back of 'out' without waiting, returns the number of items
+    size_t recv_many(std::vector<T>& out, size_t max_items) {
+        if (is_sender_ || state_ == nullptr)
+        {
+            return 0;
+        }
+
+        size_t count = 0;
+        T item;
+
+        while (count < max_items && state_->queue.try_pop(item))
+        {
+            out.push_back(std::move(item));
+            count++;
+        }
+
+        return count;
+    }
+
+    // Waits until an item arrives, returns std::nullopt once the channel is closed and drained
+    std::optional<T> recv() {
+        while (true)
+        {
+            if (auto item = spin_recv())
+            {
+                return item;
+            }
+
+            if (is_sender_ || state_ == nullptr)
+            {
+                return std::nullopt;
+            }
+
+            if (state_->closed.load(std::memory_order_acquire))
+            {
+                return try_recv();
+            }
+
+            state_->waiter.wait([this] { return ready_or_closed(); });
+        }
+    }
+
+    // Same as 'recv()', but gives up after 'timeout'
+    template <typename Rep, typename Period>
+    std::optional<T> recv_for(const std::chrono::duration<Rep, Period>& timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (true)
+        {
+            if (auto item = spin_recv())
+            {
+                return item;
+            }
+
+            if (is_sender_ || state_ == nullptr)
+            {
+                return std::nullopt;
+            }
+
+            if (state_->closed.load(std::memory_order_acquire))
+            {
+                return try_recv();
+            }
+
+            if (!state_->waiter.wait_until([this] { return ready_or_closed(); }, deadline))
+            {
+                return try_recv();
+            }
+        }
+    }
+
+    bool closed() const {
+        return state_ == nullptr || state_->closed.load(std::memory_order_acquire);
+    }
+
+    void close() {
+        if (state_ != nullptr && !state_->closed.exchange(true, std::memory_order_acq_rel))
+        {
+            // Wake up everyone sleeping in 'recv'
+            std::lock_guard lock(state_->waiter.mtx);
+            state_->waiter.cv.notify_all();
+        }
+    }
+
+private:
+    static constexpr size_t SPIN_LIMIT = 64;
+
+    struct LockFreeChannelState {
+        explicit LockFreeChannelState(size_t capacity)
+            : queue(capacity)
+        {}
+
+        Queue                       queue;
+        channel_detail::Waiter      waiter;
+        std::atomic<bool>           closed{false};
+    };
+
+    std::shared_ptr<LockFreeChannelState> state_;
+    bool is_sender_;
+
+    explicit LockFreeChannel(std::shared_ptr<LockFreeChannelState> state, bool is_sender)
+        : state_{std::move(state)}
+        , is_sender_{is_sender} {}
+
+    template <typename U>
+    bool try_send_impl(U&& item) {
+        if (!is_sender_ || state_ == nullptr || state_->closed.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        if (!state_->queue.try_push(std::forward<U>(item)))
+        {
+            return false;
+        }
+
+        state_->waiter.notify();
+
+        return true;
+    }
+
+    // Busy polls a little before going to sleep, most messages arrive within microseconds
+    std::optional<T> spin_recv() {
+        for (size_t attempt = 0; attempt < SPIN_LIMIT; attempt++)
+        {
+            if (auto item = try_recv())
+            {
+                return item;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool ready_or_closed() const {
+        return !state_->queue.empty() || state_->closed.load(std::memory_order_acquire);
+    }
+
+    friend std::pair<SpscChannel<T>, SpscChannel<T>> spsc_channel<T>(size_t capacity);
+    friend std::pair<MpmcChannel<T>, MpmcChannel<T>> mpmc_channel<T>(size_t capacity);
+};
+
+template <typename T>
+std::pair<SpscChannel<T>, SpscChannel<T>> spsc_channel(size_t capacity) {
+    auto state = std::make_shared<typename SpscChannel<T>::LockFreeChannelState>(capacity);
+
+    SpscChannel<T> sender(state, true);
+    SpscChannel<T> receiver(std::move(state), false);
+
+    return {
+        std::move(sender),
+        std::move(receiver)
+    };
+}
+
+template <typename T>
+std::pair<MpmcChannel<T>, MpmcChannel<T>> mpmc_channel(size_t capacity) {
+    auto state = std::make_shared<typename MpmcChannel<T>::LockFreeChannelState>(capacity);
+
+    MpmcChannel<T> sender(state, true);
+    MpmcChannel<T> receiver(std::move(state), false);
+
+    return {
+        std::move(sender),
+        std::move(receiver)
+    };
+}
@@ -30,6 +30,14 @@ int main(int argc, char* args[]) {
 
         game_server_master->run_async();
         game_server_master->wait_for_accept_ready(1000, 10);
+
+        // Talk to the local server in memory instead of over 127.0.0.1
+        auto local_transport = game_server_master->connect_local();
+
+        if (local_transport == nullptr)
+        {
+            std::cerr << "[main] Failed to connect to the local server, falling back to TCP" << "\n";
+        }
     #endif
 
     App             app;
@@ -49,7 +57,11 @@ int main(int argc, char* args[]) {
         return EXIT_FAILURE;
     }
 
+#ifdef ENABLE_LOCAL_SERVER
+    const auto app_result = app.run(local_transport);
+#else
     const auto app_result = app.run();
+#endif
     const auto exit_status = static_cast<int>(app_result.exit_status);
     
     std::cout << "[main] Goodbye with exit status: " << exit_status << "\n";
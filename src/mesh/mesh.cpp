@@ -5,7 +5,8 @@ Mesh::Mesh(
     const std::vector<GLfloat>& vertices,
     const std::vector<GLuint>& indices,
     const std::vector<VertexAttribute>& attributes)
-    : m_index_count(static_cast<GLsizei>(indices.size())) {
+    : m_has_instance_attributes(false)
+    , m_index_count(static_cast<GLsizei>(indices.size())) {
     
     GLsizei vertex_size = 0;
 
@@ -100,6 +101,43 @@ void Mesh::draw() const {
     glBindVertexArray(0);
 }
 
+void Mesh::draw_instanced(GLsizei instance_count, GLuint base_instance) const {
+    glDrawElementsInstancedBaseInstance(
+        GL_TRIANGLES,
+        m_index_count,
+        GL_UNSIGNED_INT,
+        0,
+        instance_count,
+        base_instance
+    );
+}
+
+void Mesh::set_instance_attributes(GLuint binding, const std::vector<InstanceAttribute>& attributes) {
+    glBindVertexArray(m_vao);
+
+    for (const auto& attr : attributes)
+    {
+        glEnableVertexAttribArray(attr.location);
+        glVertexAttribFormat(attr.location, attr.size, GL_FLOAT, GL_FALSE, attr.offset);
+        glVertexAttribBinding(attr.location, binding);
+    }
+
+    // Advance once per instance instead of once per vertex
+    glVertexBindingDivisor(binding, 1);
+
+    glBindVertexArray(0);
+
+    m_has_instance_attributes = true;
+}
+
+bool Mesh::has_instance_attributes() const {
+    return m_has_instance_attributes;
+}
+
+void Mesh::bind_instance_buffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride) const {
+    glBindVertexBuffer(binding, buffer, offset, stride);
+}
+
 void Mesh::cleanup() {
     if (m_vbo != 0)
     {
@@ -118,13 +156,15 @@ void Mesh::cleanup() {
 }
 
 void Mesh::swap_attributes(Mesh* other) {
-    this->m_vao         = other->m_vao;
-    this->m_vbo         = other->m_vbo;
-    this->m_ebo         = other->m_ebo;
-    this->m_index_count = other->m_index_count;
-
-    other->m_vao         = 0;
-    other->m_vbo         = 0;
-    other->m_ebo         = 0;
-    other->m_index_count = 0;
+    this->m_vao                     = other->m_vao;
+    this->m_vbo                     = other->m_vbo;
+    this->m_ebo                     = other->m_ebo;
+    this->m_has_instance_attributes = other->m_has_instance_attributes;
+    this->m_index_count             = other->m_index_count;
+
+    other->m_vao                     = 0;
+    other->m_vbo                     = 0;
+    other->m_ebo                     = 0;
+    other->m_has_instance_attributes = false;
+    other->m_index_count             = 0;
 }
\ No newline at end of file
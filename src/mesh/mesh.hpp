@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include <glad/glad.h>
 
@@ -8,6 +9,13 @@ struct VertexAttribute {
     size_t size;
 };
 
+// A per-instance attribute sourced from an instance buffer (divisor 1)
+struct InstanceAttribute {
+    GLuint  location;
+    GLint   size;
+    GLuint  offset;
+};
+
 class Mesh {
 public:
     Mesh(
@@ -34,11 +42,29 @@ public:
     void unbind() const;
     void draw() const;
 
+    // Draws 'instance_count' instances starting at 'base_instance' of the bound instance buffer
+    void draw_instanced(GLsizei instance_count, GLuint base_instance = 0) const;
+
+    /*
+        Declares the per-instance attributes of the VAO, sourced from vertex buffer binding 'binding'.
+        The format is stored in the VAO, so this only has to be done once.
+    */
+    void set_instance_attributes(GLuint binding, const std::vector<InstanceAttribute>& attributes);
+    bool has_instance_attributes() const;
+
+    /*
+        Points 'binding' at 'offset' of 'buffer', the mesh must be bound.
+        The buffer is owned by the caller.
+    */
+    void bind_instance_buffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride) const;
+
 private:
     GLuint m_vao;
     GLuint m_vbo;
     GLuint m_ebo;
 
+    bool m_has_instance_attributes;
+
     GLsizei m_index_count;
 
     void cleanup();
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <algorithm>
+#include "stream_buffer.hpp"
+
+namespace {
+    constexpr GLuint64 FENCE_WAIT_TIMEOUT_NS = 1'000'000;   // 1ms per attempt
+
+    constexpr GLbitfield PERSISTENT_MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+StreamBuffer::StreamBuffer(size_t region_size)
+    : m_buffer(0)
+    , m_region_size(0)
+    , m_region(0)
+    , m_persistent(GLAD_GL_VERSION_4_4 != 0)
+    , m_mapped(nullptr)
+    , m_fences{}
+    , m_stall_count(0)
+{
+    allocate(std::max<size_t>(region_size, 1));
+}
+
+StreamBuffer::~StreamBuffer() {
+    release();
+}
+
+std::byte* StreamBuffer::begin_write(size_t size) {
+    if (size > m_region_size)
+    {
+        auto new_size = m_region_size;
+
+        while (new_size < size)
+        {
+            new_size *= 2;
+        }
+
+        // The old buffer is freed once the GPU is done with it
+        release();
+        allocate(new_size);
+    }
+
+    if (!m_persistent)
+    {
+        m_staging.resize(std::max(m_staging.size(), size));
+
+        return m_staging.data();
+    }
+
+    m_region = (m_region + 1) % STREAM_BUFFER_REGION_COUNT;
+    wait_for_region(m_region);
+
+    return m_mapped + m_region * m_region_size;
+}
+
+void StreamBuffer::end_write(size_t size) {
+    // Coherent mapping, the writes are visible to the next draw call
+    if (m_persistent)
+    {
+        return;
+    }
+
+    // Orphan the old storage so the upload doesn't wait for the previous frame
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_region_size), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), m_staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::fence() {
+    if (!m_persistent)
+    {
+        return;
+    }
+
+    if (m_fences[m_region] != nullptr)
+    {
+        glDeleteSync(m_fences[m_region]);
+    }
+
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLuint StreamBuffer::id() const {
+    return m_buffer;
+}
+
+GLintptr StreamBuffer::offset() const {
+    return static_cast<GLintptr>(m_region * m_region_size);
+}
+
+size_t StreamBuffer::region_size() const {
+    return m_region_size;
+}
+
+bool StreamBuffer::is_persistent() const {
+    return m_persistent;
+}
+
+size_t StreamBuffer::stall_count() const {
+    return m_stall_count;
+}
+
+void StreamBuffer::allocate(size_t region_size) {
+    m_region_size = region_size;
+    m_region = 0;
+
+    glGenBuffers(1, &m_buffer);
+
+    if (m_buffer == 0)
+    {
+        std::cerr << "[StreamBuffer] ERROR: Failed to generate buffer" << "\n";
+
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    if (m_persistent)
+    {
+        const auto total_size = static_cast<GLsizeiptr>(m_region_size * STREAM_BUFFER_REGION_COUNT);
+
+        glBufferStorage(GL_ARRAY_BUFFER, total_size, nullptr, PERSISTENT_MAP_FLAGS);
+        m_mapped = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total_size, PERSISTENT_MAP_FLAGS));
+
+        if (m_mapped == nullptr)
+        {
+            std::cerr << "[StreamBuffer] WARNING: Persistent mapping failed, falling back to glBufferSubData" << "\n";
+
+            // glBufferStorage is immutable, so the buffer has to be recreated
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+            m_persistent = false;
+        }
+    }
+
+    if (!m_persistent)
+    {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_region_size), nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::release() {
+    for (auto& fence : m_fences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_buffer == 0)
+    {
+        return;
+    }
+
+    if (m_mapped != nullptr)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_mapped = nullptr;
+    }
+
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+}
+
+void StreamBuffer::wait_for_region(size_t region) {
+    auto& fence = m_fences[region];
+
+    if (fence == nullptr)
+    {
+        return;
+    }
+
+    // Poll first, only flush and block if the GPU hasn't caught up yet
+    GLbitfield flags = 0;
+    GLuint64 timeout = 0;
+
+    while (true)
+    {
+        const auto result = glClientWaitSync(fence, flags, timeout);
+
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+
+        if (result == GL_WAIT_FAILED)
+        {
+            std::cerr << "[StreamBuffer] ERROR: glClientWaitSync failed" << "\n";
+
+            break;
+        }
+
+        if (flags == 0)
+        {
+            m_stall_count++;
+        }
+
+        flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        timeout = FENCE_WAIT_TIMEOUT_NS;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
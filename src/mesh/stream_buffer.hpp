@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <glad/glad.h>
+
+constexpr size_t STREAM_BUFFER_REGION_COUNT = 3;
+
+/*
+    A buffer rewritten every frame, e.g. bullet and item instance data.
+
+    With GL 4.4+ the storage is created by glBufferStorage and mapped once, persistent and coherent.
+    It is split into three regions, each guarded by a fence, so the CPU writes frame N+1
+    while the GPU still reads frame N, and only waits when it gets three frames ahead.
+
+    Without glBufferStorage it falls back to orphaning with glBufferData + glBufferSubData.
+
+    Usage per frame:
+        auto dest = stream.begin_write(size);   // write up to 'size' bytes to 'dest'
+        stream.end_write(size);
+        ...draw from 'stream.id()' at 'stream.offset()'...
+        stream.fence();
+*/
+class StreamBuffer {
+public:
+    explicit StreamBuffer(size_t region_size);
+    ~StreamBuffer();
+
+    // Delete copy constructor and copy assignment operator
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Moves to the next region and waits until the GPU has finished reading it, grows the regions if needed
+    std::byte* begin_write(size_t size);
+
+    // Makes the written bytes visible to the GPU
+    void end_write(size_t size);
+
+    // Guards the current region, call after the last draw call reading it
+    void fence();
+
+    GLuint id() const;
+
+    // Offset of the current region in the buffer
+    GLintptr offset() const;
+
+    size_t region_size() const;
+    bool is_persistent() const;
+
+    // Number of times 'begin_write()' had to block on a fence
+    size_t stall_count() const;
+
+private:
+    void allocate(size_t region_size);
+    void release();
+    void wait_for_region(size_t region);
+
+    GLuint                                          m_buffer;
+    size_t                                          m_region_size;
+    size_t                                          m_region;
+
+    bool                                            m_persistent;
+    std::byte*                                      m_mapped;
+    std::array<GLsync, STREAM_BUFFER_REGION_COUNT>  m_fences;
+
+    // Only used by the fallback path
+    std::vector<std::byte>                          m_staging;
+
+    size_t                                          m_stall_count;
+};
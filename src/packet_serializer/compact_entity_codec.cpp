@@ -0,0 +1,616 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "compact_entity_codec.hpp"
+#include "../game_server/game_logic_constants.hpp"
+
+namespace {
+    constexpr float POSITION_LIMIT      = 256.0f;
+    constexpr float VELOCITY_LIMIT      = 32.0f;
+    constexpr float RADIUS_SCALE        = 256.0f;
+    constexpr float TWO_PI              = 6.28318530718f;
+    constexpr float PI                  = TWO_PI / 2.0f;
+
+    constexpr uint32_t QUANTIZED_ZERO   = 1u << 15;     // 0.0 in 'quantize_signed'
+    constexpr uint32_t MAX_VARINT_BYTES = 5;
+
+    // Per-type defaults, see the header
+    constexpr float ENEMY_DEFAULT_RADIUS    = game_logic_constants::ENEMY_RADIUS;
+    constexpr float BOSS_DEFAULT_RADIUS     = game_logic_constants::ENEMY_RADIUS;
+    constexpr float ITEM_DEFAULT_RADIUS     = 0.0f;
+    constexpr uint8_t BULLET_DEFAULT_STATE  = static_cast<uint8_t>(BulletState::Visible);
+
+    float bullet_default_radius(uint8_t owner) {
+        return owner == BULLET_OWNER_PLAYER
+            ? game_logic_constants::PLAYER_BULLET_RADIUS
+            : game_logic_constants::ENEMY_BULLET_RADIUS;
+    }
+
+    // [-limit, limit) to 16 bits, out of range values are clamped
+    uint32_t quantize_signed(float value, float limit) {
+        const auto scaled = std::lround((value + limit) * (65536.0f / (2.0f * limit)));
+
+        return static_cast<uint32_t>(std::clamp<long>(scaled, 0, 65535));
+    }
+
+    float dequantize_signed(uint32_t value, float limit) {
+        return static_cast<float>(value) * (2.0f * limit / 65536.0f) - limit;
+    }
+
+    uint32_t quantize_radius(float radius) {
+        return static_cast<uint32_t>(std::clamp<long>(std::lround(radius * RADIUS_SCALE), 0, 65535));
+    }
+
+    // Any angle to 16 bits over [-pi, pi)
+    uint32_t quantize_angle(float angle) {
+        const auto wrapped = angle - TWO_PI * std::floor((angle + PI) / TWO_PI);
+
+        return static_cast<uint32_t>(std::lround((wrapped + PI) * (65536.0f / TWO_PI))) & 0xFFFF;
+    }
+
+    float dequantize_angle(uint32_t value) {
+        return static_cast<float>(value) * (TWO_PI / 65536.0f) - PI;
+    }
+
+    // The angle elided for an entity moving with 'vel'
+    float default_angle(const Velocity2D& vel) {
+        return (vel.x == 0.0f && vel.y == 0.0f) ? 0.0f : std::atan2(vel.y, vel.x);
+    }
+
+    template <typename T>
+    const Velocity2D* previous_vel(const T* previous) {
+        return previous != nullptr ? &previous->vel : nullptr;
+    }
+
+    uint64_t bullet_kind(const BulletSnapshot& bullet) {
+        return static_cast<uint64_t>(bullet.name)
+             | static_cast<uint64_t>(bullet.flight_pattern) << 8
+             | static_cast<uint64_t>(bullet.owner) << 16
+             | static_cast<uint64_t>(bullet.damage) << 24;
+    }
+
+    uint64_t item_kind(const ItemSnapshot& item) {
+        return static_cast<uint64_t>(item.name)
+             | static_cast<uint64_t>(item.flight_pattern) << 8;
+    }
+}
+
+/*
+    Writer
+*/
+CompactEntityWriter::CompactEntityWriter(std::vector<std::byte>& out)
+    : m_out(out)
+    , m_bits(0)
+    , m_bit_count(0)
+    , m_previous_id(0)
+    , m_previous_kind(0)
+    , m_has_previous_kind(false)
+{}
+
+void CompactEntityWriter::write(const PlayerSnapshot& player, const PlayerSnapshot* /* previous */) {
+    write_id(player.id);
+
+    std::byte bytes[PLAYER_SNAPSHOT_SIZE];
+    memcpy(bytes, &player, PLAYER_SNAPSHOT_SIZE);
+
+    for (const auto byte : bytes)
+    {
+        write_bits(static_cast<uint32_t>(byte), 8);
+    }
+}
+
+void CompactEntityWriter::write(const EnemySnapshot& enemy, const EnemySnapshot* previous) {
+    write_id(enemy.id);
+    write_bits(enemy.name, 8);
+    write_bits(enemy.state, 8);
+    write_bits(enemy.attack_pattern, 8);
+    write_motion(enemy.pos, enemy.vel, enemy.radius, enemy.angle, ENEMY_DEFAULT_RADIUS, previous_vel(previous));
+    write_varint(enemy.health);
+}
+
+void CompactEntityWriter::write(const BossSnapshot& boss, const BossSnapshot* previous) {
+    write_id(boss.id);
+    write_bits(boss.name, 8);
+    write_bits(boss.state, 8);
+    write_bits(boss.attack_pattern, 8);
+    write_motion(boss.pos, boss.vel, boss.radius, boss.angle, BOSS_DEFAULT_RADIUS, previous_vel(previous));
+    write_varint(boss.health);
+    write_bits(boss.current_spell, 8);
+    write_bits(boss.phase, 8);
+}
+
+void CompactEntityWriter::write(const BulletSnapshot& bullet, const BulletSnapshot* previous) {
+    write_id(bullet.id);
+
+    // Bullets are spawned in volleys, so the kind rarely changes from one bullet to the next
+    const auto kind = bullet_kind(bullet);
+    const auto same_kind = m_has_previous_kind && kind == m_previous_kind;
+
+    write_bits(same_kind ? 1 : 0, 1);
+
+    if (!same_kind)
+    {
+        write_bits(bullet.name, 8);
+        write_bits(bullet.flight_pattern, 8);
+        write_bits(bullet.owner, 8);
+        write_varint(bullet.damage);
+
+        m_previous_kind = kind;
+        m_has_previous_kind = true;
+    }
+
+    const auto has_state = bullet.state != BULLET_DEFAULT_STATE;
+
+    write_bits(has_state ? 1 : 0, 1);
+
+    if (has_state)
+    {
+        write_bits(bullet.state, 8);
+    }
+
+    write_motion(bullet.pos, bullet.vel, bullet.radius, bullet.angle, bullet_default_radius(bullet.owner), previous_vel(previous));
+}
+
+void CompactEntityWriter::write(const ItemSnapshot& item, const ItemSnapshot* previous) {
+    write_id(item.id);
+
+    const auto kind = item_kind(item);
+    const auto same_kind = m_has_previous_kind && kind == m_previous_kind;
+
+    write_bits(same_kind ? 1 : 0, 1);
+
+    if (!same_kind)
+    {
+        write_bits(item.name, 8);
+        write_bits(item.flight_pattern, 8);
+
+        m_previous_kind = kind;
+        m_has_previous_kind = true;
+    }
+
+    write_bits(item.state, 8);
+    write_motion(item.pos, item.vel, item.radius, item.angle, ITEM_DEFAULT_RADIUS, previous_vel(previous));
+
+    uint32_t score_bits = 0;
+    memcpy(&score_bits, &item.score, sizeof(score_bits));
+
+    write_bits(score_bits, 32);
+}
+
+void CompactEntityWriter::finish() {
+    if (m_bit_count > 0)
+    {
+        m_out.push_back(static_cast<std::byte>(m_bits & 0xFF));
+    }
+
+    m_bits = 0;
+    m_bit_count = 0;
+}
+
+void CompactEntityWriter::write_bits(uint32_t value, uint32_t count) {
+    const auto mask = count == 32 ? 0xFFFFFFFFull : (1ull << count) - 1;
+
+    m_bits |= (static_cast<uint64_t>(value) & mask) << m_bit_count;
+    m_bit_count += count;
+
+    while (m_bit_count >= 8)
+    {
+        m_out.push_back(static_cast<std::byte>(m_bits & 0xFF));
+        m_bits >>= 8;
+        m_bit_count -= 8;
+    }
+}
+
+void CompactEntityWriter::write_varint(uint32_t value) {
+    while (value >= 0x80)
+    {
+        write_bits((value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+
+    write_bits(value, 8);
+}
+
+void CompactEntityWriter::write_id(uint32_t id) {
+    // Zigzag, so ids slightly below the previous one stay short as well
+    const auto difference = static_cast<int32_t>(id - m_previous_id);
+    const auto zigzag = (static_cast<uint32_t>(difference) << 1) ^ static_cast<uint32_t>(difference >> 31);
+
+    write_varint(zigzag);
+    m_previous_id = id;
+}
+
+void CompactEntityWriter::write_count(uint32_t count) {
+    write_varint(count);
+}
+
+void CompactEntityWriter::write_motion(
+    const Position2D& pos,
+    const Velocity2D& vel,
+    float radius,
+    float angle,
+    float default_radius,
+    const Velocity2D* previous_vel
+) {
+    const auto vel_x = quantize_signed(vel.x, VELOCITY_LIMIT);
+    const auto vel_y = quantize_signed(vel.y, VELOCITY_LIMIT);
+    const auto has_vel = vel_x != QUANTIZED_ZERO || vel_y != QUANTIZED_ZERO;
+
+    // The client holds the baseline entity as decoded from the same quantization
+    const auto same_vel = has_vel && previous_vel != nullptr
+        && vel_x == quantize_signed(previous_vel->x, VELOCITY_LIMIT)
+        && vel_y == quantize_signed(previous_vel->y, VELOCITY_LIMIT);
+
+    const auto quantized_radius = quantize_radius(radius);
+    const auto has_radius = quantized_radius != quantize_radius(default_radius);
+
+    // Compared against what the reader derives from the quantized velocity
+    const auto decoded_vel = Velocity2D{ dequantize_signed(vel_x, VELOCITY_LIMIT), dequantize_signed(vel_y, VELOCITY_LIMIT) };
+    const auto angle_error = std::remainder(angle - default_angle(decoded_vel), TWO_PI);
+    const auto has_angle = std::fabs(angle_error) > ANGLE_ELISION_TOLERANCE;
+
+    write_bits((has_vel ? 1u : 0u) | (has_radius ? 2u : 0u) | (has_angle ? 4u : 0u), 3);
+
+    write_bits(quantize_signed(pos.x, POSITION_LIMIT), 16);
+    write_bits(quantize_signed(pos.y, POSITION_LIMIT), 16);
+
+    if (has_vel)
+    {
+        write_bits(same_vel ? 1 : 0, 1);
+
+        if (!same_vel)
+        {
+            write_bits(vel_x, 16);
+            write_bits(vel_y, 16);
+        }
+    }
+
+    if (has_radius)
+    {
+        write_bits(quantized_radius, 16);
+    }
+
+    if (has_angle)
+    {
+        write_bits(quantize_angle(angle), 16);
+    }
+}
+
+/*
+    Reader
+*/
+CompactEntityReader::CompactEntityReader(const std::byte* bytes, size_t size)
+    : m_bytes(bytes)
+    , m_size(size)
+    , m_bit_offset(0)
+    , m_previous_id(0)
+    , m_previous_kind(0)
+    , m_has_previous_kind(false)
+{}
+
+bool CompactEntityReader::read(PlayerSnapshot& player, const PlayerSnapshot* /* previous */) {
+    uint32_t id = 0;
+
+    if (!read_id(id))
+    {
+        return false;
+    }
+
+    std::byte bytes[PLAYER_SNAPSHOT_SIZE];
+
+    for (auto& byte : bytes)
+    {
+        uint32_t value = 0;
+
+        if (!read_bits(8, value))
+        {
+            return false;
+        }
+
+        byte = static_cast<std::byte>(value);
+    }
+
+    memcpy(&player, bytes, PLAYER_SNAPSHOT_SIZE);
+
+    return true;
+}
+
+bool CompactEntityReader::read(EnemySnapshot& enemy, const EnemySnapshot* previous) {
+    uint32_t id = 0, name = 0, state = 0, attack_pattern = 0;
+
+    auto result = read_id(id)
+               && read_bits(8, name)
+               && read_bits(8, state)
+               && read_bits(8, attack_pattern)
+               && read_motion(enemy.pos, enemy.vel, enemy.radius, enemy.angle, ENEMY_DEFAULT_RADIUS, previous_vel(previous))
+               && read_varint(enemy.health);
+
+    enemy.id                = static_cast<uint8_t>(id);
+    enemy.name              = static_cast<uint8_t>(name);
+    enemy.state             = static_cast<uint8_t>(state);
+    enemy.attack_pattern    = static_cast<uint8_t>(attack_pattern);
+
+    return result;
+}
+
+bool CompactEntityReader::read(BossSnapshot& boss, const BossSnapshot* previous) {
+    uint32_t id = 0, name = 0, state = 0, attack_pattern = 0, current_spell = 0, phase = 0;
+
+    auto result = read_id(id)
+               && read_bits(8, name)
+               && read_bits(8, state)
+               && read_bits(8, attack_pattern)
+               && read_motion(boss.pos, boss.vel, boss.radius, boss.angle, BOSS_DEFAULT_RADIUS, previous_vel(previous))
+               && read_varint(boss.health)
+               && read_bits(8, current_spell)
+               && read_bits(8, phase);
+
+    boss.id                 = static_cast<uint8_t>(id);
+    boss.name               = static_cast<uint8_t>(name);
+    boss.state              = static_cast<uint8_t>(state);
+    boss.attack_pattern     = static_cast<uint8_t>(attack_pattern);
+    boss.current_spell      = static_cast<uint8_t>(current_spell);
+    boss.phase              = static_cast<uint8_t>(phase);
+    boss.reserved_01        = 0;
+    boss.reserved_02        = 0;
+
+    return result;
+}
+
+bool CompactEntityReader::read(BulletSnapshot& bullet, const BulletSnapshot* previous) {
+    uint32_t same_kind = 0;
+
+    if (!read_id(bullet.id) || !read_bits(1, same_kind))
+    {
+        return false;
+    }
+
+    if (same_kind == 0)
+    {
+        uint32_t name = 0, flight_pattern = 0, owner = 0, damage = 0;
+
+        if (!read_bits(8, name) || !read_bits(8, flight_pattern) || !read_bits(8, owner) || !read_varint(damage))
+        {
+            return false;
+        }
+
+        bullet.name             = static_cast<uint8_t>(name);
+        bullet.flight_pattern   = static_cast<uint8_t>(flight_pattern);
+        bullet.owner            = static_cast<uint8_t>(owner);
+        bullet.damage           = damage;
+
+        m_previous_kind = bullet_kind(bullet);
+        m_has_previous_kind = true;
+    }
+    else if (m_has_previous_kind)
+    {
+        bullet.name             = static_cast<uint8_t>(m_previous_kind & 0xFF);
+        bullet.flight_pattern   = static_cast<uint8_t>((m_previous_kind >> 8) & 0xFF);
+        bullet.owner            = static_cast<uint8_t>((m_previous_kind >> 16) & 0xFF);
+        bullet.damage           = static_cast<uint32_t>(m_previous_kind >> 24);
+    }
+    else
+    {
+        // Nothing to repeat yet
+        return false;
+    }
+
+    uint32_t has_state = 0, state = BULLET_DEFAULT_STATE;
+
+    if (!read_bits(1, has_state) || (has_state != 0 && !read_bits(8, state)))
+    {
+        return false;
+    }
+
+    bullet.state = static_cast<uint8_t>(state);
+
+    return read_motion(bullet.pos, bullet.vel, bullet.radius, bullet.angle, bullet_default_radius(bullet.owner), previous_vel(previous));
+}
+
+bool CompactEntityReader::read(ItemSnapshot& item, const ItemSnapshot* previous) {
+    uint32_t id = 0, same_kind = 0;
+
+    if (!read_id(id) || !read_bits(1, same_kind))
+    {
+        return false;
+    }
+
+    item.id = static_cast<uint8_t>(id);
+
+    if (same_kind == 0)
+    {
+        uint32_t name = 0, flight_pattern = 0;
+
+        if (!read_bits(8, name) || !read_bits(8, flight_pattern))
+        {
+            return false;
+        }
+
+        item.name           = static_cast<uint8_t>(name);
+        item.flight_pattern = static_cast<uint8_t>(flight_pattern);
+
+        m_previous_kind = item_kind(item);
+        m_has_previous_kind = true;
+    }
+    else if (m_has_previous_kind)
+    {
+        item.name           = static_cast<uint8_t>(m_previous_kind & 0xFF);
+        item.flight_pattern = static_cast<uint8_t>((m_previous_kind >> 8) & 0xFF);
+    }
+    else
+    {
+        return false;
+    }
+
+    uint32_t state = 0, score_bits = 0;
+
+    auto result = read_bits(8, state)
+               && read_motion(item.pos, item.vel, item.radius, item.angle, ITEM_DEFAULT_RADIUS, previous_vel(previous))
+               && read_bits(32, score_bits);
+
+    item.state = static_cast<uint8_t>(state);
+    memcpy(&item.score, &score_bits, sizeof(score_bits));
+
+    return result;
+}
+
+size_t CompactEntityReader::consumed() const {
+    return (m_bit_offset + 7) / 8;
+}
+
+bool CompactEntityReader::read_bits(uint32_t count, uint32_t& value) {
+    if (m_size * 8 - m_bit_offset < count)
+    {
+        return false;
+    }
+
+    value = 0;
+
+    uint32_t done = 0;
+
+    while (done < count)
+    {
+        const auto byte = static_cast<uint32_t>(m_bytes[m_bit_offset / 8]);
+        const auto shift = static_cast<uint32_t>(m_bit_offset % 8);
+        const auto take = std::min(8 - shift, count - done);
+
+        value |= ((byte >> shift) & ((1u << take) - 1)) << done;
+
+        done += take;
+        m_bit_offset += take;
+    }
+
+    return true;
+}
+
+bool CompactEntityReader::read_varint(uint32_t& value) {
+    value = 0;
+
+    for (uint32_t i = 0; i < MAX_VARINT_BYTES; i++)
+    {
+        uint32_t byte = 0;
+
+        if (!read_bits(8, byte))
+        {
+            return false;
+        }
+
+        value |= (byte & 0x7F) << (7 * i);
+
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CompactEntityReader::read_id(uint32_t& id) {
+    uint32_t zigzag = 0;
+
+    if (!read_varint(zigzag))
+    {
+        return false;
+    }
+
+    const auto difference = (zigzag >> 1) ^ (0u - (zigzag & 1));
+
+    id = m_previous_id + difference;
+    m_previous_id = id;
+
+    return true;
+}
+
+bool CompactEntityReader::read_count(uint32_t& count) {
+    return read_varint(count);
+}
+
+bool CompactEntityReader::peek_id(uint32_t& id) {
+    const auto bit_offset = m_bit_offset;
+    const auto previous_id = m_previous_id;
+
+    const auto result = read_id(id);
+
+    m_bit_offset = bit_offset;
+    m_previous_id = previous_id;
+
+    return result;
+}
+
+bool CompactEntityReader::read_motion(
+    Position2D& pos,
+    Velocity2D& vel,
+    float& radius,
+    float& angle,
+    float default_radius,
+    const Velocity2D* previous_vel
+) {
+    uint32_t flags = 0, pos_x = 0, pos_y = 0;
+
+    if (!read_bits(3, flags) || !read_bits(16, pos_x) || !read_bits(16, pos_y))
+    {
+        return false;
+    }
+
+    pos = { dequantize_signed(pos_x, POSITION_LIMIT), dequantize_signed(pos_y, POSITION_LIMIT) };
+    vel = { 0.0f, 0.0f };
+    radius = default_radius;
+
+    if ((flags & 1) != 0)
+    {
+        uint32_t same_vel = 0, vel_x = 0, vel_y = 0;
+
+        if (!read_bits(1, same_vel))
+        {
+            return false;
+        }
+
+        if (same_vel != 0)
+        {
+            if (previous_vel == nullptr)
+            {
+                return false;
+            }
+
+            vel = *previous_vel;
+        }
+        else
+        {
+            if (!read_bits(16, vel_x) || !read_bits(16, vel_y))
+            {
+                return false;
+            }
+
+            vel = { dequantize_signed(vel_x, VELOCITY_LIMIT), dequantize_signed(vel_y, VELOCITY_LIMIT) };
+        }
+    }
+
+    if ((flags & 2) != 0)
+    {
+        uint32_t quantized_radius = 0;
+
+        if (!read_bits(16, quantized_radius))
+        {
+            return false;
+        }
+
+        radius = static_cast<float>(quantized_radius) / RADIUS_SCALE;
+    }
+
+    angle = default_angle(vel);
+
+    if ((flags & 4) != 0)
+    {
+        uint32_t quantized_angle = 0;
+
+        if (!read_bits(16, quantized_angle))
+        {
+            return false;
+        }
+
+        angle = dequantize_angle(quantized_angle);
+    }
+
+    return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "../packet_template/frame.hpp"
+
+/*
+    Entity records of FrameEncoding::Compact
+
+    The entities of one section (e.g. the upserts of the bullets) form a single bit stream,
+    least significant bit first, padded to a whole byte after the last entity.
+
+        id                  Zigzag varint of the difference to the previous id in the section
+        pos                 16 bit fixed point per axis over [-256, 256), 1/128 px
+        vel                 16 bit fixed point per axis over [-32, 32), 1/1024 px per tick
+        radius              16 bit fixed point over [0, 256), 1/256 px
+        angle               16 bit over a full turn
+        enum fields         8 bit, health and damage as varints
+
+    Fields equal to the per-type default are replaced by a presence bit:
+        vel                 Zero, or the velocity of the entity in the delta baseline
+        radius              The radius of the type (bullets by owner)
+        bullet state        BulletState::Visible
+        angle               The direction of 'vel' (within ANGLE_ELISION_TOLERANCE),
+                            or zero for entities at rest
+        bullet kind         name, flight_pattern, owner and damage of the previous bullet
+        item kind           name and flight_pattern of the previous item
+
+    Players are written in full after their id. The client replays its pending inputs from
+    the player position (PlayerPredictor), quantizing it would show up as a jitter of the local player.
+*/
+constexpr float ANGLE_ELISION_TOLERANCE = 0.002f;   // Radians, about 0.1 degrees
+
+class CompactEntityWriter {
+public:
+    explicit CompactEntityWriter(std::vector<std::byte>& out);
+
+    // 'previous' is the entity in the delta baseline, if any
+    void write(const PlayerSnapshot& player, const PlayerSnapshot* previous = nullptr);
+    void write(const EnemySnapshot& enemy, const EnemySnapshot* previous = nullptr);
+    void write(const BossSnapshot& boss, const BossSnapshot* previous = nullptr);
+    void write(const BulletSnapshot& bullet, const BulletSnapshot* previous = nullptr);
+    void write(const ItemSnapshot& item, const ItemSnapshot* previous = nullptr);
+
+    // Ids of removed entities, ascending ids take a byte each
+    void write_id(uint32_t id);
+
+    // Varint, for the entity counts in front of the records
+    void write_count(uint32_t count);
+
+    // Pads the stream to a whole byte, call after the last entity of the section
+    void finish();
+
+private:
+    void write_bits(uint32_t value, uint32_t count);
+    void write_varint(uint32_t value);
+    void write_motion(
+        const Position2D& pos,
+        const Velocity2D& vel,
+        float radius,
+        float angle,
+        float default_radius,
+        const Velocity2D* previous_vel
+    );
+
+    std::vector<std::byte>&     m_out;
+    uint64_t                    m_bits;
+    uint32_t                    m_bit_count;
+
+    uint32_t                    m_previous_id;
+    uint64_t                    m_previous_kind;
+    bool                        m_has_previous_kind;
+};
+
+/*
+    Bounds checked reader of the records written by CompactEntityWriter.
+    Every read returns false once the stream runs out.
+*/
+class CompactEntityReader {
+public:
+    CompactEntityReader(const std::byte* bytes, size_t size);
+
+    /*
+        'previous' must be the baseline entity with the id returned by 'peek_id()',
+        a record that refers to a missing baseline entity is rejected
+    */
+    bool read(PlayerSnapshot& player, const PlayerSnapshot* previous = nullptr);
+    bool read(EnemySnapshot& enemy, const EnemySnapshot* previous = nullptr);
+    bool read(BossSnapshot& boss, const BossSnapshot* previous = nullptr);
+    bool read(BulletSnapshot& bullet, const BulletSnapshot* previous = nullptr);
+    bool read(ItemSnapshot& item, const ItemSnapshot* previous = nullptr);
+    bool read_id(uint32_t& id);
+    bool read_count(uint32_t& count);
+
+    // The id of the next record, without consuming it
+    bool peek_id(uint32_t& id);
+
+    // Bytes used by the section so far, including the padding
+    size_t consumed() const;
+
+private:
+    bool read_bits(uint32_t count, uint32_t& value);
+    bool read_varint(uint32_t& value);
+    bool read_motion(
+        Position2D& pos,
+        Velocity2D& vel,
+        float& radius,
+        float& angle,
+        float default_radius,
+        const Velocity2D* previous_vel
+    );
+
+    const std::byte*            m_bytes;
+    size_t                      m_size;
+    size_t                      m_bit_offset;
+
+    uint32_t                    m_previous_id;
+    uint64_t                    m_previous_kind;
+    bool                        m_has_previous_kind;
+};
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <cstring>
+#include "datagram_serializer.hpp"
+#include "input_serializer.hpp"
+
+/*
+    Serializer
+*/
+void serialize_datagram_header_into(const DatagramHeader& header, std::byte* dest) {
+    std::memcpy(dest, &header, DATAGRAM_HEADER_SIZE);
+}
+
+void serialize_input_bundle_into(const std::deque<ClientInput>& inputs, std::vector<std::byte>& out) {
+    out.push_back(static_cast<std::byte>(inputs.size()));
+
+    for (const auto& input : inputs)
+    {
+        // Reserve the size field and fill it in once the input is written
+        const auto size_offset = out.size();
+        out.resize(size_offset + sizeof(uint16_t));
+
+        serialize_client_input_into(input, out);
+
+        const auto input_size = static_cast<uint16_t>(out.size() - size_offset - sizeof(uint16_t));
+        std::memcpy(out.data() + size_offset, &input_size, sizeof(uint16_t));
+    }
+}
+
+/*
+    Deserializer
+*/
+std::optional<DatagramHeader> deserialize_datagram_header(const std::byte* buffer, size_t size) {
+    if (size < DATAGRAM_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+
+    DatagramHeader header;
+    std::memcpy(&header, buffer, DATAGRAM_HEADER_SIZE);
+
+    if (header.magic_number != DATAGRAM_MAGIC_NUMBER)
+    {
+        return std::nullopt;
+    }
+
+    return header;
+}
+
+bool deserialize_input_bundle(const std::byte* buffer, size_t size, std::vector<ClientInput>& inputs) {
+    if (size < 1)
+    {
+        return false;
+    }
+
+    const auto count = std::to_integer<uint8_t>(buffer[0]);
+    size_t offset = 1;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t input_size = 0;
+
+        if (size - offset < sizeof(uint16_t))
+        {
+            return false;
+        }
+
+        std::memcpy(&input_size, buffer + offset, sizeof(uint16_t));
+        offset += sizeof(uint16_t);
+
+        if (size - offset < input_size)
+        {
+            return false;
+        }
+
+        const auto input = deserialize_client_input(buffer + offset, input_size);
+
+        if (!input.has_value())
+        {
+            return false;
+        }
+
+        inputs.push_back(input.value());
+        offset += input_size;
+    }
+
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include "../packet_template/header.hpp"
+#include "../packet_template/datagram.hpp"
+#include "../packet_template/input.hpp"
+
+/*
+    Datagram payloads
+
+    Input:      [uint8 count]([uint16 size][ClientInput])* n       Oldest first
+    Frame:      [PayloadType (uint32)][FrameSnapshot or FrameDelta] Split into fragments
+    FrameAck:   [ClientFrameAck]
+    Bind:       Empty
+*/
+
+/*
+    Serializer
+*/
+// Writes DATAGRAM_HEADER_SIZE bytes to 'dest'
+void serialize_datagram_header_into(const DatagramHeader& header, std::byte* dest);
+
+void serialize_input_bundle_into(const std::deque<ClientInput>& inputs, std::vector<std::byte>& out);
+
+/*
+    Deserializer
+*/
+std::optional<DatagramHeader> deserialize_datagram_header(const std::byte* buffer, size_t size);
+
+// Appends the inputs to 'inputs', returns false if the bundle is malformed
+bool deserialize_input_bundle(const std::byte* buffer, size_t size, std::vector<ClientInput>& inputs);
@@ -0,0 +1,576 @@
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include "frame_delta_serializer.hpp"
+#include "compact_entity_codec.hpp"
+
+namespace {
+    void append_bytes(std::vector<std::byte>& out, const void* src, size_t size) {
+        const auto offset = out.size();
+
+        out.resize(offset + size);
+        memcpy(out.data() + offset, src, size);
+    }
+
+    /*
+        Bounds checked cursor over the received payload
+    */
+    struct ByteReader {
+        const std::byte*    bytes;
+        size_t              size;
+        size_t              offset;
+
+        size_t remaining() const {
+            return size - offset;
+        }
+
+        bool read(void* dest, size_t count) {
+            if (remaining() < count)
+            {
+                return false;
+            }
+
+            memcpy(dest, bytes + offset, count);
+            offset += count;
+
+            return true;
+        }
+    };
+
+    /*
+        Baseline entities sorted by id.
+        Kept per thread and per entity type, so encoding does not allocate once warmed up.
+    */
+    struct BaselineEntry {
+        uint32_t    id;
+        uint32_t    index;
+        bool        kept;
+    };
+
+    constexpr uint32_t NO_BASELINE_ENTITY = UINT32_MAX;
+
+    // (id, index in the baseline) sorted by id, the decoder's lookup
+    using IdIndex = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    template <typename T>
+    void build_id_index(const std::vector<T>& baseline, IdIndex& index) {
+        index.clear();
+
+        for (size_t i = 0; i < baseline.size(); i++)
+        {
+            index.emplace_back(static_cast<uint32_t>(baseline[i].id), static_cast<uint32_t>(i));
+        }
+
+        std::sort(index.begin(), index.end());
+    }
+
+    uint32_t find_slot(const IdIndex& index, uint32_t id) {
+        const auto it = std::lower_bound(index.begin(), index.end(), std::make_pair(id, uint32_t{0}));
+
+        return (it != index.end() && it->first == id) ? it->second : NO_BASELINE_ENTITY;
+    }
+
+    /*
+        Bit stream of [removed count][upsert count][removed ids (ascending)][upserts],
+        see CompactEntityWriter
+    */
+    template <typename T>
+    void encode_compact_section(
+        const std::vector<T>& baseline,
+        const std::vector<BaselineEntry>& baseline_index,
+        const std::vector<std::pair<const T*, uint32_t>>& upserts,
+        std::vector<std::byte>& out
+    ) {
+        const auto removed_count = std::count_if(baseline_index.begin(), baseline_index.end(), [](const BaselineEntry& entry) {
+            return !entry.kept;
+        });
+
+        CompactEntityWriter writer(out);
+
+        writer.write_count(static_cast<uint32_t>(removed_count));
+        writer.write_count(static_cast<uint32_t>(upserts.size()));
+
+        for (const auto& entry : baseline_index)
+        {
+            if (!entry.kept)
+            {
+                writer.write_id(entry.id);
+            }
+        }
+
+        for (const auto& [entity, baseline_slot] : upserts)
+        {
+            writer.write(*entity, baseline_slot != NO_BASELINE_ENTITY ? &baseline[baseline_slot] : nullptr);
+        }
+
+        writer.finish();
+    }
+
+    /*
+        Returns false without writing anything if 'match_ids' is set and an id repeats in
+        'baseline' or 'current', the decoder could not tell those entities apart.
+    */
+    template <typename T>
+    bool encode_entities(const std::vector<T>& baseline, const std::vector<T>& current, std::vector<std::byte>& out, FrameEncoding encoding, bool match_ids) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        thread_local std::vector<BaselineEntry> baseline_index;
+        thread_local std::vector<std::pair<const T*, uint32_t>> upserts;    // (entity, index in the baseline)
+        thread_local std::vector<uint32_t> new_ids;
+
+        baseline_index.clear();
+        upserts.clear();
+        new_ids.clear();
+
+        for (size_t i = 0; i < baseline.size(); i++)
+        {
+            baseline_index.push_back({ static_cast<uint32_t>(baseline[i].id), static_cast<uint32_t>(i), false });
+        }
+
+        std::sort(baseline_index.begin(), baseline_index.end(), [](const BaselineEntry& a, const BaselineEntry& b) {
+            return a.id < b.id;
+        });
+
+        const auto same_id = [](const BaselineEntry& a, const BaselineEntry& b) {
+            return a.id == b.id;
+        };
+
+        if (match_ids && std::adjacent_find(baseline_index.begin(), baseline_index.end(), same_id) != baseline_index.end())
+        {
+            return false;
+        }
+
+        for (const auto& entity : current)
+        {
+            const auto id = static_cast<uint32_t>(entity.id);
+
+            auto it = std::lower_bound(baseline_index.begin(), baseline_index.end(), id, [](const BaselineEntry& entry, uint32_t value) {
+                return entry.id < value;
+            });
+
+            if (it == baseline_index.end() || it->id != id)
+            {
+                upserts.emplace_back(&entity, NO_BASELINE_ENTITY);
+                new_ids.push_back(id);
+
+                continue;
+            }
+
+            // A second entity with the id of a kept one
+            if (match_ids && it->kept)
+            {
+                return false;
+            }
+
+            it->kept = true;
+
+            if (memcmp(&baseline[it->index], &entity, sizeof(T)) != 0)
+            {
+                upserts.emplace_back(&entity, it->index);
+            }
+        }
+
+        if (match_ids)
+        {
+            std::sort(new_ids.begin(), new_ids.end());
+
+            if (std::adjacent_find(new_ids.begin(), new_ids.end()) != new_ids.end())
+            {
+                return false;
+            }
+        }
+
+        if (encoding == FrameEncoding::Compact)
+        {
+            encode_compact_section(baseline, baseline_index, upserts, out);
+
+            return true;
+        }
+
+        // Removed entities
+        const auto removed_count_offset = out.size();
+        uint32_t removed_count = 0;
+
+        append_bytes(out, &removed_count, sizeof(removed_count));
+
+        for (const auto& entry : baseline_index)
+        {
+            if (!entry.kept)
+            {
+                append_bytes(out, &entry.id, sizeof(entry.id));
+                removed_count++;
+            }
+        }
+
+        memcpy(out.data() + removed_count_offset, &removed_count, sizeof(removed_count));
+
+        // New and changed entities
+        const auto upsert_count = static_cast<uint32_t>(upserts.size());
+
+        append_bytes(out, &upsert_count, sizeof(upsert_count));
+
+        for (const auto& upsert : upserts)
+        {
+            append_bytes(out, upsert.first, sizeof(T));
+        }
+
+        return true;
+    }
+
+    // Reads the removed ids and the upserts of one section
+    template <typename T>
+    bool read_full_section(ByteReader& reader, std::vector<uint32_t>& removed_ids, std::vector<T>& upserts) {
+        uint32_t removed_count = 0;
+
+        if (!reader.read(&removed_count, sizeof(removed_count)))
+        {
+            return false;
+        }
+
+        // Validate the count against the payload before looping over it
+        if (reader.remaining() / sizeof(uint32_t) < removed_count)
+        {
+            return false;
+        }
+
+        removed_ids.resize(removed_count);
+        reader.read(removed_ids.data(), removed_count * sizeof(uint32_t));
+
+        uint32_t upsert_count = 0;
+
+        if (!reader.read(&upsert_count, sizeof(upsert_count)))
+        {
+            return false;
+        }
+
+        if (reader.remaining() / sizeof(T) < upsert_count)
+        {
+            return false;
+        }
+
+        upserts.resize(upsert_count);
+        reader.read(upserts.data(), upsert_count * sizeof(T));
+
+        return true;
+    }
+
+    template <typename T>
+    bool read_compact_section(
+        const std::vector<T>& baseline,
+        const IdIndex& index,
+        ByteReader& reader,
+        std::vector<uint32_t>& removed_ids,
+        std::vector<T>& upserts
+    ) {
+        CompactEntityReader compact(reader.bytes + reader.offset, reader.remaining());
+
+        uint32_t removed_count = 0;
+        uint32_t upsert_count = 0;
+
+        if (!compact.read_count(removed_count) || !compact.read_count(upsert_count))
+        {
+            return false;
+        }
+
+        // Every record takes at least a byte
+        if (reader.remaining() < static_cast<uint64_t>(removed_count) + upsert_count)
+        {
+            return false;
+        }
+
+        removed_ids.resize(removed_count);
+        upserts.resize(upsert_count);
+
+        for (auto& id : removed_ids)
+        {
+            if (!compact.read_id(id))
+            {
+                return false;
+            }
+        }
+
+        for (auto& entity : upserts)
+        {
+            uint32_t id = 0;
+
+            if (!compact.peek_id(id))
+            {
+                return false;
+            }
+
+            const auto slot = find_slot(index, id);
+            const T* previous = slot != NO_BASELINE_ENTITY ? &baseline[slot] : nullptr;
+
+            if (!compact.read(entity, previous))
+            {
+                return false;
+            }
+        }
+
+        reader.offset += compact.consumed();
+
+        return true;
+    }
+
+    /*
+        Applies one section to the baseline entities.
+        The scratch containers are kept per thread and per entity type and 'result' keeps
+        its capacity, so decoding does not allocate once warmed up.
+    */
+    template <typename T>
+    bool decode_entities(const std::vector<T>& baseline, ByteReader& reader, std::vector<T>& result, uint32_t& result_count, FrameEncoding encoding) {
+        thread_local IdIndex index;
+        thread_local std::vector<uint32_t> removed_ids;
+        thread_local std::vector<T> upserts;
+        thread_local std::vector<bool> removed;
+
+        build_id_index(baseline, index);
+
+        // Compact records may refer to their baseline entity
+        const auto read_result = encoding == FrameEncoding::Compact
+            ? read_compact_section(baseline, index, reader, removed_ids, upserts)
+            : read_full_section(reader, removed_ids, upserts);
+
+        if (!read_result)
+        {
+            return false;
+        }
+
+        result.assign(baseline.begin(), baseline.end());
+        removed.assign(result.size(), false);
+
+        // Removed entities
+        for (const auto id : removed_ids)
+        {
+            const auto slot = find_slot(index, id);
+
+            if (slot != NO_BASELINE_ENTITY)
+            {
+                removed[slot] = true;
+            }
+        }
+
+        // New and changed entities
+        for (const auto& entity : upserts)
+        {
+            const auto slot = find_slot(index, static_cast<uint32_t>(entity.id));
+
+            if (slot != NO_BASELINE_ENTITY && !removed[slot])
+            {
+                result[slot] = entity;
+            }
+            else
+            {
+                result.push_back(entity);
+                removed.push_back(false);
+            }
+        }
+
+        // Compact the removed entities away while keeping the order
+        size_t write = 0;
+
+        for (size_t read = 0; read < result.size(); read++)
+        {
+            if (!removed[read])
+            {
+                result[write++] = result[read];
+            }
+        }
+
+        result.resize(write);
+        result_count = static_cast<uint32_t>(result.size());
+
+        return true;
+    }
+    bool validate_counts(const FrameSnapshot& frame, const char* caller) {
+        auto player_count_validation = frame.player_count != frame.player_vector.size();
+        auto enemy_count_validation = frame.enemy_count != frame.enemy_vector.size();
+        auto boss_count_validation = frame.boss_count != frame.boss_vector.size();
+        auto bullet_count_validation = frame.bullet_count != frame.bullet_vector.size();
+        auto item_count_validation = frame.item_count != frame.item_vector.size();
+
+        // Check if the number of objects and actual size of objects are same
+        if (player_count_validation || enemy_count_validation || boss_count_validation ||
+            bullet_count_validation || item_count_validation)
+        {
+            std::cerr << "[" << caller << "] Failed to serialize frame" << "\n";
+            std::cerr << "[" << caller << "] The number of objects and the size of objects does not match" << "\n";
+
+            return false;
+        }
+
+        return true;
+    }
+
+    // Keyframes don't match ids, every entity is new to the empty baseline
+    bool encode_frame_body(const FrameSnapshot& baseline, const FrameSnapshot& frame, std::vector<std::byte>& out, FrameEncoding encoding, bool match_ids) {
+        // The fixed header and the stage are always sent in full
+        append_bytes(out, &frame, FRAME_SNAPSHOT_FIXED_HEADER_SIZE);
+        append_bytes(out, &frame.stage, STAGE_SNAPSHOT_SIZE);
+
+        return encode_entities(baseline.player_vector, frame.player_vector, out, encoding, match_ids)
+            && encode_entities(baseline.enemy_vector,  frame.enemy_vector,  out, encoding, match_ids)
+            && encode_entities(baseline.boss_vector,   frame.boss_vector,   out, encoding, match_ids)
+            && encode_entities(baseline.bullet_vector, frame.bullet_vector, out, encoding, match_ids)
+            && encode_entities(baseline.item_vector,   frame.item_vector,   out, encoding, match_ids);
+    }
+
+    bool decode_frame_body(const FrameSnapshot& baseline, ByteReader& reader, FrameSnapshot& frame, FrameEncoding encoding) {
+        // Copy the fixed area of the frame object
+        auto header_result = reader.read(&frame.client_id,   sizeof(frame.client_id))
+                          && reader.read(&frame.opponent_id, sizeof(frame.opponent_id))
+                          && reader.read(&frame.timestamp,   sizeof(frame.timestamp))
+                          && reader.read(&frame.score,       sizeof(frame.score))
+                          && reader.read(&frame.mode,        sizeof(frame.mode))
+                          && reader.read(&frame.variant,     sizeof(frame.variant))
+                          && reader.read(&frame.difficulty,  sizeof(frame.difficulty))
+                          && reader.read(&frame.state,       sizeof(frame.state))
+                          && reader.read(&frame.last_input_sequence, sizeof(frame.last_input_sequence))
+                          && reader.read(&frame.stage,       STAGE_SNAPSHOT_SIZE);
+
+        if (!header_result)
+        {
+            return false;
+        }
+
+        return decode_entities(baseline.player_vector, reader, frame.player_vector, frame.player_count, encoding)
+            && decode_entities(baseline.enemy_vector,  reader, frame.enemy_vector,  frame.enemy_count,  encoding)
+            && decode_entities(baseline.boss_vector,   reader, frame.boss_vector,   frame.boss_count,   encoding)
+            && decode_entities(baseline.bullet_vector, reader, frame.bullet_vector, frame.bullet_count, encoding)
+            && decode_entities(baseline.item_vector,   reader, frame.item_vector,   frame.item_count,   encoding);
+    }
+}
+
+/*
+    Serializer
+*/
+std::optional<std::vector<std::byte>> serialize_frame_delta(const FrameSnapshot& baseline, const FrameSnapshot& frame, FrameEncoding encoding) {
+    std::vector<std::byte> bytes;
+    bytes.reserve(sizeof(uint32_t) + FRAME_SNAPSHOT_FIXED_HEADER_SIZE + STAGE_SNAPSHOT_SIZE + 10 * sizeof(uint32_t));
+
+    if (!serialize_frame_delta_into(baseline, frame, bytes, encoding))
+    {
+        return std::nullopt;
+    }
+
+    return bytes;
+}
+
+bool serialize_frame_delta_into(const FrameSnapshot& baseline, const FrameSnapshot& frame, std::vector<std::byte>& out, FrameEncoding encoding) {
+    if (!validate_counts(frame, "serialize_frame_delta"))
+    {
+        return false;
+    }
+
+    // Baseline the client has to apply this delta to
+    append_bytes(out, &baseline.timestamp, sizeof(baseline.timestamp));
+
+    return encode_frame_body(baseline, frame, out, encoding, true);
+}
+
+bool serialize_frame_compact_into(const FrameSnapshot& frame, std::vector<std::byte>& out) {
+    if (!validate_counts(frame, "serialize_frame_compact"))
+    {
+        return false;
+    }
+
+    // Every entity is new to an empty baseline
+    static const FrameSnapshot empty_baseline = {};
+
+    return encode_frame_body(empty_baseline, frame, out, FrameEncoding::Compact, false);
+}
+
+std::vector<std::byte> serialize_client_frame_ack(const ClientFrameAck& payload) {
+    std::vector<std::byte> buffer(sizeof(ClientFrameAck));
+    memcpy(buffer.data(), &payload, sizeof(ClientFrameAck));
+
+    return buffer;
+}
+
+void serialize_client_frame_ack_into(const ClientFrameAck& payload, std::vector<std::byte>& out) {
+    append_bytes(out, &payload, sizeof(ClientFrameAck));
+}
+
+/*
+    Deserializer
+*/
+std::optional<uint32_t> peek_frame_delta_baseline(const std::byte* bytes, size_t size) {
+    uint32_t baseline_timestamp = 0;
+    auto reader = ByteReader{ bytes, size, 0 };
+
+    if (!reader.read(&baseline_timestamp, sizeof(baseline_timestamp)))
+    {
+        return std::nullopt;
+    }
+
+    return baseline_timestamp;
+}
+
+std::optional<FrameSnapshot> deserialize_frame_delta(const FrameSnapshot& baseline, const std::byte* bytes, size_t size, FrameEncoding encoding) {
+    FrameSnapshot frame = {};
+
+    if (!deserialize_frame_delta_into(frame, baseline, bytes, size, encoding))
+    {
+        return std::nullopt;
+    }
+
+    return frame;
+}
+
+std::optional<FrameSnapshot> deserialize_frame_compact(const std::byte* bytes, size_t size) {
+    FrameSnapshot frame = {};
+
+    if (!deserialize_frame_compact_into(frame, bytes, size))
+    {
+        return std::nullopt;
+    }
+
+    return frame;
+}
+
+bool deserialize_frame_delta_into(FrameSnapshot& frame, const FrameSnapshot& baseline, const std::byte* bytes, size_t size, FrameEncoding encoding) {
+    auto reader = ByteReader{ bytes, size, 0 };
+
+    uint32_t baseline_timestamp = 0;
+
+    if (!reader.read(&baseline_timestamp, sizeof(baseline_timestamp)) || baseline_timestamp != baseline.timestamp)
+    {
+        return false;
+    }
+
+    if (!decode_frame_body(baseline, reader, frame, encoding))
+    {
+        std::cerr << "[deserialize_frame_delta] Malformed frame delta" << "\n";
+
+        return false;
+    }
+
+    return true;
+}
+
+bool deserialize_frame_compact_into(FrameSnapshot& frame, const std::byte* bytes, size_t size) {
+    static const FrameSnapshot empty_baseline = {};
+
+    auto reader = ByteReader{ bytes, size, 0 };
+
+    if (!decode_frame_body(empty_baseline, reader, frame, FrameEncoding::Compact))
+    {
+        std::cerr << "[deserialize_frame_compact] Malformed compact frame" << "\n";
+
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<ClientFrameAck> deserialize_client_frame_ack(const std::byte* bytes, size_t size) {
+    if (size < sizeof(ClientFrameAck))
+    {
+        return std::nullopt;
+    }
+
+    ClientFrameAck result;
+    memcpy(&result, bytes, sizeof(ClientFrameAck));
+
+    return result;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include "../packet_template/frame.hpp"
+
+/*
+    FrameDelta wire format
+
+    [uint32 baseline timestamp]
+    [frame fixed header][stage]                         Always sent in full
+    For players, enemies, bosses, bullets and items:
+        [uint32 removed count][uint32 id * n]           Entities gone since the baseline
+        [uint32 upsert count][snapshot * n]             New or changed entities (full struct)
+
+    Entities are matched by 'id'. Unchanged entities are not sent at all.
+    A frame whose ids repeat within an entity type, or whose baseline's do, can't be
+    sent as a delta and goes out as a keyframe instead.
+
+    FrameDeltaCompact (FrameEncoding::Compact) replaces each entity section by a bit stream of
+        [varint removed count][varint upsert count][removed ids][upserts]
+    with the ids and the upserts as records of compact_entity_codec.hpp.
+    FrameCompact is the same without the baseline timestamp, against an empty baseline.
+*/
+
+/*
+    Serializer
+*/
+std::optional<std::vector<std::byte>> serialize_frame_delta(
+    const FrameSnapshot& baseline,
+    const FrameSnapshot& frame,
+    FrameEncoding encoding = FrameEncoding::Full
+);
+std::vector<std::byte> serialize_client_frame_ack(const ClientFrameAck& payload);
+
+/*
+    Append to 'out' instead of allocating.
+    Returns false if the counts don't match the vectors or an id repeats, 'out' may then
+    hold a partial delta and the caller should send a keyframe instead.
+*/
+bool serialize_frame_delta_into(
+    const FrameSnapshot& baseline,
+    const FrameSnapshot& frame,
+    std::vector<std::byte>& out,
+    FrameEncoding encoding = FrameEncoding::Full
+);
+bool serialize_frame_compact_into(const FrameSnapshot& frame, std::vector<std::byte>& out);
+void serialize_client_frame_ack_into(const ClientFrameAck& payload, std::vector<std::byte>& out);
+
+/*
+    Deserializer
+*/
+std::optional<uint32_t> peek_frame_delta_baseline(const std::byte* bytes, size_t size);
+std::optional<FrameSnapshot> deserialize_frame_delta(
+    const FrameSnapshot& baseline,
+    const std::byte* bytes,
+    size_t size,
+    FrameEncoding encoding = FrameEncoding::Full
+);
+std::optional<FrameSnapshot> deserialize_frame_compact(const std::byte* bytes, size_t size);
+
+/*
+    Overwrite 'frame' and reuse the capacity of its vectors, see deserialize_frame_into().
+    'frame' must not be 'baseline'.
+*/
+bool deserialize_frame_delta_into(
+    FrameSnapshot& frame,
+    const FrameSnapshot& baseline,
+    const std::byte* bytes,
+    size_t size,
+    FrameEncoding encoding = FrameEncoding::Full
+);
+bool deserialize_frame_compact_into(FrameSnapshot& frame, const std::byte* bytes, size_t size);
+std::optional<ClientFrameAck> deserialize_client_frame_ack(const std::byte* bytes, size_t size);
@@ -2,20 +2,21 @@
 #include <cstring>
 #include "frame_serializer.hpp"
 
-namespace {
-    template <typename T>
-    const std::byte* copy_bytes_to_t(T* dest, const std::byte* src) {
-        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
-        memcpy(dest, src, sizeof(T));
-
-        return src + sizeof(T);
-    }
-}
-
 /*
     Serializer
 */
 std::optional<std::vector<std::byte>> serialize_frame(const FrameSnapshot& frame) {
+    std::vector<std::byte> bytes;
+
+    if (!serialize_frame_into(frame, bytes))
+    {
+        return std::nullopt;
+    }
+
+    return bytes;
+}
+
+bool serialize_frame_into(const FrameSnapshot& frame, std::vector<std::byte>& out) {
     auto player_count_validation = frame.player_count != frame.player_vector.size(); 
     auto enemy_count_validation = frame.enemy_count != frame.enemy_vector.size();
     auto boss_count_validation = frame.boss_count != frame.boss_vector.size();
@@ -29,7 +30,7 @@ std::optional<std::vector<std::byte>> serialize_frame(const FrameSnapshot& frame
         std::cerr << "[serialize_frame] Failed to serialize frame" << "\n";
         std::cerr << "[serialize_frame] The number of objects and the size of objects does not match" << "\n";
         
-        return std::nullopt;
+        return false;
     }
 
     // Calculate the total size of the packet (frame)
@@ -46,8 +47,10 @@ std::optional<std::vector<std::byte>> serialize_frame(const FrameSnapshot& frame
         sizeof(frame.item_count) +
         ITEM_SNAPSHOT_SIZE * frame.item_count;
 
-    std::vector<std::byte> bytes(packet_size);
-    auto bytes_offset = bytes.data();
+    const auto out_offset = out.size();
+
+    out.resize(out_offset + packet_size);
+    auto bytes_offset = out.data() + out_offset;
 
     // Pack the fixed header of frame object
     memcpy(
@@ -152,88 +155,58 @@ std::optional<std::vector<std::byte>> serialize_frame(const FrameSnapshot& frame
 
     bytes_offset += ITEM_SNAPSHOT_SIZE * frame.item_count;
 
-    return bytes;
+    return true;
 }
 
 /*
     Deserializer
 */
-std::optional<FrameSnapshot> deserialize_frame(const std::vector<std::byte>& bytes) {
+std::optional<FrameSnapshot> deserialize_frame(const std::byte* bytes, size_t size) {
     FrameSnapshot frame = {};
-    auto bytes_offset = bytes.data();
-
-    // Copy the fixed area of the frame object
-    bytes_offset = copy_bytes_to_t(&frame.client_id,    bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.opponent_id,  bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.timestamp,    bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.score,        bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.mode,         bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.variant,      bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.difficulty,   bytes_offset);
-    bytes_offset = copy_bytes_to_t(&frame.state,        bytes_offset);
-
-    // Copy the stage object
-    bytes_offset = copy_bytes_to_t(&frame.stage, bytes_offset);
 
-    // Acquire the number of players and then copy the player objects
-    bytes_offset = copy_bytes_to_t(&frame.player_count, bytes_offset);
-    frame.player_vector.resize(frame.player_count);
-
-    memcpy(
-        frame.player_vector.data(),
-        bytes_offset,
-        PLAYER_SNAPSHOT_SIZE * frame.player_count
-    );
-
-    bytes_offset += PLAYER_SNAPSHOT_SIZE * frame.player_count;
-
-    // Acquire the number of enemies and then copy the enemy objects
-    bytes_offset = copy_bytes_to_t(&frame.enemy_count, bytes_offset);
-    frame.enemy_vector.resize(frame.enemy_count);
-
-    memcpy(
-        frame.enemy_vector.data(),
-        bytes_offset,
-        ENEMY_SNAPSHOT_SIZE * frame.enemy_count
-    );
-
-    bytes_offset += ENEMY_SNAPSHOT_SIZE * frame.enemy_count;
-
-    // // Acquire the number of bosses and then copy the boss objects
-    bytes_offset = copy_bytes_to_t(&frame.boss_count, bytes_offset);
-    frame.boss_vector.resize(frame.boss_count);
-
-    memcpy(
-        frame.boss_vector.data(),
-        bytes_offset,
-        BOSS_SNAPSHOT_SIZE * frame.boss_count
-    );
-
-    bytes_offset += BOSS_SNAPSHOT_SIZE * frame.boss_count;
-
-    // // Acquire the number of bullets and then copy the bullet objects
-    bytes_offset = copy_bytes_to_t(&frame.bullet_count, bytes_offset);
-    frame.bullet_vector.resize(frame.bullet_count);
-
-    memcpy(
-        frame.bullet_vector.data(),
-        bytes_offset,
-        BULLET_SNAPSHOT_SIZE * frame.bullet_count
-    );
-
-    bytes_offset += BULLET_SNAPSHOT_SIZE * frame.bullet_count;
+    if (!deserialize_frame_into(frame, bytes, size))
+    {
+        return std::nullopt;
+    }
 
-    // Acquire the number of items and then copy the item objects
-    bytes_offset = copy_bytes_to_t(&frame.item_count, bytes_offset);
-    frame.item_vector.resize(frame.item_count);
+    return frame;
+}
 
-    memcpy(
-        frame.item_vector.data(),
-        bytes_offset,
-        ITEM_SNAPSHOT_SIZE * frame.item_count
-    );
+bool deserialize_frame_into(FrameSnapshot& frame, const std::byte* bytes, size_t size) {
+    // The counts are checked by the view, before any vector is resized
+    const auto view = FrameView::parse(bytes, size);
 
-    bytes_offset += ITEM_SNAPSHOT_SIZE * frame.item_count;
+    if (!view.has_value())
+    {
+        return false;
+    }
 
-    return frame;
-}
\ No newline at end of file
+    const auto& header = view->header();
+
+    frame.client_id             = header.client_id;
+    frame.opponent_id           = header.opponent_id;
+    frame.timestamp             = header.timestamp;
+    frame.score                 = header.score;
+    frame.mode                  = header.mode;
+    frame.variant               = header.variant;
+    frame.difficulty            = header.difficulty;
+    frame.state                 = header.state;
+    frame.last_input_sequence   = header.last_input_sequence;
+
+    frame.stage = view->stage();
+
+    // Keeps the capacity of the vectors
+    view->players().copy_to(frame.player_vector);
+    view->enemies().copy_to(frame.enemy_vector);
+    view->bosses().copy_to(frame.boss_vector);
+    view->bullets().copy_to(frame.bullet_vector);
+    view->items().copy_to(frame.item_vector);
+
+    frame.player_count  = view->players().size();
+    frame.enemy_count   = view->enemies().size();
+    frame.boss_count    = view->bosses().size();
+    frame.bullet_count  = view->bullets().size();
+    frame.item_count    = view->items().size();
+
+    return true;
+}
@@ -10,7 +10,16 @@
 */
 std::optional<std::vector<std::byte>> serialize_frame(const FrameSnapshot& frame);
 
+// Appends to 'out' instead of allocating, returns false if the frame is inconsistent
+bool serialize_frame_into(const FrameSnapshot& frame, std::vector<std::byte>& out);
+
 /*
     Deserializer
 */
-std::optional<FrameSnapshot> deserialize_frame(const std::vector<std::byte>& bytes);
\ No newline at end of file
+std::optional<FrameSnapshot> deserialize_frame(const std::byte* bytes, size_t size);
+
+/*
+    Overwrites 'frame', reusing the capacity of its vectors, so it does not allocate once warmed up.
+    Returns false if the payload is truncated or a count exceeds it, 'frame' is unspecified then.
+*/
+bool deserialize_frame_into(FrameSnapshot& frame, const std::byte* bytes, size_t size);
\ No newline at end of file
@@ -5,6 +5,17 @@
 #include "game_serializer.hpp"
 
 namespace {
+    /*
+        Helper: append trivial POD types
+    */
+    template <typename T>
+    void serialize_trivial_struct_into(const T& payload, std::vector<std::byte>& out) {
+        const auto offset = out.size();
+
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &payload, sizeof(T));
+    }
+
     /*
         Helper: serialize trivial POD types
     */
@@ -19,11 +30,11 @@ namespace {
         Helper: deserialize trivial POD types
     */
     template <typename T>
-    std::optional<T> deserialize_trivial_struct(const std::vector<std::byte>& buffer) {
-        if (buffer.size() < sizeof(T)) return std::nullopt;
+    std::optional<T> deserialize_trivial_struct(const std::byte* buffer, size_t size) {
+        if (size < sizeof(T)) return std::nullopt;
 
         T result;
-        std::memcpy(&result, buffer.data(), sizeof(T));
+        std::memcpy(&result, buffer, sizeof(T));
         return result;
     }
 }
@@ -47,21 +58,37 @@ std::vector<std::byte> serialize_server_reconnect_response(const ServerReconnect
     return serialize_trivial_struct(payload);
 }
 
+void serialize_client_game_request_into(const ClientGameRequest& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_server_game_response_into(const ServerGameResponse& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_client_reconnect_request_into(const ClientReconnectRequest& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_server_reconnect_response_into(const ServerReconnectResponse& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
 /*
     Deserialize
 */
-std::optional<ClientGameRequest> deserialize_client_game_request(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ClientGameRequest>(buffer);
+std::optional<ClientGameRequest> deserialize_client_game_request(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ClientGameRequest>(buffer, size);
 }
 
-std::optional<ServerGameResponse> deserialize_server_game_response(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ServerGameResponse>(buffer);
+std::optional<ServerGameResponse> deserialize_server_game_response(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ServerGameResponse>(buffer, size);
 }
 
-std::optional<ClientReconnectRequest> deserialize_client_reconnect_request(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ClientReconnectRequest>(buffer);
+std::optional<ClientReconnectRequest> deserialize_client_reconnect_request(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ClientReconnectRequest>(buffer, size);
 }
 
-std::optional<ServerReconnectResponse> deserialize_server_reconnect_response(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ServerReconnectResponse>(buffer);
+std::optional<ServerReconnectResponse> deserialize_server_reconnect_response(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ServerReconnectResponse>(buffer, size);
 }
@@ -13,10 +13,16 @@ std::vector<std::byte> serialize_server_game_response(const ServerGameResponse&)
 std::vector<std::byte> serialize_client_reconnect_request(const ClientReconnectRequest&);
 std::vector<std::byte> serialize_server_reconnect_response(const ServerReconnectResponse&);
 
+
+// Append to 'out' instead of allocating
+void serialize_client_game_request_into(const ClientGameRequest& payload, std::vector<std::byte>& out);
+void serialize_server_game_response_into(const ServerGameResponse& payload, std::vector<std::byte>& out);
+void serialize_client_reconnect_request_into(const ClientReconnectRequest& payload, std::vector<std::byte>& out);
+void serialize_server_reconnect_response_into(const ServerReconnectResponse& payload, std::vector<std::byte>& out);
 /*
     Deserializer
 */
-std::optional<ClientGameRequest> deserialize_client_game_request(const std::vector<std::byte>&);
-std::optional<ServerGameResponse> deserialize_server_game_response(const std::vector<std::byte>&);
-std::optional<ClientReconnectRequest> deserialize_client_reconnect_request(const std::vector<std::byte>&);
-std::optional<ServerReconnectResponse> deserialize_server_reconnect_response(const std::vector<std::byte>&);
+std::optional<ClientGameRequest> deserialize_client_game_request(const std::byte*, size_t);
+std::optional<ServerGameResponse> deserialize_server_game_response(const std::byte*, size_t);
+std::optional<ClientReconnectRequest> deserialize_client_reconnect_request(const std::byte*, size_t);
+std::optional<ServerReconnectResponse> deserialize_server_reconnect_response(const std::byte*, size_t);
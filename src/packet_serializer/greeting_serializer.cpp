@@ -3,6 +3,17 @@
 #include "greeting_serializer.hpp"
 
 namespace {
+    /*
+        Helper function that appends any trivial struct to a std::vector<std::byte>
+    */
+    template <typename T>
+    void serialize_trivial_struct_into(const T& payload, std::vector<std::byte>& out) {
+        const auto offset = out.size();
+
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &payload, sizeof(T));
+    }
+
     /*
         Helper function that serialize any trivial struct into a std::vector<std::byte>
     */
@@ -16,16 +27,16 @@ namespace {
     }
 
     /*
-        Helper function that deserialize any trivial struct from std::vector<std::byte>
+        Helper function that deserialize any trivial struct from a byte buffer
     */
     template <typename T>
-    std::optional<T> deserialize_trivial_struct(const std::vector<std::byte>& buffer) {
-        if (buffer.size() < sizeof(T)) {
+    std::optional<T> deserialize_trivial_struct(const std::byte* buffer, size_t size) {
+        if (size < sizeof(T)) {
             return std::nullopt;
         }
 
         T result;
-        std::memcpy(&result, buffer.data(), sizeof(T));
+        std::memcpy(&result, buffer, sizeof(T));
         return result;
     }
 }
@@ -49,33 +60,52 @@ std::vector<std::byte> serialize_server_goodbye(const ServerGoodbye& payload) {
     return serialize_trivial_struct(payload);
 }
 
+void serialize_client_hello_into(const ClientHello& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_server_accept_into(const ServerAccept& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_client_goodbye_into(const ClientGoodbye& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
+void serialize_server_goodbye_into(const ServerGoodbye& payload, std::vector<std::byte>& out) {
+    serialize_trivial_struct_into(payload, out);
+}
+
 /*
     Deserializer
 */
-std::optional<ClientHello> deserialize_client_hello(const std::vector<std::byte>& buffer) {
-    if (buffer.size() < CLIENT_HELLO_SIZE)
+std::optional<ClientHello> deserialize_client_hello(const std::byte* buffer, size_t size) {
+    if (size < CLIENT_HELLO_SIZE)
     {
         return std::nullopt;
     }
 
     ClientHello result;
 
-    std::memcpy(&result.client_name_size, buffer.data(), sizeof(result.client_name_size));
+    std::memcpy(&result.client_name_size, buffer, sizeof(result.client_name_size));
     std::memcpy(result.client_name,
-                buffer.data() + sizeof(result.client_name_size),
+                buffer + sizeof(result.client_name_size),
                 MAX_CLIENT_NAME_SIZE);
+    std::memcpy(&result.frame_encodings,
+                buffer + sizeof(result.client_name_size) + MAX_CLIENT_NAME_SIZE,
+                sizeof(result.frame_encodings));
 
     return result;
 }
 
-std::optional<ServerAccept> deserialize_server_accept(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ServerAccept>(buffer);
+std::optional<ServerAccept> deserialize_server_accept(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ServerAccept>(buffer, size);
 }
 
-std::optional<ClientGoodbye> deserialize_client_goodbye(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ClientGoodbye>(buffer);
+std::optional<ClientGoodbye> deserialize_client_goodbye(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ClientGoodbye>(buffer, size);
 }
 
-std::optional<ServerGoodbye> deserialize_server_goodbye(const std::vector<std::byte>& buffer) {
-    return deserialize_trivial_struct<ServerGoodbye>(buffer);
+std::optional<ServerGoodbye> deserialize_server_goodbye(const std::byte* buffer, size_t size) {
+    return deserialize_trivial_struct<ServerGoodbye>(buffer, size);
 }
\ No newline at end of file
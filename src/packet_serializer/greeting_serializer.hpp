@@ -13,10 +13,16 @@ std::vector<std::byte> serialize_server_accept(const ServerAccept& payload);
 std::vector<std::byte> serialize_client_goodbye(const ClientGoodbye& payload);
 std::vector<std::byte> serialize_server_goodbye(const ServerGoodbye& payload);
 
+
+// Append to 'out' instead of allocating
+void serialize_client_hello_into(const ClientHello& payload, std::vector<std::byte>& out);
+void serialize_server_accept_into(const ServerAccept& payload, std::vector<std::byte>& out);
+void serialize_client_goodbye_into(const ClientGoodbye& payload, std::vector<std::byte>& out);
+void serialize_server_goodbye_into(const ServerGoodbye& payload, std::vector<std::byte>& out);
 /*
     Deserializer
 */
-std::optional<ClientHello> deserialize_client_hello(const std::vector<std::byte>& buffer);
-std::optional<ServerAccept> deserialize_server_accept(const std::vector<std::byte>& buffer);
-std::optional<ClientGoodbye> deserialize_client_goodbye(const std::vector<std::byte>& buffer);
-std::optional<ServerGoodbye> deserialize_server_goodbye(const std::vector<std::byte>& buffer);
\ No newline at end of file
+std::optional<ClientHello> deserialize_client_hello(const std::byte* buffer, size_t size);
+std::optional<ServerAccept> deserialize_server_accept(const std::byte* buffer, size_t size);
+std::optional<ClientGoodbye> deserialize_client_goodbye(const std::byte* buffer, size_t size);
+std::optional<ServerGoodbye> deserialize_server_goodbye(const std::byte* buffer, size_t size);
\ No newline at end of file
@@ -18,14 +18,14 @@ namespace {
         Helper: Deserialize any trivial struct
     */
     template <typename T>
-    std::optional<T> deserialize_trivial_struct(const std::vector<std::byte>& buffer) {
-        if (buffer.size() < sizeof(T))
+    std::optional<T> deserialize_trivial_struct(const std::byte* buffer, size_t size) {
+        if (size < sizeof(T))
         {
             return std::nullopt;
         }
 
         T result;
-        std::memcpy(&result, buffer.data(), sizeof(T));
+        std::memcpy(&result, buffer, sizeof(T));
 
         return result;
     }
@@ -38,11 +38,15 @@ std::vector<std::byte> serialize_packet_header(const PacketHeader& header) {
     return serialize_trivial_struct(header);
 }
 
+void serialize_packet_header_into(const PacketHeader& header, std::byte* dest) {
+    std::memcpy(dest, &header, PACKET_HEADER_SIZE);
+}
+
 /*
     Deserialize PacketHeader
 */
-std::optional<PacketHeader> deserialize_packet_header(const std::vector<std::byte>& buffer) {
-    auto header_opt = deserialize_trivial_struct<PacketHeader>(buffer);
+std::optional<PacketHeader> deserialize_packet_header(const std::byte* buffer, size_t size) {
+    auto header_opt = deserialize_trivial_struct<PacketHeader>(buffer, size);
 
     if (!header_opt || header_opt->magic_number != PACKET_MAGIC_NUMBER)
     {
@@ -10,7 +10,10 @@
 */
 std::vector<std::byte> serialize_packet_header(const PacketHeader& header);
 
+// Writes PACKET_HEADER_SIZE bytes to 'dest'
+void serialize_packet_header_into(const PacketHeader& header, std::byte* dest);
+
 /*
     Deserializer
 */
-std::optional<PacketHeader> deserialize_packet_header(const std::vector<std::byte>& buffer);
\ No newline at end of file
+std::optional<PacketHeader> deserialize_packet_header(const std::byte* buffer, size_t size);
\ No newline at end of file
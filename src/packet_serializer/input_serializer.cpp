@@ -5,6 +5,15 @@
 #include "input_serializer.hpp"
 
 namespace {
+    constexpr size_t bitset_byte_size(size_t bits) {
+        return (bits + 7) / 8;
+    }
+
+    // Three uint32_t fields, then held/pressed/released of the game actions and of the arrows
+    constexpr size_t CLIENT_INPUT_WIRE_SIZE = 3 * sizeof(uint32_t)
+        + 3 * bitset_byte_size(static_cast<size_t>(GameAction::Count))
+        + 3 * bitset_byte_size(static_cast<size_t>(Arrow::Count));
+
     template <size_t N>
     void serialize_bitset(const std::bitset<N>& bits, std::vector<std::byte>& out) {
         constexpr size_t byte_size = (N + 7) / 8;
@@ -28,7 +37,7 @@ namespace {
     }
 
     template <size_t N>
-    std::bitset<N> deserialize_bitset(const std::vector<std::byte>& in, size_t& offset) {
+    std::bitset<N> deserialize_bitset(const std::byte* in, size_t& offset) {
         constexpr size_t byte_size = (N + 7) / 8;
         std::bitset<N> bits;
 
@@ -59,7 +68,7 @@ namespace {
         serialize_bitset(arrows.released,   out);
     }
 
-    ArrowState deserialize_arrow_state(const std::vector<std::byte>& buffer, size_t& offset) {
+    ArrowState deserialize_arrow_state(const std::byte* buffer, size_t& offset) {
         constexpr size_t ARROW_COUNT = static_cast<size_t>(Arrow::Count);
 
         return ArrowState {
@@ -80,7 +89,7 @@ namespace {
         serialize_arrow_state(input.arrows, out);
     }
 
-    GameInput deserialize_game_input(const std::vector<std::byte>& buffer, size_t& offset) {
+    GameInput deserialize_game_input(const std::byte* buffer, size_t& offset) {
         constexpr size_t GAME_ACTION_COUNT = static_cast<size_t>(GameAction::Count);
 
         return {
@@ -102,7 +111,7 @@ namespace {
         }
     }
 
-    uint32_t deserialize_uint32_t(const std::vector<std::byte>& buffer, size_t& offset) {
+    uint32_t deserialize_uint32_t(const std::byte* buffer, size_t& offset) {
         uint32_t value = 0;
 
         for (size_t i = 0; i < sizeof(uint32_t); i++)
@@ -122,18 +131,23 @@ std::vector<std::byte> serialize_client_input(const ClientInput& payload) {
 
     buffer.reserve(32); // Optimization
 
-    serialize_uint32_t(payload.client_id,       buffer);
-    serialize_uint32_t(payload.frame_timestamp, buffer);
-    serialize_game_input(payload.game_input,    buffer);
+    serialize_client_input_into(payload, buffer);
 
     return buffer;
 }
 
+void serialize_client_input_into(const ClientInput& payload, std::vector<std::byte>& out) {
+    serialize_uint32_t(payload.client_id,       out);
+    serialize_uint32_t(payload.frame_timestamp, out);
+    serialize_uint32_t(payload.input_sequence,  out);
+    serialize_game_input(payload.game_input,    out);
+}
+
 /*
     Deserializer
 */
-std::optional<ClientInput> deserialize_client_input(const std::vector<std::byte>& buffer) {
-    if (buffer.size() > CLIENT_INPUT_SIZE)
+std::optional<ClientInput> deserialize_client_input(const std::byte* buffer, size_t size) {
+    if (size > CLIENT_INPUT_SIZE || size < CLIENT_INPUT_WIRE_SIZE)
     {
         return std::nullopt;
     }
@@ -143,6 +157,7 @@ std::optional<ClientInput> deserialize_client_input(const std::vector<std::byte>
     return ClientInput {
         deserialize_uint32_t(buffer,    offset),    // client_id
         deserialize_uint32_t(buffer,    offset),    // frame_timestamp
+        deserialize_uint32_t(buffer,    offset),    // input_sequence
         deserialize_game_input(buffer,  offset)     // state
     };
 }
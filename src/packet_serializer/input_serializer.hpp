@@ -9,8 +9,9 @@
     Serializer
 */
 std::vector<std::byte> serialize_client_input(const ClientInput& payload);
+void serialize_client_input_into(const ClientInput& payload, std::vector<std::byte>& out);
 
 /*
     Deserializer
 */
-std::optional<ClientInput> deserialize_client_input(const std::vector<std::byte>& buffer);
+std::optional<ClientInput> deserialize_client_input(const std::byte* buffer, size_t size);
@@ -4,4 +4,6 @@
 #include "greeting_serializer.hpp"
 #include "game_serializer.hpp"
 #include "frame_serializer.hpp"
-#include "input_serializer.hpp"
\ No newline at end of file
+#include "frame_delta_serializer.hpp"
+#include "input_serializer.hpp"
+#include "datagram_serializer.hpp"
\ No newline at end of file
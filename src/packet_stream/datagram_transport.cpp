@@ -0,0 +1,844 @@
+#include <iostream>
+#include <cstring>
+#include "datagram_transport.hpp"
+#include "../packet_serializer/packet_serializer.hpp"
+#include "../game_server/tick_profiler.hpp"
+
+namespace {
+    // Bind datagrams are repeated at this interval until the first frame arrives
+    constexpr auto BIND_INTERVAL = std::chrono::milliseconds(100);
+
+    // Inputs the frames haven't acknowledged yet are sent again at this interval
+    constexpr auto INPUT_RESEND_INTERVAL = std::chrono::milliseconds(50);
+
+    // The receive loops wake up at least this often, also to release conditioned datagrams
+    constexpr long CLIENT_RECV_TIMEOUT_USEC = 1000;
+    constexpr long SERVER_RECV_TIMEOUT_USEC = 100'000;
+
+    // Until the client acknowledges frames over UDP, one frame per interval is also sent over UDP
+    constexpr auto UDP_PROBE_INTERVAL = std::chrono::milliseconds(100);
+
+    // Frames go back to the stream when the client hasn't acknowledged one over UDP for this long
+    constexpr auto UDP_ACK_TIMEOUT = std::chrono::seconds(1);
+
+    DatagramHeader make_datagram_header(uint64_t token, uint32_t sequence, DatagramType type) {
+        DatagramHeader header = {};
+
+        header.magic_number     = DATAGRAM_MAGIC_NUMBER;
+        header.token            = token;
+        header.sequence         = sequence;
+        header.type             = type;
+        header.fragment_index   = 0;
+        header.fragment_count   = 1;
+
+        return header;
+    }
+}
+
+/*
+    Client
+*/
+DatagramClientTransport::DatagramClientTransport(
+    std::shared_ptr<ClientTransport> stream,
+    DatagramAddress server_address,
+    DatagramTransportConfig config
+)
+    : m_stream(std::move(stream))
+    , m_server_address(server_address)
+    , m_config(config)
+    , m_running(false)
+    , m_token(0)
+    , m_bound(false)
+    , m_inbound(config.conditioner)
+    , m_outbound(NetworkConditionerConfig {
+        config.conditioner.loss_rate,
+        config.conditioner.duplicate_rate,
+        config.conditioner.latency,
+        config.conditioner.jitter,
+        config.conditioner.seed + 1     // Both directions shouldn't lose the same datagrams
+    })
+    , m_recv_buffer(MAX_DATAGRAM_SIZE)
+    , m_send_sequence(0)
+{}
+
+DatagramClientTransport::~DatagramClientTransport() {
+    stop();
+}
+
+void DatagramClientTransport::start() {
+    if (m_running)
+    {
+        return;
+    }
+
+    m_stream->start();
+
+    if (!m_socket.open())
+    {
+        std::cerr << "[DatagramClientTransport] ERROR: Failed to open the datagram socket, "
+                  << "staying on the packet stream" << "\n";
+
+        return;
+    }
+
+    m_running = true;
+    m_recv_thread = std::thread(&DatagramClientTransport::receive_loop, this);
+
+    std::cout << "[DatagramClientTransport] DEBUG: Receive thread has been created" << "\n";
+}
+
+void DatagramClientTransport::stop() {
+    if (m_running.exchange(false))
+    {
+        if (m_recv_thread.joinable())
+        {
+            m_recv_thread.join();
+
+            std::cout << "[DatagramClientTransport] DEBUG: Receive thread has been joined" << "\n";
+        }
+
+        m_socket.close();
+    }
+
+    m_stream->stop();
+}
+
+bool DatagramClientTransport::is_running() const {
+    return m_stream->is_running();
+}
+
+std::optional<FrameSnapshot> DatagramClientTransport::poll_frame() {
+    auto latest = m_stream->poll_frame();
+
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+
+    if (!m_frame_queue.empty())
+    {
+        latest = std::move(m_frame_queue.back());
+        m_frame_queue.pop_back();
+    }
+
+    // The older frames are discarded, their snapshots recycled
+    while (!m_frame_queue.empty() && m_free_frames.size() < FRAME_POOL_SIZE)
+    {
+        m_free_frames.push_back(std::move(m_frame_queue.back()));
+        m_frame_queue.pop_back();
+    }
+
+    m_frame_queue.clear();
+
+    return latest;
+}
+
+size_t DatagramClientTransport::poll_frames(std::vector<FrameSnapshot>& frames) {
+    auto count = m_stream->poll_frames(frames);
+
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+
+    count += m_frame_queue.size();
+
+    // Moved out without a copy, the snapshots go back to the free list
+    while (!m_frame_queue.empty())
+    {
+        frames.push_back(std::move(m_frame_queue.front()));
+
+        if (m_free_frames.size() < FRAME_POOL_SIZE)
+        {
+            m_free_frames.push_back(std::move(m_frame_queue.front()));
+        }
+
+        m_frame_queue.pop_front();
+    }
+
+    return count;
+}
+
+std::optional<Packet> DatagramClientTransport::poll_packet() {
+    auto packet = m_stream->poll_packet();
+
+    if (packet.has_value() && packet->header.payload_type == PayloadType::ServerAccept)
+    {
+        m_token = std::get<ServerAccept>(packet->payload).datagram_token;
+    }
+
+    return packet;
+}
+
+bool DatagramClientTransport::send_packet(const Packet& packet) {
+    const auto expr1 = packet.header.payload_type != PayloadType::ClientInput;
+    const auto expr2 = !m_running || m_token == 0;
+
+    if (expr1 || expr2)
+    {
+        return m_stream->send_packet(packet);
+    }
+
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    // Keep the latest inputs and send all of them, the server skips the ones it already has
+    m_recent_inputs.push_back(std::get<ClientInput>(packet.payload));
+
+    while (m_recent_inputs.size() > std::max<size_t>(m_config.input_redundancy, 1))
+    {
+        m_recent_inputs.pop_front();
+    }
+
+    send_inputs();
+
+    return true;
+}
+
+std::exception_ptr DatagramClientTransport::get_recv_exception() const {
+    return m_stream->get_recv_exception();
+}
+
+bool DatagramClientTransport::is_bound() const {
+    return m_bound;
+}
+
+void DatagramClientTransport::receive_loop() {
+    const auto conditioned = m_config.conditioner.is_enabled();
+    auto last_bind = NetworkConditioner::Clock::time_point{};
+    auto conditioned_bytes = std::vector<std::byte>();
+
+    while (m_running)
+    {
+        const auto now = NetworkConditioner::Clock::now();
+
+        // Tell the server where we are until it answers with a frame
+        if (m_token != 0 && !m_bound && now - last_bind >= BIND_INTERVAL)
+        {
+            std::lock_guard<std::mutex> lock(m_send_mutex);
+            send_datagram(DatagramType::Bind, nullptr, 0);
+
+            last_bind = now;
+        }
+
+        DatagramAddress from = {};
+        const auto bytes_read = m_socket.recv_from(m_recv_buffer.data(), m_recv_buffer.size(), from, CLIENT_RECV_TIMEOUT_USEC);
+
+        if (bytes_read > 0 && from == m_server_address)
+        {
+            if (conditioned)
+            {
+                m_inbound.submit(m_recv_buffer.data(), static_cast<size_t>(bytes_read), NetworkConditioner::Clock::now());
+            }
+            else
+            {
+                handle_datagram(m_recv_buffer.data(), static_cast<size_t>(bytes_read));
+            }
+        }
+        else if (bytes_read < 0 && bytes_read != SOCKET_RECV_TIMEOUT)
+        {
+            std::cerr << "[DatagramClientTransport] ERROR: Recv failed: " << strerror(errno) << "\n";
+        }
+
+        if (!conditioned)
+        {
+            continue;
+        }
+
+        // Release whatever the simulated network has delivered by now
+        const auto release_time = NetworkConditioner::Clock::now();
+
+        while (m_inbound.poll(release_time, conditioned_bytes))
+        {
+            handle_datagram(conditioned_bytes.data(), conditioned_bytes.size());
+        }
+
+        while (m_outbound.poll(release_time, conditioned_bytes))
+        {
+            m_socket.send_to(m_server_address, conditioned_bytes.data(), conditioned_bytes.size());
+        }
+    }
+}
+
+void DatagramClientTransport::handle_datagram(const std::byte* data, size_t size) {
+    const auto header = deserialize_datagram_header(data, size);
+
+    if (!header.has_value() || header->token != m_token || header->type != DatagramType::Frame)
+    {
+        return;
+    }
+
+    if (m_reassembler.add(header.value(), data + DATAGRAM_HEADER_SIZE, size - DATAGRAM_HEADER_SIZE))
+    {
+        handle_frame(m_reassembler.completed());
+    }
+}
+
+void DatagramClientTransport::handle_frame(const std::vector<std::byte>& bytes) {
+    PayloadType payload_type = PayloadType::Unknown;
+
+    if (bytes.size() < sizeof(payload_type))
+    {
+        return;
+    }
+
+    std::memcpy(&payload_type, bytes.data(), sizeof(payload_type));
+
+    const auto* payload = bytes.data() + sizeof(payload_type);
+    const auto payload_size = bytes.size() - sizeof(payload_type);
+
+    auto decode_result = false;
+    auto& frame = m_received_frame;
+
+    if (payload_type == PayloadType::FrameSnapshot)
+    {
+        decode_result = deserialize_frame_into(frame, payload, payload_size);
+    }
+    else if (payload_type == PayloadType::FrameCompact)
+    {
+        decode_result = deserialize_frame_compact_into(frame, payload, payload_size);
+    }
+    else if (payload_type == PayloadType::FrameDelta || payload_type == PayloadType::FrameDeltaCompact)
+    {
+        const auto baseline_timestamp = peek_frame_delta_baseline(payload, payload_size);
+        const FrameSnapshot* baseline = baseline_timestamp.has_value()
+            ? m_frame_history.find(baseline_timestamp.value())
+            : nullptr;
+
+        // Lost with the datagram that carried it, the server falls back to an older baseline
+        if (baseline == nullptr)
+        {
+            return;
+        }
+
+        const auto encoding = payload_type == PayloadType::FrameDeltaCompact
+            ? FrameEncoding::Compact
+            : FrameEncoding::Full;
+
+        decode_result = deserialize_frame_delta_into(frame, *baseline, payload, payload_size, encoding);
+    }
+
+    if (!decode_result)
+    {
+        return;
+    }
+
+    m_bound = true;
+    m_frame_history.store(frame);
+
+    const auto ack = ClientFrameAck{ frame.timestamp };
+    const auto last_input_sequence = frame.last_input_sequence;
+
+    {
+        std::lock_guard<std::mutex> lock(m_frame_mutex);
+
+        // Swapped in instead of copied, 'frame' takes a recycled snapshot to decode the next one into
+        m_frame_queue.emplace_back();
+        std::swap(m_frame_queue.back(), frame);
+
+        if (!m_free_frames.empty())
+        {
+            std::swap(frame, m_free_frames.back());
+            m_free_frames.pop_back();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    m_payload_buffer.clear();
+    serialize_client_frame_ack_into(ack, m_payload_buffer);
+
+    send_datagram(DatagramType::FrameAck, m_payload_buffer.data(), m_payload_buffer.size());
+
+    // The last inputs before the player stops have no later datagrams to ride on, repeat them until applied
+    while (!m_recent_inputs.empty() && m_recent_inputs.front().input_sequence <= last_input_sequence)
+    {
+        m_recent_inputs.pop_front();
+    }
+
+    if (!m_recent_inputs.empty() && NetworkConditioner::Clock::now() - m_last_input_send >= INPUT_RESEND_INTERVAL)
+    {
+        send_inputs();
+    }
+}
+
+void DatagramClientTransport::send_datagram(DatagramType type, const std::byte* payload, size_t size) {
+    const auto header = make_datagram_header(m_token, m_send_sequence++, type);
+
+    m_send_buffer.resize(DATAGRAM_HEADER_SIZE + size);
+    serialize_datagram_header_into(header, m_send_buffer.data());
+
+    if (size > 0)
+    {
+        std::memcpy(m_send_buffer.data() + DATAGRAM_HEADER_SIZE, payload, size);
+    }
+
+    if (m_config.conditioner.is_enabled())
+    {
+        m_outbound.submit(m_send_buffer.data(), m_send_buffer.size(), NetworkConditioner::Clock::now());
+
+        return;
+    }
+
+    m_socket.send_to(m_server_address, m_send_buffer.data(), m_send_buffer.size());
+}
+
+void DatagramClientTransport::send_inputs() {
+    m_payload_buffer.clear();
+    serialize_input_bundle_into(m_recent_inputs, m_payload_buffer);
+
+    send_datagram(DatagramType::Input, m_payload_buffer.data(), m_payload_buffer.size());
+
+    m_last_input_send = NetworkConditioner::Clock::now();
+}
+
+/*
+    Endpoint
+*/
+DatagramEndpoint::DatagramEndpoint()
+    : m_running(false)
+    , m_reactor(nullptr)
+    , m_reactor_token(0)
+    , m_recv_buffer{}
+{}
+
+DatagramEndpoint::~DatagramEndpoint() {
+    close();
+}
+
+bool DatagramEndpoint::open(uint16_t port, NetReactor* reactor) {
+    if (m_running || !m_socket.open(port))
+    {
+        return false;
+    }
+
+    m_running = true;
+
+    if (reactor != nullptr && reactor->is_running() && m_socket.set_non_blocking(true))
+    {
+        m_reactor_token = reactor->add(m_socket.get_native_handle(), this);
+
+        if (m_reactor_token != 0)
+        {
+            m_reactor = reactor;
+
+            std::cout << "[DatagramEndpoint] DEBUG: Datagram socket has been attached to the reactor" << "\n";
+
+            return true;
+        }
+
+        m_socket.set_non_blocking(false);
+    }
+
+    m_recv_thread = std::thread(&DatagramEndpoint::receive_loop, this);
+
+    std::cout << "[DatagramEndpoint] DEBUG: Receive thread has been created" << "\n";
+
+    return true;
+}
+
+void DatagramEndpoint::close() {
+    if (m_running.exchange(false))
+    {
+        if (m_reactor != nullptr)
+        {
+            m_reactor->remove(m_reactor_token);
+
+            m_reactor = nullptr;
+            m_reactor_token = 0;
+        }
+
+        if (m_recv_thread.joinable())
+        {
+            m_recv_thread.join();
+
+            std::cout << "[DatagramEndpoint] DEBUG: Receive thread has been joined" << "\n";
+        }
+
+        m_socket.close();
+    }
+}
+
+bool DatagramEndpoint::is_open() const {
+    return m_running;
+}
+
+uint64_t DatagramEndpoint::add_route(DatagramServerTransport* transport) {
+    if (!m_running)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_route_mutex);
+
+    // Random, so a stray client can't guess the token of another session
+    uint64_t token = 0;
+
+    while (token == 0 || m_routes.count(token) != 0)
+    {
+        token = static_cast<uint64_t>(m_token_random()) << 32 | static_cast<uint32_t>(m_token_random());
+    }
+
+    m_routes.emplace(token, transport);
+
+    return token;
+}
+
+void DatagramEndpoint::remove_route(uint64_t token) {
+    std::lock_guard<std::mutex> lock(m_route_mutex);
+
+    m_routes.erase(token);
+}
+
+ssize_t DatagramEndpoint::send_to(const DatagramAddress& peer, const std::byte* data, size_t size) {
+    return m_socket.send_to(peer, data, size);
+}
+
+void DatagramEndpoint::on_readable() {
+    // Edge-triggered, so drain the socket until it would block
+    while (m_running)
+    {
+        DatagramAddress from = {};
+        const auto bytes_read = m_socket.try_recv_from(m_recv_buffer.data(), m_recv_buffer.size(), from);
+
+        if (bytes_read == SOCKET_RECV_WOULD_BLOCK || bytes_read < 0)
+        {
+            break;
+        }
+
+        dispatch(m_recv_buffer.data(), static_cast<size_t>(bytes_read), from);
+    }
+}
+
+void DatagramEndpoint::receive_loop() {
+    while (m_running)
+    {
+        DatagramAddress from = {};
+        const auto bytes_read = m_socket.recv_from(m_recv_buffer.data(), m_recv_buffer.size(), from, SERVER_RECV_TIMEOUT_USEC);
+
+        if (bytes_read < 0)
+        {
+            continue;
+        }
+
+        dispatch(m_recv_buffer.data(), static_cast<size_t>(bytes_read), from);
+    }
+}
+
+void DatagramEndpoint::dispatch(const std::byte* data, size_t size, const DatagramAddress& from) {
+    const auto header = deserialize_datagram_header(data, size);
+
+    if (!header.has_value())
+    {
+        return;
+    }
+
+    // Held during the delivery, so 'remove_route()' waits for it
+    std::lock_guard<std::mutex> lock(m_route_mutex);
+
+    const auto route = m_routes.find(header->token);
+
+    if (route == m_routes.end())
+    {
+        return;
+    }
+
+    route->second->on_datagram(header.value(), data + DATAGRAM_HEADER_SIZE, size - DATAGRAM_HEADER_SIZE, from);
+}
+
+/*
+    Server
+*/
+DatagramServerTransport::DatagramServerTransport(std::shared_ptr<ServerTransport> stream, std::shared_ptr<DatagramEndpoint> endpoint)
+    : m_stream(std::move(stream))
+    , m_endpoint(std::move(endpoint))
+    , m_token(0)
+    , m_peer{}
+    , m_peer_known(false)
+    , m_peer_sequence(0)
+    , m_last_input_sequence(0)
+    , m_acked_frame_timestamp(0)
+    , m_frame_ack_count(0)
+    , m_frame_encoding(FrameEncoding::Full)
+    , m_seen_frame_ack_count(0)
+    , m_frame_sequence(0)
+    , m_phase_timer(nullptr)
+{}
+
+DatagramServerTransport::~DatagramServerTransport() {
+    stop();
+}
+
+void DatagramServerTransport::start() {
+    m_stream->start();
+    register_route();
+}
+
+void DatagramServerTransport::stop() {
+    if (m_token != 0)
+    {
+        m_endpoint->remove_route(m_token);
+        m_token = 0;
+    }
+
+    m_stream->stop();
+}
+
+bool DatagramServerTransport::is_running() const {
+    return m_stream->is_running();
+}
+
+bool DatagramServerTransport::attach(NetReactor& reactor) {
+    if (!m_stream->attach(reactor))
+    {
+        return false;
+    }
+
+    register_route();
+
+    return true;
+}
+
+std::optional<Packet> DatagramServerTransport::poll_packet() {
+    auto packet = m_stream->poll_packet();
+
+    if (packet.has_value())
+    {
+        return packet;
+    }
+
+    std::lock_guard<std::mutex> lock(m_input_mutex);
+
+    if (m_input_queue.empty())
+    {
+        return std::nullopt;
+    }
+
+    packet = std::move(m_input_queue.front());
+    m_input_queue.pop();
+
+    return packet;
+}
+
+bool DatagramServerTransport::send_packet(const Packet& packet) {
+    if (packet.header.payload_type != PayloadType::ServerAccept)
+    {
+        return m_stream->send_packet(packet);
+    }
+
+    auto accept = std::get<ServerAccept>(packet.payload);
+    accept.datagram_token = m_token;
+
+    return m_stream->send_packet(make_packet(accept));
+}
+
+bool DatagramServerTransport::send_frame(const FrameSnapshot& frame) {
+    DatagramAddress peer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_peer_mutex);
+
+        if (!m_peer_known)
+        {
+            return m_stream->send_frame(frame);
+        }
+
+        peer = m_peer;
+    }
+
+    const auto now = Clock::now();
+    const auto ack_count = m_frame_ack_count.load();
+
+    if (ack_count != m_seen_frame_ack_count)
+    {
+        m_seen_frame_ack_count = ack_count;
+        m_last_frame_ack = now;
+    }
+
+    // The client's address alone doesn't mean frames reach it, only its acknowledgements over UDP do
+    const auto udp_acknowledged = ack_count != 0 && now - m_last_frame_ack < UDP_ACK_TIMEOUT;
+
+    if (!udp_acknowledged)
+    {
+        if (now - m_last_probe < UDP_PROBE_INTERVAL)
+        {
+            return m_stream->send_frame(frame);
+        }
+
+        m_last_probe = now;
+
+        if (!m_stream->send_frame(frame))
+        {
+            return false;
+        }
+    }
+
+    const FrameSnapshot* baseline = nullptr;
+
+    if (ack_count != 0)
+    {
+        baseline = m_sent_frames.find(m_acked_frame_timestamp);
+    }
+
+    // [PayloadType][keyframe or delta], split into fragments below
+    const auto encoding = m_frame_encoding.load();
+    const auto compact = encoding == FrameEncoding::Compact;
+
+    auto payload_type = compact ? PayloadType::FrameDeltaCompact : PayloadType::FrameDelta;
+    auto serialize_result = false;
+
+    m_frame_buffer.resize(sizeof(payload_type));
+
+    if (baseline != nullptr)
+    {
+        // Repeated entity ids can't be matched against the baseline, send a keyframe
+        serialize_result = serialize_frame_delta_into(*baseline, frame, m_frame_buffer, encoding);
+    }
+
+    if (!serialize_result)
+    {
+        payload_type = compact ? PayloadType::FrameCompact : PayloadType::FrameSnapshot;
+
+        m_frame_buffer.resize(sizeof(payload_type));
+
+        serialize_result = compact
+            ? serialize_frame_compact_into(frame, m_frame_buffer)
+            : serialize_frame_into(frame, m_frame_buffer);
+    }
+
+    std::memcpy(m_frame_buffer.data(), &payload_type, sizeof(payload_type));
+
+    if (!serialize_result)
+    {
+        std::cerr << "[DatagramServerTransport] ERROR: Failed to serialize frame" << "\n";
+
+        return false;
+    }
+
+    const auto fragment_count = (m_frame_buffer.size() + MAX_DATAGRAM_PAYLOAD_SIZE - 1) / MAX_DATAGRAM_PAYLOAD_SIZE;
+
+    if (fragment_count > MAX_FRAME_FRAGMENTS)
+    {
+        return udp_acknowledged ? m_stream->send_frame(frame) : true;
+    }
+
+    m_sent_frames.store(frame);
+
+    if (m_phase_timer != nullptr)
+    {
+        m_phase_timer->mark(TickPhase::Serialize);
+    }
+
+    auto header = make_datagram_header(m_token, m_frame_sequence++, DatagramType::Frame);
+    header.fragment_count = static_cast<uint8_t>(fragment_count);
+
+    auto sent_all = true;
+
+    for (size_t i = 0; i < fragment_count; i++)
+    {
+        const auto offset = i * MAX_DATAGRAM_PAYLOAD_SIZE;
+        const auto size = std::min(MAX_DATAGRAM_PAYLOAD_SIZE, m_frame_buffer.size() - offset);
+
+        header.fragment_index = static_cast<uint8_t>(i);
+
+        m_send_buffer.resize(DATAGRAM_HEADER_SIZE + size);
+        serialize_datagram_header_into(header, m_send_buffer.data());
+        std::memcpy(m_send_buffer.data() + DATAGRAM_HEADER_SIZE, m_frame_buffer.data() + offset, size);
+
+        sent_all &= m_endpoint->send_to(peer, m_send_buffer.data(), m_send_buffer.size()) > 0;
+    }
+
+    // A lost probe is no failure, the frame went over the stream as well
+    return sent_all || !udp_acknowledged;
+}
+
+void DatagramServerTransport::set_frame_encoding(FrameEncoding encoding) {
+    m_frame_encoding = encoding;
+    m_stream->set_frame_encoding(encoding);
+}
+
+void DatagramServerTransport::set_phase_timer(TickPhaseTimer* timer) {
+    m_phase_timer = timer;
+    m_stream->set_phase_timer(timer);
+}
+
+std::exception_ptr DatagramServerTransport::get_recv_exception() const {
+    return m_stream->get_recv_exception();
+}
+
+void DatagramServerTransport::on_datagram(const DatagramHeader& header, const std::byte* payload, size_t size, const DatagramAddress& from) {
+    auto decoded = false;
+
+    switch (header.type)
+    {
+        case DatagramType::Bind:
+        {
+            decoded = size == 0;
+
+            break;
+        }
+
+        case DatagramType::Input:
+        {
+            m_bundle.clear();
+
+            if (!deserialize_input_bundle(payload, size, m_bundle))
+            {
+                break;
+            }
+
+            decoded = true;
+
+            std::lock_guard<std::mutex> lock(m_input_mutex);
+
+            // Oldest first, anything already queued is a redundant copy
+            for (const auto& input : m_bundle)
+            {
+                if (input.input_sequence > m_last_input_sequence)
+                {
+                    m_input_queue.push(make_packet(input));
+                    m_last_input_sequence = input.input_sequence;
+                }
+            }
+
+            break;
+        }
+
+        case DatagramType::FrameAck:
+        {
+            const auto ack_opt = deserialize_client_frame_ack(payload, size);
+
+            if (ack_opt.has_value())
+            {
+                decoded = true;
+
+                m_acked_frame_timestamp = ack_opt.value().frame_timestamp;
+                m_frame_ack_count++;
+            }
+
+            break;
+        }
+
+        case DatagramType::Frame:
+        default:
+            break;
+    }
+
+    if (!decoded)
+    {
+        return;
+    }
+
+    // The latest address wins, so a client behind a rebinding NAT keeps receiving,
+    // but a replayed or reordered datagram can't move the frames elsewhere
+    std::lock_guard<std::mutex> lock(m_peer_mutex);
+
+    if (m_peer_known && header.sequence <= m_peer_sequence)
+    {
+        return;
+    }
+
+    m_peer = from;
+    m_peer_known = true;
+    m_peer_sequence = header.sequence;
+}
+
+void DatagramServerTransport::register_route() {
+    if (m_token == 0)
+    {
+        m_token = m_endpoint->add_route(this);
+    }
+}
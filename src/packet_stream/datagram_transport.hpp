@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <unordered_map>
+
+#include "../socket/socket.hpp"
+#include "../socket/net_reactor.hpp"
+#include "../packet_template/packet_template.hpp"
+#include "../packet_template/datagram.hpp"
+#include "transport.hpp"
+#include "frame_history.hpp"
+#include "frame_reassembler.hpp"
+#include "network_conditioner.hpp"
+
+struct DatagramTransportConfig {
+    /*
+        Every input datagram repeats the latest ClientInputs the server hasn't applied yet,
+        at most this many. An input is only lost if every datagram carrying it is lost.
+    */
+    size_t                      input_redundancy    = 8;
+
+    // Applied to both directions on the client, the server needs no simulation of its own
+    NetworkConditionerConfig    conditioner;
+};
+
+/*
+    Client end of the datagram channel.
+
+    Wraps the packet stream, which keeps carrying the handshake and goodbye messages.
+    Once ServerAccept hands out a datagram token, ClientInputs and frame acknowledgements
+    go over UDP and the server switches its frames to UDP once we acknowledge one over UDP.
+
+    Frames are unreliable, sequenced and latest-wins, inputs are sent redundantly.
+*/
+class DatagramClientTransport : public ClientTransport {
+public:
+    DatagramClientTransport(
+        std::shared_ptr<ClientTransport> stream,
+        DatagramAddress server_address,
+        DatagramTransportConfig config = DatagramTransportConfig()
+    );
+    ~DatagramClientTransport() override;
+
+    // Delete copy constructor and copy assignment operator
+    DatagramClientTransport(const DatagramClientTransport&) = delete;
+    DatagramClientTransport& operator=(const DatagramClientTransport&) = delete;
+
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
+
+    // Frames from both the stream and the datagram channel
+    std::optional<FrameSnapshot> poll_frame() override;
+    size_t poll_frames(std::vector<FrameSnapshot>& frames) override;
+
+    // Picks the datagram token out of ServerAccept on its way through
+    std::optional<Packet> poll_packet() override;
+
+    // ClientInput goes over UDP once the token is known, everything else over the stream
+    bool send_packet(const Packet& packet) override;
+
+    std::exception_ptr get_recv_exception() const override;
+
+    // True once a frame has arrived over UDP
+    bool is_bound() const;
+
+private:
+    void receive_loop();
+    void handle_datagram(const std::byte* data, size_t size);
+    void handle_frame(const std::vector<std::byte>& bytes);
+
+    // Builds the datagram in 'm_send_buffer' and sends it, or hands it to the conditioner
+    void send_datagram(DatagramType type, const std::byte* payload, size_t size);
+
+    // Sends 'm_recent_inputs', 'm_send_mutex' must be held
+    void send_inputs();
+
+    std::shared_ptr<ClientTransport>    m_stream;
+    DatagramAddress                     m_server_address;
+    DatagramTransportConfig             m_config;
+
+    DatagramSocket                      m_socket;
+    std::atomic<bool>                   m_running;
+    std::thread                         m_recv_thread;
+
+    std::atomic<uint64_t>               m_token;
+    std::atomic<bool>                   m_bound;
+
+    NetworkConditioner                  m_inbound;
+    NetworkConditioner                  m_outbound;
+
+    // Receive thread only, frames are decoded into 'm_received_frame' and swapped into the queue
+    FrameReassembler                    m_reassembler;
+    FrameHistory                        m_frame_history;
+    FrameSnapshot                       m_received_frame;
+    std::vector<std::byte>              m_recv_buffer;
+
+    // The drained snapshots go back to 'm_free_frames'
+    std::mutex                          m_frame_mutex;
+    std::deque<FrameSnapshot>           m_frame_queue;
+    std::vector<FrameSnapshot>          m_free_frames;
+
+    // Inputs are sent from the main thread, acknowledgements from the receive thread
+    std::mutex                          m_send_mutex;
+    std::vector<std::byte>              m_send_buffer;
+    std::vector<std::byte>              m_payload_buffer;
+    std::deque<ClientInput>             m_recent_inputs;
+    uint32_t                            m_send_sequence;
+    NetworkConditioner::Clock::time_point   m_last_input_send;
+};
+
+class DatagramServerTransport;
+
+/*
+    The server's UDP socket, shared by every session.
+    Datagrams are routed to the session transports by their token.
+*/
+class DatagramEndpoint : public ReactorHandler {
+public:
+    DatagramEndpoint();
+    ~DatagramEndpoint() override;
+
+    // Delete copy constructor and copy assignment operator
+    DatagramEndpoint(const DatagramEndpoint&) = delete;
+    DatagramEndpoint& operator=(const DatagramEndpoint&) = delete;
+
+    // Receives on the reactor if it is running, otherwise on a thread of its own
+    bool open(uint16_t port, NetReactor* reactor);
+    void close();
+    bool is_open() const;
+
+    // Returns a new token routed to 'transport', or 0 if the endpoint is closed
+    uint64_t add_route(DatagramServerTransport* transport);
+
+    // Blocks until no datagram is being delivered to the route
+    void remove_route(uint64_t token);
+
+    ssize_t send_to(const DatagramAddress& peer, const std::byte* data, size_t size);
+
+    // Called by NetReactor on an I/O thread
+    void on_readable() override;
+
+private:
+    void receive_loop();
+    void dispatch(const std::byte* data, size_t size, const DatagramAddress& from);
+
+    DatagramSocket                                          m_socket;
+    std::atomic<bool>                                       m_running;
+    std::thread                                             m_recv_thread;
+
+    NetReactor*                                             m_reactor;
+    uint64_t                                                m_reactor_token;
+
+    // Only one thread receives at a time
+    std::array<std::byte, MAX_DATAGRAM_SIZE>                m_recv_buffer;
+
+    std::mutex                                              m_route_mutex;
+    std::unordered_map<uint64_t, DatagramServerTransport*>  m_routes;
+
+    // Every token is drawn from the OS entropy source, so one token says nothing about the next
+    std::random_device                                      m_token_random;
+};
+
+/*
+    Server end of the datagram channel, see DatagramClientTransport.
+
+    Frames go over the stream until the client acknowledges a frame over UDP, until then
+    a frame is also sent over UDP every UDP_PROBE_INTERVAL to find out whether it gets through.
+    Without an acknowledgement over UDP for UDP_ACK_TIMEOUT the frames go back to the stream.
+*/
+class DatagramServerTransport : public ServerTransport {
+public:
+    DatagramServerTransport(std::shared_ptr<ServerTransport> stream, std::shared_ptr<DatagramEndpoint> endpoint);
+    ~DatagramServerTransport() override;
+
+    // Delete copy constructor and copy assignment operator
+    DatagramServerTransport(const DatagramServerTransport&) = delete;
+    DatagramServerTransport& operator=(const DatagramServerTransport&) = delete;
+
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
+
+    bool attach(NetReactor& reactor) override;
+
+    // Packets from the stream first, then the inputs received over UDP
+    std::optional<Packet> poll_packet() override;
+
+    // Adds the datagram token to ServerAccept
+    bool send_packet(const Packet& packet) override;
+
+    /*
+        Sends the frame over UDP while the client acknowledges them, as a FrameDelta against
+        the last frame acknowledged over UDP or as a keyframe. Frames too big for
+        MAX_FRAME_FRAGMENTS datagrams go over the stream.
+    */
+    bool send_frame(const FrameSnapshot& frame) override;
+
+    // Applies to the frames over UDP and the stream alike
+    void set_frame_encoding(FrameEncoding encoding) override;
+    void set_phase_timer(TickPhaseTimer* timer) override;
+
+    std::exception_ptr get_recv_exception() const override;
+
+    // Called by DatagramEndpoint with the route locked
+    void on_datagram(const DatagramHeader& header, const std::byte* payload, size_t size, const DatagramAddress& from);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void register_route();
+
+    std::shared_ptr<ServerTransport>    m_stream;
+    std::shared_ptr<DatagramEndpoint>   m_endpoint;
+    uint64_t                            m_token;
+
+    // Moved only by a datagram that decodes and is newer than the last one that moved it
+    std::mutex                          m_peer_mutex;
+    DatagramAddress                     m_peer;
+    bool                                m_peer_known;
+    uint32_t                            m_peer_sequence;
+
+    // Inputs unpacked from the bundles, without the duplicates
+    std::mutex                          m_input_mutex;
+    std::queue<Packet>                  m_input_queue;
+    std::vector<ClientInput>            m_bundle;
+    uint32_t                            m_last_input_sequence;
+
+    // Frames sent over UDP and the latest one acknowledged over UDP (tick thread)
+    FrameHistory                        m_sent_frames;
+    std::atomic<uint32_t>               m_acked_frame_timestamp;
+    std::atomic<uint32_t>               m_frame_ack_count;
+    std::atomic<FrameEncoding>          m_frame_encoding;
+
+    // When the tick thread last saw 'm_frame_ack_count' move and last probed over UDP
+    uint32_t                            m_seen_frame_ack_count;
+    Clock::time_point                   m_last_frame_ack;
+    Clock::time_point                   m_last_probe;
+
+    std::vector<std::byte>              m_frame_buffer;
+    std::vector<std::byte>              m_send_buffer;
+    uint32_t                            m_frame_sequence;
+
+    TickPhaseTimer*                     m_phase_timer;
+};
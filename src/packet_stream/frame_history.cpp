@@ -0,0 +1,29 @@
+#include "frame_history.hpp"
+
+FrameHistory::FrameHistory()
+    : m_frames{}
+    , m_valid{}
+{}
+
+void FrameHistory::store(const FrameSnapshot& frame) {
+    const auto slot = frame.timestamp % FRAME_HISTORY_SIZE;
+
+    m_frames[slot] = frame;
+    m_valid[slot] = true;
+}
+
+const FrameSnapshot* FrameHistory::find(uint32_t timestamp) const {
+    const auto slot = timestamp % FRAME_HISTORY_SIZE;
+
+    // The slot may have been overwritten by a newer frame
+    if (!m_valid[slot] || m_frames[slot].timestamp != timestamp)
+    {
+        return nullptr;
+    }
+
+    return &m_frames[slot];
+}
+
+void FrameHistory::clear() {
+    m_valid.fill(false);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "../packet_template/frame.hpp"
+
+constexpr size_t FRAME_HISTORY_SIZE = 32;  // ~0.5 seconds at 60 ticks per second
+
+// Drained snapshots the client transports keep to decode into, beyond this they are freed
+constexpr size_t FRAME_POOL_SIZE = 8;
+
+/*
+    Keeps the most recent frames addressed by their timestamp.
+    Used on both ends of a FrameDelta stream: the server remembers what it
+    has sent and the client remembers what it has reconstructed.
+    Slots are overwritten in place, so their vectors keep their capacity.
+*/
+class FrameHistory {
+public:
+    FrameHistory();
+
+    void store(const FrameSnapshot& frame);
+    const FrameSnapshot* find(uint32_t timestamp) const;
+    void clear();
+
+private:
+    std::array<FrameSnapshot, FRAME_HISTORY_SIZE>   m_frames;
+    std::array<bool, FRAME_HISTORY_SIZE>            m_valid;
+};
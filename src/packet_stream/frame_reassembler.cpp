@@ -0,0 +1,119 @@
+#include <cstring>
+#include "frame_reassembler.hpp"
+
+FrameReassembler::FrameReassembler()
+    : m_slots{}
+    , m_has_completed(false)
+    , m_last_completed(0)
+{}
+
+bool FrameReassembler::add(const DatagramHeader& header, const std::byte* payload, size_t size) {
+    const auto count = header.fragment_count;
+    const auto index = header.fragment_index;
+
+    if (count == 0 || index >= count || size > MAX_DATAGRAM_PAYLOAD_SIZE)
+    {
+        return false;
+    }
+
+    // Every fragment but the last one is full, so each has a fixed place in the frame
+    if (index + 1 < count && size != MAX_DATAGRAM_PAYLOAD_SIZE)
+    {
+        return false;
+    }
+
+    // Stale or duplicated frame
+    if (m_has_completed && header.sequence <= m_last_completed)
+    {
+        return false;
+    }
+
+    auto& slot = acquire_slot(header.sequence, count);
+
+    if (slot.fragment_count != count || slot.fragments.test(index))
+    {
+        return false;
+    }
+
+    std::memcpy(slot.bytes.data() + index * MAX_DATAGRAM_PAYLOAD_SIZE, payload, size);
+    slot.fragments.set(index);
+    slot.received++;
+
+    if (index + 1 == count)
+    {
+        slot.size = index * MAX_DATAGRAM_PAYLOAD_SIZE + size;
+    }
+
+    if (slot.received < count)
+    {
+        return false;
+    }
+
+    // Hand the bytes over by swapping, so neither buffer is reallocated
+    slot.bytes.resize(slot.size);
+    m_completed.swap(slot.bytes);
+
+    m_has_completed = true;
+    m_last_completed = header.sequence;
+
+    // Older frames can't be delivered anymore
+    for (auto& other : m_slots)
+    {
+        if (other.in_use && other.sequence <= m_last_completed)
+        {
+            other.in_use = false;
+        }
+    }
+
+    return true;
+}
+
+const std::vector<std::byte>& FrameReassembler::completed() const {
+    return m_completed;
+}
+
+void FrameReassembler::clear() {
+    for (auto& slot : m_slots)
+    {
+        slot.in_use = false;
+    }
+
+    m_has_completed = false;
+    m_last_completed = 0;
+    m_completed.clear();
+}
+
+FrameReassembler::Slot& FrameReassembler::acquire_slot(uint32_t sequence, uint8_t fragment_count) {
+    Slot* victim = &m_slots[0];
+
+    for (auto& slot : m_slots)
+    {
+        if (slot.in_use && slot.sequence == sequence)
+        {
+            return slot;
+        }
+
+        // Prefer a free slot, otherwise evict the oldest frame
+        if (!slot.in_use)
+        {
+            if (victim->in_use)
+            {
+                victim = &slot;
+            }
+        }
+        else if (victim->in_use && slot.sequence < victim->sequence)
+        {
+            victim = &slot;
+        }
+    }
+
+    victim->in_use = true;
+    victim->sequence = sequence;
+    victim->fragment_count = fragment_count;
+    victim->received = 0;
+    victim->size = 0;
+    victim->fragments.reset();
+    victim->bytes.resize(fragment_count * MAX_DATAGRAM_PAYLOAD_SIZE);
+
+    return *victim;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../packet_template/datagram.hpp"
+
+constexpr size_t FRAME_REASSEMBLY_SLOTS = 4;   // Frames that can be in flight at once
+
+/*
+    Puts the fragments of datagram frames back together.
+
+    Frames are sequenced and latest-wins: fragments of a frame older than the last
+    completed one are dropped, and an incomplete frame is abandoned as soon as a newer
+    one completes. A single lost fragment therefore costs one frame, never a stall.
+*/
+class FrameReassembler {
+public:
+    FrameReassembler();
+
+    // Returns true if this fragment completed its frame, the frame is then in 'completed()'
+    bool add(const DatagramHeader& header, const std::byte* payload, size_t size);
+
+    // The bytes of the last completed frame, valid until the next 'add()'
+    const std::vector<std::byte>& completed() const;
+
+    void clear();
+
+private:
+    struct Slot {
+        bool                                    in_use = false;
+        uint32_t                                sequence = 0;
+        uint8_t                                 fragment_count = 0;
+        size_t                                  received = 0;
+        size_t                                  size = 0;
+        std::bitset<MAX_FRAME_FRAGMENTS>        fragments;
+        std::vector<std::byte>                  bytes;
+    };
+
+    Slot& acquire_slot(uint32_t sequence, uint8_t fragment_count);
+
+    std::array<Slot, FRAME_REASSEMBLY_SLOTS>    m_slots;
+
+    bool                                        m_has_completed;
+    uint32_t                                    m_last_completed;
+    std::vector<std::byte>                      m_completed;
+};
@@ -0,0 +1,273 @@
+#include <iostream>
+#include <stdexcept>
+#include "loopback_transport.hpp"
+
+/*
+    Frame mailbox
+*/
+LoopbackFrameMailbox::LoopbackFrameMailbox()
+    : m_slots(CAPACITY + 1)
+    , m_closed(false)
+{
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        m_free.push_back(i);
+    }
+
+    m_queued.reserve(m_slots.size());
+    m_receiving.reserve(m_slots.size());
+}
+
+bool LoopbackFrameMailbox::send(const FrameSnapshot& frame) {
+    size_t slot = 0;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (m_closed)
+        {
+            return false;
+        }
+
+        // The receiver holds at most CAPACITY slots, so one is either free or queued
+        if (m_free.empty())
+        {
+            m_free.push_back(m_queued.front());
+            m_queued.erase(m_queued.begin());
+        }
+
+        slot = m_free.back();
+        m_free.pop_back();
+    }
+
+    // Copy assignment reuses the capacity of the slot's vectors
+    m_slots[slot] = frame;
+
+    std::lock_guard lock(m_mutex);
+
+    m_queued.push_back(slot);
+
+    // Latest wins, the oldest frame is dropped
+    if (m_queued.size() > CAPACITY)
+    {
+        m_free.push_back(m_queued.front());
+        m_queued.erase(m_queued.begin());
+    }
+
+    return true;
+}
+
+size_t LoopbackFrameMailbox::recv_all(std::vector<FrameSnapshot>& frames) {
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_receiving.assign(m_queued.begin(), m_queued.end());
+        m_queued.clear();
+    }
+
+    for (const auto slot : m_receiving)
+    {
+        frames.push_back(m_slots[slot]);
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    m_free.insert(m_free.end(), m_receiving.begin(), m_receiving.end());
+
+    return m_receiving.size();
+}
+
+void LoopbackFrameMailbox::close() {
+    std::lock_guard lock(m_mutex);
+
+    m_closed = true;
+}
+
+/*
+    Client
+*/
+LoopbackClientTransport::LoopbackClientTransport(
+    AsyncChannel<Packet> to_server,
+    AsyncChannel<Packet> from_server,
+    std::shared_ptr<LoopbackFrameMailbox> frames
+)
+    : m_to_server(std::move(to_server))
+    , m_from_server(std::move(from_server))
+    , m_frames(std::move(frames))
+    , m_running(false)
+{}
+
+LoopbackClientTransport::~LoopbackClientTransport() {
+    stop();
+}
+
+void LoopbackClientTransport::start() {
+    m_running = true;
+}
+
+void LoopbackClientTransport::stop() {
+    if (m_running.exchange(false))
+    {
+        m_to_server.close();
+        m_from_server.close();
+        m_frames->close();
+
+        std::cout << "[LoopbackClientTransport] DEBUG: Transport has been closed" << "\n";
+    }
+}
+
+bool LoopbackClientTransport::is_running() const {
+    return m_running;
+}
+
+std::optional<FrameSnapshot> LoopbackClientTransport::poll_frame() {
+    if (!m_running)
+    {
+        return std::nullopt;
+    }
+
+    // Keep the latest frame and discard the rest, the same as PacketStreamClient
+    m_received_frames.clear();
+
+    if (m_frames->recv_all(m_received_frames) == 0)
+    {
+        return std::nullopt;
+    }
+
+    return std::move(m_received_frames.back());
+}
+
+size_t LoopbackClientTransport::poll_frames(std::vector<FrameSnapshot>& frames) {
+    if (!m_running)
+    {
+        return 0;
+    }
+
+    return m_frames->recv_all(frames);
+}
+
+std::optional<Packet> LoopbackClientTransport::poll_packet() {
+    if (!m_running)
+    {
+        return std::nullopt;
+    }
+
+    return m_from_server.try_recv();
+}
+
+bool LoopbackClientTransport::send_packet(const Packet& packet) {
+    if (!m_running)
+    {
+        return false;
+    }
+
+    return m_to_server.send(packet);
+}
+
+std::exception_ptr LoopbackClientTransport::get_recv_exception() const {
+    return nullptr;
+}
+
+/*
+    Server
+*/
+LoopbackServerTransport::LoopbackServerTransport(
+    AsyncChannel<Packet> from_client,
+    AsyncChannel<Packet> to_client,
+    std::shared_ptr<LoopbackFrameMailbox> frames
+)
+    : m_from_client(std::move(from_client))
+    , m_to_client(std::move(to_client))
+    , m_frames(std::move(frames))
+    , m_running(false)
+{}
+
+LoopbackServerTransport::~LoopbackServerTransport() {
+    stop();
+}
+
+void LoopbackServerTransport::start() {
+    m_running = true;
+}
+
+void LoopbackServerTransport::stop() {
+    if (m_running.exchange(false))
+    {
+        m_from_client.close();
+        m_to_client.close();
+        m_frames->close();
+
+        std::cout << "[LoopbackServerTransport] DEBUG: Transport has been closed" << "\n";
+    }
+}
+
+bool LoopbackServerTransport::is_running() const {
+    return m_running;
+}
+
+bool LoopbackServerTransport::attach(NetReactor& reactor) {
+    static_cast<void>(reactor);
+
+    return false;
+}
+
+std::optional<Packet> LoopbackServerTransport::poll_packet() {
+    if (!m_running)
+    {
+        return std::nullopt;
+    }
+
+    return m_from_client.try_recv();
+}
+
+bool LoopbackServerTransport::send_packet(const Packet& packet) {
+    if (!m_running)
+    {
+        return false;
+    }
+
+    return m_to_client.send(packet);
+}
+
+bool LoopbackServerTransport::send_frame(const FrameSnapshot& frame) {
+    if (!m_running)
+    {
+        return false;
+    }
+
+    return m_frames->send(frame);
+}
+
+void LoopbackServerTransport::set_frame_encoding(FrameEncoding /* encoding */) {}
+
+void LoopbackServerTransport::set_phase_timer(TickPhaseTimer* /* timer */) {}
+
+std::exception_ptr LoopbackServerTransport::get_recv_exception() const {
+    if (m_from_client.closed())
+    {
+        return std::make_exception_ptr(
+            std::runtime_error("[LoopbackServerTransport] client disconnected")
+        );
+    }
+
+    return nullptr;
+}
+
+LoopbackTransportPair make_loopback_transport() {
+    auto [to_server_tx, to_server_rx] = channel<Packet>();
+    auto [to_client_tx, to_client_rx] = channel<Packet>();
+    auto frames = std::make_shared<LoopbackFrameMailbox>();
+
+    return LoopbackTransportPair {
+        std::make_shared<LoopbackClientTransport>(
+            std::move(to_server_tx),
+            std::move(to_client_rx),
+            frames
+        ),
+        std::make_shared<LoopbackServerTransport>(
+            std::move(to_server_rx),
+            std::move(to_client_tx),
+            std::move(frames)
+        )
+    };
+}
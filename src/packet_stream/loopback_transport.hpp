@@ -0,0 +1,140 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../async_channel.hpp"
+#include "transport.hpp"
+
+/*
+    Latest-wins hand-over of the frames from the server to the client, at most
+    CAPACITY frames are queued and the oldest one makes room for a new one.
+
+    The frames are copied into recycled slots, which keep the capacity of their vectors,
+    so the tick thread doesn't allocate once warmed up. The copies are made outside
+    the lock, a slot belongs to one side at a time.
+*/
+class LoopbackFrameMailbox {
+public:
+    static constexpr size_t CAPACITY = 8;
+
+    LoopbackFrameMailbox();
+
+    // Delete copy constructor and copy assignment operator
+    LoopbackFrameMailbox(const LoopbackFrameMailbox&) = delete;
+    LoopbackFrameMailbox& operator=(const LoopbackFrameMailbox&) = delete;
+
+    // Returns false once the mailbox is closed
+    bool send(const FrameSnapshot& frame);
+
+    // Copies every queued frame to the back of 'frames', oldest first, returns the number of frames
+    size_t recv_all(std::vector<FrameSnapshot>& frames);
+
+    void close();
+
+private:
+    // One slot more than the queue holds, so the sender always finds one while the receiver copies
+    std::vector<FrameSnapshot>  m_slots;
+
+    std::mutex                  m_mutex;
+    std::vector<size_t>         m_free;
+    std::vector<size_t>         m_queued;   // Oldest first
+    bool                        m_closed;
+
+    // Receiver only, the slots taken out of 'm_queued'
+    std::vector<size_t>         m_receiving;
+};
+
+/*
+    In-process transport for ENABLE_LOCAL_SERVER mode.
+
+    Packets are handed over through AsyncChannel by move and frames through a
+    LoopbackFrameMailbox, so there is no serialization, no socket and no receive thread.
+    Frames are always sent in full, the delta encoding only pays off on a real network.
+*/
+class LoopbackClientTransport : public ClientTransport {
+public:
+    LoopbackClientTransport(
+        AsyncChannel<Packet> to_server,
+        AsyncChannel<Packet> from_server,
+        std::shared_ptr<LoopbackFrameMailbox> frames
+    );
+    ~LoopbackClientTransport() override;
+
+    // Delete copy constructor and copy assignment operator
+    LoopbackClientTransport(const LoopbackClientTransport&) = delete;
+    LoopbackClientTransport& operator=(const LoopbackClientTransport&) = delete;
+
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
+
+    std::optional<FrameSnapshot> poll_frame() override;
+    size_t poll_frames(std::vector<FrameSnapshot>& frames) override;
+    std::optional<Packet> poll_packet() override;
+
+    bool send_packet(const Packet& packet) override;
+
+    // Always nullptr, like PacketStreamClient a closed server is not an error
+    std::exception_ptr get_recv_exception() const override;
+
+private:
+    AsyncChannel<Packet>                    m_to_server;
+    AsyncChannel<Packet>                    m_from_server;
+    std::shared_ptr<LoopbackFrameMailbox>   m_frames;
+
+    // 'poll_frame()' keeps only the latest of these
+    std::vector<FrameSnapshot>              m_received_frames;
+
+    std::atomic<bool>                       m_running;
+};
+
+class LoopbackServerTransport : public ServerTransport {
+public:
+    LoopbackServerTransport(
+        AsyncChannel<Packet> from_client,
+        AsyncChannel<Packet> to_client,
+        std::shared_ptr<LoopbackFrameMailbox> frames
+    );
+    ~LoopbackServerTransport() override;
+
+    // Delete copy constructor and copy assignment operator
+    LoopbackServerTransport(const LoopbackServerTransport&) = delete;
+    LoopbackServerTransport& operator=(const LoopbackServerTransport&) = delete;
+
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
+
+    // There is nothing to wait for, so the reactor is never used
+    bool attach(NetReactor& reactor) override;
+
+    std::optional<Packet> poll_packet() override;
+    bool send_packet(const Packet& packet) override;
+    bool send_frame(const FrameSnapshot& frame) override;
+
+    // Frames are handed over as they are, the encoding doesn't apply
+    void set_frame_encoding(FrameEncoding encoding) override;
+
+    // Nothing is serialized, the whole hand-over counts as TickPhase::Send
+    void set_phase_timer(TickPhaseTimer* timer) override;
+
+    // Reports a disconnect once the client has stopped
+    std::exception_ptr get_recv_exception() const override;
+
+private:
+    // 'closed()' of AsyncChannel is not const
+    mutable AsyncChannel<Packet>            m_from_client;
+    AsyncChannel<Packet>                    m_to_client;
+    std::shared_ptr<LoopbackFrameMailbox>   m_frames;
+
+    std::atomic<bool>                       m_running;
+};
+
+struct LoopbackTransportPair {
+    std::shared_ptr<LoopbackClientTransport>    client;
+    std::shared_ptr<LoopbackServerTransport>    server;
+};
+
+LoopbackTransportPair make_loopback_transport();
@@ -0,0 +1,77 @@
+#include "network_conditioner.hpp"
+
+bool NetworkConditionerConfig::is_enabled() const {
+    return loss_rate > 0.0f || duplicate_rate > 0.0f || latency.count() > 0 || jitter.count() > 0;
+}
+
+bool NetworkConditioner::LaterFirst::operator()(const DelayedDatagram& lhs, const DelayedDatagram& rhs) const {
+    if (lhs.due != rhs.due)
+    {
+        return lhs.due > rhs.due;
+    }
+
+    return lhs.order > rhs.order;
+}
+
+NetworkConditioner::NetworkConditioner(NetworkConditionerConfig config)
+    : m_config(config)
+    , m_random(config.seed)
+    , m_next_order(0)
+    , m_dropped_count(0)
+{}
+
+void NetworkConditioner::submit(const std::byte* data, size_t size, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    if (chance(m_random) < m_config.loss_rate)
+    {
+        m_dropped_count++;
+
+        return;
+    }
+
+    schedule(data, size, now);
+
+    if (chance(m_random) < m_config.duplicate_rate)
+    {
+        schedule(data, size, now);
+    }
+}
+
+bool NetworkConditioner::poll(Clock::time_point now, std::vector<std::byte>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_queue.empty() || m_queue.top().due > now)
+    {
+        return false;
+    }
+
+    // 'top()' is const, the bytes are copied out once
+    out.assign(m_queue.top().bytes.begin(), m_queue.top().bytes.end());
+    m_queue.pop();
+
+    return true;
+}
+
+size_t NetworkConditioner::dropped_count() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_dropped_count;
+}
+
+void NetworkConditioner::schedule(const std::byte* data, size_t size, Clock::time_point now) {
+    auto delay = std::chrono::duration_cast<Clock::duration>(m_config.latency);
+
+    if (m_config.jitter.count() > 0)
+    {
+        std::uniform_int_distribution<int64_t> jitter(0, std::chrono::duration_cast<Clock::duration>(m_config.jitter).count());
+        delay += Clock::duration(jitter(m_random));
+    }
+
+    m_queue.push(DelayedDatagram {
+        now + delay,
+        m_next_order++,
+        std::vector<std::byte>(data, data + size)
+    });
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <queue>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+
+struct NetworkConditionerConfig {
+    // Probability of dropping a datagram, in [0, 1]
+    float                       loss_rate       = 0.0f;
+
+    // Probability of delivering a datagram twice, in [0, 1]
+    float                       duplicate_rate  = 0.0f;
+
+    // Every datagram is delayed by 'latency' plus a uniform [0, jitter], so jitter also reorders
+    std::chrono::milliseconds   latency         = std::chrono::milliseconds(0);
+    std::chrono::milliseconds   jitter          = std::chrono::milliseconds(0);
+
+    // Same seed, same sequence of drops and delays
+    uint32_t                    seed            = 1;
+
+    bool is_enabled() const;
+};
+
+/*
+    Simulates a bad network on one direction of a datagram channel.
+    Datagrams go in through 'submit()' and come out of 'poll()' once they are due,
+    so the caller has to poll regularly (the receive loops do every millisecond).
+
+    Thread safe, inputs are submitted from the main thread while the receive thread polls.
+*/
+class NetworkConditioner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit NetworkConditioner(NetworkConditionerConfig config = NetworkConditionerConfig());
+
+    void submit(const std::byte* data, size_t size, Clock::time_point now);
+
+    // Moves the next datagram due at 'now' into 'out', returns false if none is due
+    bool poll(Clock::time_point now, std::vector<std::byte>& out);
+
+    size_t dropped_count() const;
+
+private:
+    struct DelayedDatagram {
+        Clock::time_point       due;
+        uint64_t                order;      // Keeps equal due times in submission order
+        std::vector<std::byte>  bytes;
+    };
+
+    struct LaterFirst {
+        bool operator()(const DelayedDatagram& lhs, const DelayedDatagram& rhs) const;
+    };
+
+    void schedule(const std::byte* data, size_t size, Clock::time_point now);
+
+    NetworkConditionerConfig                        m_config;
+
+    mutable std::mutex                              m_mutex;
+    std::mt19937                                    m_random;
+    std::priority_queue<DelayedDatagram, std::vector<DelayedDatagram>, LaterFirst> m_queue;
+    uint64_t                                        m_next_order;
+    size_t                                          m_dropped_count;
+};
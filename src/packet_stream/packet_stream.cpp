@@ -2,9 +2,62 @@
 #include <cstring>
 #include "packet_stream.hpp"
 #include "../packet_serializer/packet_serializer.hpp"
+#include "../game_server/tick_profiler.hpp"
+#include "../game_server/game_logic_constants.hpp"
+#include "../config_constants.hpp"
 
 namespace {
-    constexpr size_t TEMP_BUFFER_SIZE = 4096;
+    // Frames need room, the packets of a client are small and every connection has its own buffer
+    constexpr size_t CLIENT_RECV_BUFFER_SIZE = 256 * 1024;
+    constexpr size_t SERVER_RECV_BUFFER_SIZE = 16 * 1024;
+
+    // Unsent bytes on top of the socket buffer before the client is dropped, a few seconds of frames
+    constexpr size_t MAX_PENDING_OUTPUT_SIZE = 1024 * 1024;
+
+    // Frames dropped in a row before the client is dropped, 5 seconds
+    constexpr uint32_t MAX_DROPPED_FRAMES = 5 * game_logic_constants::TICK_RATE;
+
+    enum class PacketScan {
+        Incomplete,     // Waiting for more bytes
+        Complete,       // 'header' and its payload are at the front of the buffer
+        Oversized       // The header announces more than the peer may send, a protocol error
+    };
+
+    /*
+        Finds the next complete packet at the front of the buffer.
+        Skips garbage byte by byte until a valid magic number is found,
+        and grows the buffer if a packet within 'max_packet_size' would never fit in it.
+        The buffer only grows for a header that passed the check, the peer controls it.
+    */
+    PacketScan next_packet(RingBuffer& buffer, PacketHeader& header, size_t max_packet_size) {
+        while (buffer.size() >= PACKET_HEADER_SIZE)
+        {
+            buffer.peek(&header, 0, PACKET_HEADER_SIZE);
+
+            if (header.magic_number != PACKET_MAGIC_NUMBER)
+            {
+                buffer.consume(1);
+
+                continue;
+            }
+
+            const auto packet_size = PACKET_HEADER_SIZE + static_cast<size_t>(header.payload_size);
+
+            if (packet_size > max_packet_size)
+            {
+                return PacketScan::Oversized;
+            }
+
+            if (packet_size > buffer.capacity())
+            {
+                buffer.reserve(packet_size);
+            }
+
+            return buffer.size() >= packet_size ? PacketScan::Complete : PacketScan::Incomplete;
+        }
+
+        return PacketScan::Incomplete;
+    }
 }
 
 /*
@@ -13,6 +66,7 @@ namespace {
 PacketStreamClient::PacketStreamClient(std::shared_ptr<ClientSocket> socket)
     : m_socket(std::move(socket))
     , m_running(false)
+    , m_buffer(CLIENT_RECV_BUFFER_SIZE)
     , m_send_sequence(0)
     , m_recv_thread_exception(nullptr)
 {}
@@ -77,16 +131,49 @@ std::optional<FrameSnapshot> PacketStreamClient::poll_frame() {
     /*
         Gets the latest frame
     */
-    const auto frame = std::move(m_frame_queue.back());
+    auto frame = std::move(m_frame_queue.back());
+    m_frame_queue.pop_back();
 
     /*
-        And discards the rest of frames
+        And recycles the rest of frames
     */
+    while (!m_frame_queue.empty() && m_free_frames.size() < FRAME_POOL_SIZE)
+    {
+        m_free_frames.push_back(std::move(m_frame_queue.back()));
+        m_frame_queue.pop_back();
+    }
+
     m_frame_queue.clear();
 
     return frame;
 }
 
+size_t PacketStreamClient::poll_frames(std::vector<FrameSnapshot>& frames) {
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+
+    if (!is_running())
+    {
+        return 0;
+    }
+
+    const auto count = m_frame_queue.size();
+
+    // Moved out without a copy, the snapshots go back to the free list
+    while (!m_frame_queue.empty())
+    {
+        frames.push_back(std::move(m_frame_queue.front()));
+
+        if (m_free_frames.size() < FRAME_POOL_SIZE)
+        {
+            m_free_frames.push_back(std::move(m_frame_queue.front()));
+        }
+
+        m_frame_queue.pop_front();
+    }
+
+    return count;
+}
+
 std::optional<Packet> PacketStreamClient::poll_packet() {
     std::lock_guard<std::mutex> lock(m_packet_mutex);
 
@@ -119,16 +206,20 @@ bool PacketStreamClient::send_packet(const Packet& packet) {
         return false;
     }
 
-    // Serialize the payload into bytes
-    std::vector<std::byte> payload_bytes;
+    // The receive thread sends acknowledgements, the send buffer is shared
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    // Serialize the payload right behind the space for the header
+    m_send_buffer.resize(PACKET_HEADER_SIZE);
 
     switch (packet.header.payload_type)
     {
-        case PayloadType::ClientHello:              { payload_bytes = serialize_client_hello(std::get<ClientHello>(packet.payload));                        break; }
-        case PayloadType::ClientGoodbye:            { payload_bytes = serialize_client_goodbye(std::get<ClientGoodbye>(packet.payload));                    break; }
-        case PayloadType::ClientGameRequest:        { payload_bytes = serialize_client_game_request(std::get<ClientGameRequest>(packet.payload));           break; }
-        case PayloadType::ClientReconnectRequest:   { payload_bytes = serialize_client_reconnect_request(std::get<ClientReconnectRequest>(packet.payload)); break; }
-        case PayloadType::ClientInput:              { payload_bytes = serialize_client_input(std::get<ClientInput>(packet.payload));                        break; }
+        case PayloadType::ClientHello:              { serialize_client_hello_into(std::get<ClientHello>(packet.payload), m_send_buffer);                        break; }
+        case PayloadType::ClientGoodbye:            { serialize_client_goodbye_into(std::get<ClientGoodbye>(packet.payload), m_send_buffer);                    break; }
+        case PayloadType::ClientGameRequest:        { serialize_client_game_request_into(std::get<ClientGameRequest>(packet.payload), m_send_buffer);           break; }
+        case PayloadType::ClientReconnectRequest:   { serialize_client_reconnect_request_into(std::get<ClientReconnectRequest>(packet.payload), m_send_buffer); break; }
+        case PayloadType::ClientInput:              { serialize_client_input_into(std::get<ClientInput>(packet.payload), m_send_buffer);                        break; }
+        case PayloadType::ClientFrameAck:           { serialize_client_frame_ack_into(std::get<ClientFrameAck>(packet.payload), m_send_buffer);                 break; }
         default:
         {
             std::cerr << "[PacketStreamClient] Invalid PayloadType: "
@@ -143,17 +234,13 @@ bool PacketStreamClient::send_packet(const Packet& packet) {
     
     header.magic_number     = PACKET_MAGIC_NUMBER;
     header.sequence_number  = m_send_sequence.fetch_add(1);
-    header.payload_size     = static_cast<uint32_t>(payload_bytes.size());
+    header.payload_size     = static_cast<uint32_t>(m_send_buffer.size() - PACKET_HEADER_SIZE);
     header.payload_type     = get_payload_type(packet.payload);
-    
-    auto header_bytes = serialize_packet_header(header);
-
-    std::vector<std::byte> buffer;
 
-    buffer.insert(buffer.end(), header_bytes.begin(), header_bytes.end());
-    buffer.insert(buffer.end(), payload_bytes.begin(), payload_bytes.end());
+    serialize_packet_header_into(header, m_send_buffer.data());
 
-    return m_socket->send_data(buffer);
+    // One send for header and payload, the buffer keeps its capacity for the next packet
+    return m_socket->send_data(m_send_buffer.data(), m_send_buffer.size()) > 0;
 }
 
 std::exception_ptr PacketStreamClient::get_recv_exception() const {
@@ -161,11 +248,10 @@ std::exception_ptr PacketStreamClient::get_recv_exception() const {
 }
 
 void PacketStreamClient::receive_loop() {
-    std::byte temp_buffer[TEMP_BUFFER_SIZE];
-
     while (m_running)
     {
-        ssize_t bytes_read = m_socket->recv_data(temp_buffer, TEMP_BUFFER_SIZE);
+        // Receive straight into the ring buffer
+        ssize_t bytes_read = m_socket->recv_data(m_buffer.write_ptr(), m_buffer.writable());
 
         if (bytes_read == SOCKET_RECV_TIMEOUT)
         {
@@ -184,62 +270,79 @@ void PacketStreamClient::receive_loop() {
 
             break;
         }
-        
-        m_buffer.insert(
-            m_buffer.end(),
-            temp_buffer,
-            temp_buffer + bytes_read
-        );
-
-        process_buffer();
-    }
-}
-
-void PacketStreamClient::process_buffer() {
-    size_t offset = 0;
 
-    while (m_buffer.size() - offset >= PACKET_HEADER_SIZE)
-    {
-        PacketHeader header = {};
-
-        memcpy(&header, m_buffer.data() + offset, PACKET_HEADER_SIZE);
-
-        if (header.magic_number != PACKET_MAGIC_NUMBER)
-        {
-            offset++;
+        m_buffer.commit(static_cast<size_t>(bytes_read));
 
-            continue;
-        }
-
-        if (m_buffer.size() - offset < PACKET_HEADER_SIZE + header.payload_size)
+        if (!process_buffer())
         {
-            break;
+            throw std::runtime_error("[PacketStreamClient] server sent an oversized packet");
         }
+    }
+}
 
-        auto payload_start = m_buffer.begin() + offset + PACKET_HEADER_SIZE;
-        auto payload_end = payload_start + header.payload_size;
+bool PacketStreamClient::process_buffer() {
+    PacketHeader header = {};
+    PacketScan scan;
 
+    while ((scan = next_packet(m_buffer, header, socket_constants::SERVER_MAX_PACKET_SIZE)) == PacketScan::Complete)
+    {
         const auto payload_type = static_cast<PayloadType>(header.payload_type);
-        std::vector<std::byte> payload(payload_start, payload_end);
+        const auto payload_size = static_cast<size_t>(header.payload_size);
+        const auto* payload = m_buffer.data(PACKET_HEADER_SIZE, payload_size);
         std::optional<PacketPayload> message;
 
         switch (payload_type)
         {
-            case PayloadType::ServerAccept:             { message = deserialize_server_accept(payload);             break; }
-            case PayloadType::ServerGoodbye:            { message = deserialize_server_goodbye(payload);            break; }
-            case PayloadType::ServerGameResponse:       { message = deserialize_server_game_response(payload);      break; }
-            case PayloadType::ServerReconnectResponse:  { message = deserialize_server_reconnect_response(payload); break; }
+            case PayloadType::ServerAccept:             { message = deserialize_server_accept(payload, payload_size);             break; }
+            case PayloadType::ServerGoodbye:            { message = deserialize_server_goodbye(payload, payload_size);            break; }
+            case PayloadType::ServerGameResponse:       { message = deserialize_server_game_response(payload, payload_size);      break; }
+            case PayloadType::ServerReconnectResponse:  { message = deserialize_server_reconnect_response(payload, payload_size); break; }
             case PayloadType::FrameSnapshot:
+            case PayloadType::FrameCompact:
             {
-                const auto frame_opt = deserialize_frame(payload);
+                const auto decode_result = payload_type == PayloadType::FrameCompact
+                    ? deserialize_frame_compact_into(m_received_frame, payload, payload_size)
+                    : deserialize_frame_into(m_received_frame, payload, payload_size);
+
+                // Frames are not delivered through PacketStreamClient::poll_packet
+                message = std::nullopt;
+
+                if (decode_result)
+                {
+                    accept_frame(m_received_frame);
+                }
 
-                // or frame_opt if you want to use the frame via PacketStreamClient::poll_message
+                break;
+            }
+            case PayloadType::FrameDelta:
+            case PayloadType::FrameDeltaCompact:
+            {
                 message = std::nullopt;
 
-                if (frame_opt.has_value())
+                const auto baseline_timestamp = peek_frame_delta_baseline(payload, payload_size);
+                const FrameSnapshot* baseline = baseline_timestamp.has_value()
+                    ? m_frame_history.find(baseline_timestamp.value())
+                    : nullptr;
+
+                /*
+                    The server only encodes against frames we have acknowledged, so a missing
+                    baseline means the delta is corrupt. Dropping it is enough, the server keeps
+                    encoding against our last acknowledgement or falls back to a keyframe.
+                */
+                if (baseline == nullptr)
                 {
-                    std::lock_guard<std::mutex> lock(m_frame_mutex);
-                    m_frame_queue.push_back(frame_opt.value());
+                    std::cerr << "[PacketStreamClient] ERROR: Frame delta baseline is not available" << "\n";
+
+                    break;
+                }
+
+                const auto encoding = payload_type == PayloadType::FrameDeltaCompact
+                    ? FrameEncoding::Compact
+                    : FrameEncoding::Full;
+
+                if (deserialize_frame_delta_into(m_received_frame, *baseline, payload, payload_size, encoding))
+                {
+                    accept_frame(m_received_frame);
                 }
 
                 break;
@@ -265,13 +368,32 @@ void PacketStreamClient::process_buffer() {
             m_packet_queue.push(packet);
         }
 
-        offset += PACKET_HEADER_SIZE + header.payload_size;
+        m_buffer.consume(PACKET_HEADER_SIZE + payload_size);
     }
 
-    if (offset > 0)
+    return scan != PacketScan::Oversized;
+}
+
+void PacketStreamClient::accept_frame(FrameSnapshot& frame) {
+    m_frame_history.store(frame);
+
+    const auto ack = ClientFrameAck{ frame.timestamp };
+
     {
-        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + offset);
+        std::lock_guard<std::mutex> lock(m_frame_mutex);
+
+        // Swapped in instead of copied, 'frame' takes a recycled snapshot to decode the next one into
+        m_frame_queue.emplace_back();
+        std::swap(m_frame_queue.back(), frame);
+
+        if (!m_free_frames.empty())
+        {
+            std::swap(frame, m_free_frames.back());
+            m_free_frames.pop_back();
+        }
     }
+
+    send_packet(make_packet(ack));
 }
 
 /*
@@ -280,7 +402,16 @@ void PacketStreamClient::process_buffer() {
 PacketStreamServer::PacketStreamServer(std::shared_ptr<ClientConnection> connection)
     : m_connection(std::move(connection))
     , m_running(false)
+    , m_reactor(nullptr)
+    , m_reactor_token(0)
+    , m_buffer(SERVER_RECV_BUFFER_SIZE)
     , m_send_sequence(0)
+    , m_pending_offset(0)
+    , m_dropped_frames(0)
+    , m_frame_ack_received(false)
+    , m_acked_frame_timestamp(0)
+    , m_frame_encoding(FrameEncoding::Full)
+    , m_phase_timer(nullptr)
     , m_recv_thread_exception(nullptr)
 {}
 
@@ -292,7 +423,13 @@ void PacketStreamServer::start() {
     if (!m_running)
     {
         m_running = true;
-        m_recv_thread_exception = nullptr;
+        set_recv_exception(nullptr);
+
+        // Sends must not block here either, the pending output is flushed by the next send
+        if (!m_connection->set_non_blocking(true))
+        {
+            std::cerr << "[PacketStreamServer] ERROR: Failed to switch the connection to non-blocking mode" << "\n";
+        }
 
         m_recv_thread = std::thread([this]() {
             try
@@ -301,7 +438,7 @@ void PacketStreamServer::start() {
             }
             catch (const std::exception& e)
             {
-                m_recv_thread_exception = std::current_exception();
+                set_recv_exception(std::current_exception());
                 
                 std::cerr << "[PacketStreamServer] ERROR: Receive thread threw an exception: " << e.what() << "\n";
             }
@@ -315,6 +452,16 @@ void PacketStreamServer::stop() {
     if (m_running)
     {
         m_running = false;
+
+        // Make sure the reactor doesn't call us anymore before touching the connection
+        if (m_reactor != nullptr)
+        {
+            m_reactor->remove(m_reactor_token);
+
+            m_reactor = nullptr;
+            m_reactor_token = 0;
+        }
+
         m_connection->abort();
 
         if (m_recv_thread.joinable())
@@ -328,6 +475,9 @@ void PacketStreamServer::stop() {
                 std::cerr << "[PacketStreamServer] ERROR: Detected stream exception" << "\n";
             }
         }
+
+        // Nothing reads from the connection anymore
+        m_connection->disconnect();
     }
 }
 
@@ -335,6 +485,96 @@ bool PacketStreamServer::is_running() const {
     return m_running;
 }
 
+bool PacketStreamServer::attach(NetReactor& reactor) {
+    if (m_running || !reactor.is_running())
+    {
+        return false;
+    }
+
+    if (!m_connection->set_non_blocking(true))
+    {
+        std::cerr << "[PacketStreamServer] ERROR: Failed to switch the connection to non-blocking mode" << "\n";
+
+        return false;
+    }
+
+    m_running = true;
+    set_recv_exception(nullptr);
+
+    m_reactor_token = reactor.add(m_connection->get_native_handle(), this);
+
+    if (m_reactor_token == 0)
+    {
+        m_running = false;
+        m_connection->set_non_blocking(false);
+
+        return false;
+    }
+
+    m_reactor = &reactor;
+
+    std::cout << "[PacketStreamServer] DEBUG: Connection has been attached to the reactor" << "\n";
+
+    return true;
+}
+
+void PacketStreamServer::on_readable() {
+    // Edge-triggered, so drain the socket until it would block
+    while (m_running)
+    {
+        ssize_t bytes_read = m_connection->try_recv_data(m_buffer.write_ptr(), m_buffer.writable());
+
+        if (bytes_read == SOCKET_RECV_WOULD_BLOCK)
+        {
+            break;
+        }
+        else if (bytes_read == 0)
+        {
+            set_recv_exception(std::make_exception_ptr(
+                std::runtime_error("[PacketStreamServer] client disconnected")
+            ));
+
+            break;
+        }
+        else if (bytes_read < 0)
+        {
+            set_recv_exception(std::make_exception_ptr(
+                std::runtime_error("[PacketStreamServer] client connection reset")
+            ));
+
+            break;
+        }
+
+        m_buffer.commit(static_cast<size_t>(bytes_read));
+
+        // A forged size must not make the server allocate, the client is dropped instead
+        if (!process_buffer())
+        {
+            set_recv_exception(std::make_exception_ptr(
+                std::runtime_error("[PacketStreamServer] client sent an oversized packet")
+            ));
+
+            break;
+        }
+    }
+}
+
+void PacketStreamServer::on_writable() {
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    if (m_running && !flush_pending_output())
+    {
+        set_recv_exception(std::make_exception_ptr(
+            std::runtime_error("[PacketStreamServer] client connection reset")
+        ));
+    }
+}
+
+void PacketStreamServer::set_recv_exception(std::exception_ptr exception) {
+    std::lock_guard<std::mutex> lock(m_exception_mutex);
+    m_recv_thread_exception = std::move(exception);
+}
+
 bool PacketStreamServer::send_packet(const Packet& packet) {
     const auto actual_type = get_payload_type(packet.payload);
 
@@ -352,27 +592,26 @@ bool PacketStreamServer::send_packet(const Packet& packet) {
         return false;
     }
 
-    // Serialize the payload into bytes
-    std::vector<std::byte> payload_bytes;
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    // Serialize the payload right behind the space for the header
+    m_send_buffer.resize(PACKET_HEADER_SIZE);
 
     switch (packet.header.payload_type)
     {
-        case PayloadType::ServerAccept:             { payload_bytes = serialize_server_accept(std::get<ServerAccept>(packet.payload));                          break; }
-        case PayloadType::ServerGoodbye:            { payload_bytes = serialize_server_goodbye(std::get<ServerGoodbye>(packet.payload));                        break; }
-        case PayloadType::ServerGameResponse:       { payload_bytes = serialize_server_game_response(std::get<ServerGameResponse>(packet.payload));             break; }
-        case PayloadType::ServerReconnectResponse:  { payload_bytes = serialize_server_reconnect_response(std::get<ServerReconnectResponse>(packet.payload));   break; }
+        case PayloadType::ServerAccept:             { serialize_server_accept_into(std::get<ServerAccept>(packet.payload), m_send_buffer);                          break; }
+        case PayloadType::ServerGoodbye:            { serialize_server_goodbye_into(std::get<ServerGoodbye>(packet.payload), m_send_buffer);                        break; }
+        case PayloadType::ServerGameResponse:       { serialize_server_game_response_into(std::get<ServerGameResponse>(packet.payload), m_send_buffer);             break; }
+        case PayloadType::ServerReconnectResponse:  { serialize_server_reconnect_response_into(std::get<ServerReconnectResponse>(packet.payload), m_send_buffer);   break; }
         case PayloadType::FrameSnapshot:
         {
-            auto frame_bytes_opt = serialize_frame(std::get<FrameSnapshot>(packet.payload));
-
-            if (!frame_bytes_opt.has_value())
+            if (!serialize_frame_into(std::get<FrameSnapshot>(packet.payload), m_send_buffer))
             {
                 std::cerr << "[PacketStreamServer] ERROR: Failed to serialize frame" << "\n"
                           << "[PacketStreamServer] ERROR: The data can not be sent" << "\n";
 
                 return false;
             }
-            payload_bytes = frame_bytes_opt.value();
             break;
         }
         default:
@@ -384,22 +623,173 @@ bool PacketStreamServer::send_packet(const Packet& packet) {
         }
     }
 
-    // Create header
-    PacketHeader header = packet.header;
+    return send_buffered(packet.header, false);
+}
+
+bool PacketStreamServer::send_frame(const FrameSnapshot& frame) {
+    const FrameSnapshot* baseline = nullptr;
+
+    if (m_frame_ack_received)
+    {
+        baseline = m_sent_frames.find(m_acked_frame_timestamp);
+    }
+
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+
+    // Serialize the payload right behind the space for the header
+    m_send_buffer.resize(PACKET_HEADER_SIZE);
+
+    PacketHeader header = {};
+
+    const auto compact = m_frame_encoding == FrameEncoding::Compact;
+
+    if (baseline != nullptr)
+    {
+        header.payload_type = compact ? PayloadType::FrameDeltaCompact : PayloadType::FrameDelta;
+
+        // Repeated entity ids can't be matched against the baseline, send a keyframe
+        if (!serialize_frame_delta_into(*baseline, frame, m_send_buffer, m_frame_encoding))
+        {
+            m_send_buffer.resize(PACKET_HEADER_SIZE);
+            baseline = nullptr;
+        }
+    }
+
+    // No acknowledged baseline (new client, or the ack is too old), send a keyframe
+    if (baseline == nullptr)
+    {
+        header.payload_type = compact ? PayloadType::FrameCompact : PayloadType::FrameSnapshot;
+
+        const auto serialize_result = compact
+            ? serialize_frame_compact_into(frame, m_send_buffer)
+            : serialize_frame_into(frame, m_send_buffer);
+
+        if (!serialize_result)
+        {
+            std::cerr << "[PacketStreamServer] ERROR: Failed to serialize frame" << "\n"
+                      << "[PacketStreamServer] ERROR: The data can not be sent" << "\n";
+
+            return false;
+        }
+    }
+
+    m_sent_frames.store(frame);
+
+    if (m_phase_timer != nullptr)
+    {
+        m_phase_timer->mark(TickPhase::Serialize);
+    }
+
+    // A newer frame follows next tick, and deltas are only encoded against acknowledged frames
+    return send_buffered(header, true);
+}
+
+void PacketStreamServer::set_frame_encoding(FrameEncoding encoding) {
+    m_frame_encoding = encoding;
+}
+
+void PacketStreamServer::set_phase_timer(TickPhaseTimer* timer) {
+    m_phase_timer = timer;
+}
+
+bool PacketStreamServer::send_buffered(PacketHeader header, bool droppable) {
+    // Whatever is left of the earlier packets goes first, the stream must stay in order
+    if (!flush_pending_output())
+    {
+        return false;
+    }
+
+    const auto pending_size = m_pending_output.size() - m_pending_offset;
+
+    if (pending_size > 0 && droppable && ++m_dropped_frames <= MAX_DROPPED_FRAMES)
+    {
+        return false;
+    }
+
+    if (m_dropped_frames > MAX_DROPPED_FRAMES || pending_size + m_send_buffer.size() > MAX_PENDING_OUTPUT_SIZE)
+    {
+        std::cerr << "[PacketStreamServer] ERROR: The client doesn't read, " << pending_size << " bytes are pending" << "\n";
 
+        set_recv_exception(std::make_exception_ptr(
+            std::runtime_error("[PacketStreamServer] client stopped reading")
+        ));
+
+        return false;
+    }
+
+    // Create header
     header.magic_number     = PACKET_MAGIC_NUMBER;
     header.sequence_number  = m_send_sequence.fetch_add(1);
-    header.payload_size     = static_cast<uint32_t>(payload_bytes.size());
-    header.payload_type     = get_payload_type(packet.payload);
+    header.payload_size     = static_cast<uint32_t>(m_send_buffer.size() - PACKET_HEADER_SIZE);
+
+    serialize_packet_header_into(header, m_send_buffer.data());
+
+    if (droppable)
+    {
+        m_dropped_frames = 0;
+    }
+
+    size_t sent = 0;
+
+    // One send for header and payload, the buffer keeps its capacity for the next packet
+    if (pending_size == 0)
+    {
+        const auto result = m_connection->try_send_data(m_send_buffer.data(), m_send_buffer.size());
+
+        if (result == SOCKET_SEND_WOULD_BLOCK)
+        {
+            sent = 0;
+        }
+        else if (result <= 0)
+        {
+            return false;
+        }
+        else
+        {
+            sent = static_cast<size_t>(result);
+        }
+    }
+
+    // A partial packet is finished later, never left half written
+    if (sent < m_send_buffer.size())
+    {
+        if (m_pending_offset == m_pending_output.size())
+        {
+            m_pending_output.clear();
+            m_pending_offset = 0;
+        }
+
+        m_pending_output.insert(m_pending_output.end(), m_send_buffer.begin() + sent, m_send_buffer.end());
+    }
+
+    return true;
+}
+
+bool PacketStreamServer::flush_pending_output() {
+    while (m_pending_offset < m_pending_output.size())
+    {
+        const auto result = m_connection->try_send_data(
+            m_pending_output.data() + m_pending_offset,
+            m_pending_output.size() - m_pending_offset
+        );
 
-    auto header_bytes = serialize_packet_header(header);
+        if (result == SOCKET_SEND_WOULD_BLOCK)
+        {
+            return true;
+        }
+        else if (result <= 0)
+        {
+            return false;
+        }
 
-    std::vector<std::byte> buffer;
+        m_pending_offset += static_cast<size_t>(result);
+    }
 
-    buffer.insert(buffer.end(), header_bytes.begin(), header_bytes.end());
-    buffer.insert(buffer.end(), payload_bytes.begin(), payload_bytes.end());
+    // Keeps the capacity for the next slow client moment
+    m_pending_output.clear();
+    m_pending_offset = 0;
 
-    return m_connection->send_data(buffer) > 0;
+    return true;
 }
 
 std::optional<Packet> PacketStreamServer::poll_packet() {
@@ -417,15 +807,15 @@ std::optional<Packet> PacketStreamServer::poll_packet() {
 }
 
 std::exception_ptr PacketStreamServer::get_recv_exception() const {
+    std::lock_guard<std::mutex> lock(m_exception_mutex);
     return m_recv_thread_exception;
 }
 
 void PacketStreamServer::receive_loop() {
-    std::byte temp_buffer[TEMP_BUFFER_SIZE];
-
     while (m_running)
     {
-        ssize_t bytes_read = m_connection->recv_data(temp_buffer, TEMP_BUFFER_SIZE);
+        // Receive straight into the ring buffer
+        ssize_t bytes_read = m_connection->recv_data(m_buffer.write_ptr(), m_buffer.writable());
 
         if (bytes_read == SOCKET_RECV_TIMEOUT)
         {
@@ -445,48 +835,50 @@ void PacketStreamServer::receive_loop() {
             {
                 throw std::runtime_error("[PacketStreamServer] client connection reset");
             }
-        }
-
-        m_buffer.insert(m_buffer.end(), temp_buffer, temp_buffer + bytes_read);
-
-        process_buffer();
-    }
-}
-
-void PacketStreamServer::process_buffer() {
-    size_t offset = 0;
-
-    while (m_buffer.size() - offset >= PACKET_HEADER_SIZE)
-    {
-        PacketHeader header;
-        memcpy(&header, m_buffer.data() + offset, PACKET_HEADER_SIZE);
 
-        if (header.magic_number != PACKET_MAGIC_NUMBER)
-        {
-            offset++;
-            
             continue;
         }
 
-        if (m_buffer.size() - offset < PACKET_HEADER_SIZE + header.payload_size)
+        m_buffer.commit(static_cast<size_t>(bytes_read));
+
+        if (!process_buffer())
         {
-            break;
+            throw std::runtime_error("[PacketStreamServer] client sent an oversized packet");
         }
+    }
+}
 
-        auto payload_start = m_buffer.begin() + offset + PACKET_HEADER_SIZE;
-        auto payload_end   = payload_start + header.payload_size;
+bool PacketStreamServer::process_buffer() {
+    PacketHeader header = {};
+    PacketScan scan;
 
+    while ((scan = next_packet(m_buffer, header, socket_constants::CLIENT_MAX_PACKET_SIZE)) == PacketScan::Complete)
+    {
         const auto payload_type = static_cast<PayloadType>(header.payload_type);
-        std::vector<std::byte> payload(payload_start, payload_end);
+        const auto payload_size = static_cast<size_t>(header.payload_size);
+        const auto* payload = m_buffer.data(PACKET_HEADER_SIZE, payload_size);
         std::optional<PacketPayload> message;
 
         switch (payload_type)
         {
-            case PayloadType::ClientHello:              { message = deserialize_client_hello(payload);              break; }
-            case PayloadType::ClientGoodbye:            { message = deserialize_client_goodbye(payload);            break; }
-            case PayloadType::ClientGameRequest:        { message = deserialize_client_game_request(payload);       break; }
-            case PayloadType::ClientReconnectRequest:   { message = deserialize_client_reconnect_request(payload);  break; }
-            case PayloadType::ClientInput:              { message = deserialize_client_input(payload);              break; }
+            case PayloadType::ClientHello:              { message = deserialize_client_hello(payload, payload_size);              break; }
+            case PayloadType::ClientGoodbye:            { message = deserialize_client_goodbye(payload, payload_size);            break; }
+            case PayloadType::ClientGameRequest:        { message = deserialize_client_game_request(payload, payload_size);       break; }
+            case PayloadType::ClientReconnectRequest:   { message = deserialize_client_reconnect_request(payload, payload_size);  break; }
+            case PayloadType::ClientInput:              { message = deserialize_client_input(payload, payload_size);              break; }
+            case PayloadType::ClientFrameAck:
+            {
+                // Consumed by the stream itself, the session never sees acknowledgements
+                const auto ack_opt = deserialize_client_frame_ack(payload, payload_size);
+
+                if (ack_opt.has_value())
+                {
+                    m_acked_frame_timestamp = ack_opt.value().frame_timestamp;
+                    m_frame_ack_received = true;
+                }
+
+                break;
+            }
             default:
             {
                 std::cerr << "[PacketStreamServer] ERROR: Invalid payload type: " 
@@ -507,11 +899,8 @@ void PacketStreamServer::process_buffer() {
             m_packet_queue.push(std::move(packet));
         }
 
-        offset += PACKET_HEADER_SIZE + header.payload_size;
+        m_buffer.consume(PACKET_HEADER_SIZE + payload_size);
     }
 
-    if (offset > 0)
-    {
-        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + offset);
-    }
+    return scan != PacketScan::Oversized;
 }
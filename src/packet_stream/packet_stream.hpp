@@ -9,39 +9,51 @@
 #include <memory>
 
 #include "../socket/socket.hpp"
+#include "../socket/net_reactor.hpp"
 #include "../packet_template/packet_template.hpp"
+#include "transport.hpp"
+#include "frame_history.hpp"
+#include "ring_buffer.hpp"
 
-class PacketStreamClient {
+class PacketStreamClient : public ClientTransport {
 public:
     explicit PacketStreamClient(std::shared_ptr<ClientSocket> socket);
-    ~PacketStreamClient();
+    ~PacketStreamClient() override;
 
     // Delete copy constructor and copy assignment operator
     PacketStreamClient(const PacketStreamClient&) = delete;
     PacketStreamClient& operator=(const PacketStreamClient&) = delete;
 
-    void start();
-    void stop();
-    bool is_running() const;
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
 
     // Returns the latest frame
-    std::optional<FrameSnapshot> poll_frame();
-    std::optional<Packet> poll_packet();
+    std::optional<FrameSnapshot> poll_frame() override;
+    size_t poll_frames(std::vector<FrameSnapshot>& frames) override;
+    std::optional<Packet> poll_packet() override;
 
-    bool send_packet(const Packet& packet);
+    bool send_packet(const Packet& packet) override;
 
     // Returns std::exception_ptr if there is an exception in the receive thread
-    std::exception_ptr get_recv_exception() const;
+    std::exception_ptr get_recv_exception() const override;
 
 private:
     void receive_loop();
-    void process_buffer();
+    // Returns false on a header announcing an oversized packet, the connection must be dropped
+    bool process_buffer();
+
+    /*
+        Stores a reconstructed frame, queues it and acknowledges it to the server.
+        'frame' is swapped into the queue and left holding a recycled snapshot.
+    */
+    void accept_frame(FrameSnapshot& frame);
 
     std::shared_ptr<ClientSocket>   m_socket;
     std::atomic<bool>               m_running;
     std::thread                     m_recv_thread;
     
-    std::vector<std::byte>          m_buffer;
+    RingBuffer                      m_buffer;
 
     /*
         Packet Queue (Frame Snapshot Only)
@@ -49,9 +61,22 @@ private:
         they prioritize drawing the latest frame over guaranteeing arrival,
         so they have a dedicated queue. (For example, if there are multiple frames in the queue,
         the drawing thread will only get the latest frame in the queue and discard the rest.)
+        'poll_frames()' drains the whole queue instead, for the snapshot interpolation.
+        Decoded frames are swapped in, and the drained snapshots go back to the free list.
     */
     std::mutex                      m_frame_mutex;
     std::deque<FrameSnapshot>       m_frame_queue;
+    std::vector<FrameSnapshot>      m_free_frames;
+
+    // Baselines for FrameDelta packets (receive thread only)
+    FrameHistory                    m_frame_history;
+
+    // Every frame is decoded into this one, then swapped with a recycled snapshot (receive thread only)
+    FrameSnapshot                   m_received_frame;
+
+    // The receive thread sends acknowledgements, so sending is serialized
+    std::mutex                      m_send_mutex;
+    std::vector<std::byte>          m_send_buffer;
 
     // Packet queue (General)
     std::mutex                      m_packet_mutex;
@@ -62,34 +87,70 @@ private:
     std::exception_ptr              m_recv_thread_exception;
 };
 
-class PacketStreamServer {
+class PacketStreamServer : public ReactorHandler, public ServerTransport {
 public:
     explicit PacketStreamServer(std::shared_ptr<ClientConnection> connection);
-    ~PacketStreamServer();
+    ~PacketStreamServer() override;
 
     // Delete copy constructor and copy assignment operator
     PacketStreamServer(const PacketStreamServer&) = delete;
     PacketStreamServer& operator=(const PacketStreamServer&) = delete;
 
-    void start();
-    void stop();
-    bool is_running() const;
+    void start() override;
+    void stop() override;
+    bool is_running() const override;
+
+    /*
+        Registers the connection with a reactor instead of starting a receive thread.
+        Returns false if the reactor is unavailable, in which case 'start()' should be used.
+    */
+    bool attach(NetReactor& reactor) override;
+
+    std::optional<Packet> poll_packet() override;
+    bool send_packet(const Packet& packet) override;
+
+    /*
+        Sends a frame as a FrameDelta against the last frame the client has acknowledged,
+        or as a full FrameSnapshot (keyframe) when no such baseline is available.
+        Clients that never acknowledge frames therefore only ever receive keyframes.
+    */
+    bool send_frame(const FrameSnapshot& frame) override;
 
-    std::optional<Packet> poll_packet();
-    bool send_packet(const Packet& packet);
+    // FrameEncoding::Compact sends FrameCompact and FrameDeltaCompact instead
+    void set_frame_encoding(FrameEncoding encoding) override;
+    void set_phase_timer(TickPhaseTimer* timer) override;
 
     // Returns std::exception_ptr if there is an exception in the receive thread
-    std::exception_ptr get_recv_exception() const;
+    std::exception_ptr get_recv_exception() const override;
+
+    // Called by NetReactor on an I/O thread
+    void on_readable() override;
+    void on_writable() override;
 
 private:
     void receive_loop();
-    void process_buffer();
+    // Returns false on a header announcing an oversized packet, the connection must be dropped
+    bool process_buffer();
+    void set_recv_exception(std::exception_ptr exception);
+
+    /*
+        Sends 'm_send_buffer' (header space + payload) without blocking, 'm_send_mutex' must be held.
+        What the socket doesn't take is kept in 'm_pending_output', a 'droppable' packet (a frame)
+        is dropped instead while older data is still pending.
+    */
+    bool send_buffered(PacketHeader header, bool droppable);
+
+    // Returns false if the connection failed, 'm_send_mutex' must be held
+    bool flush_pending_output();
 
     std::shared_ptr<ClientConnection>   m_connection;
     std::atomic<bool>                   m_running;
     std::thread                         m_recv_thread;
 
-    std::vector<std::byte>              m_buffer;
+    NetReactor*                         m_reactor;
+    uint64_t                            m_reactor_token;
+
+    RingBuffer                          m_buffer;
 
     // Packet queue
     std::mutex                          m_packet_mutex;
@@ -97,5 +158,27 @@ private:
 
     std::atomic<uint32_t>               m_send_sequence;
 
+    // Reused for every packet, so sending does not allocate once it has grown
+    std::mutex                          m_send_mutex;
+    std::vector<std::byte>              m_send_buffer;
+
+    /*
+        Bytes the socket didn't take yet, sent before anything else on the next send or
+        when the reactor reports the socket writable. The tick thread never waits on a slow client.
+    */
+    std::vector<std::byte>              m_pending_output;
+    size_t                              m_pending_offset;
+    uint32_t                            m_dropped_frames;
+
+    // Frames sent so far and the latest one acknowledged by the client
+    FrameHistory                        m_sent_frames;
+    std::atomic<bool>                   m_frame_ack_received;
+    std::atomic<uint32_t>               m_acked_frame_timestamp;
+    std::atomic<FrameEncoding>          m_frame_encoding;
+
+    // Owned by the session, only used by 'send_frame()' on the tick thread
+    TickPhaseTimer*                     m_phase_timer;
+
+    mutable std::mutex                  m_exception_mutex;
     std::exception_ptr                  m_recv_thread_exception;
 };
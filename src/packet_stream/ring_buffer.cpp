@@ -0,0 +1,103 @@
+#include <cstring>
+#include <algorithm>
+#include "ring_buffer.hpp"
+
+namespace {
+    size_t round_up_to_power_of_two(size_t value) {
+        size_t result = 1;
+
+        while (result < value)
+        {
+            result <<= 1;
+        }
+
+        return result;
+    }
+}
+
+RingBuffer::RingBuffer(size_t capacity)
+    : m_storage(round_up_to_power_of_two(std::max<size_t>(capacity, 1)))
+    , m_read_position(0)
+    , m_write_position(0)
+    , m_mask(m_storage.size() - 1)
+{}
+
+std::byte* RingBuffer::write_ptr() {
+    return m_storage.data() + (m_write_position & m_mask);
+}
+
+size_t RingBuffer::writable() const {
+    const auto free_space = capacity() - size();
+    const auto until_end = capacity() - static_cast<size_t>(m_write_position & m_mask);
+
+    return std::min(free_space, until_end);
+}
+
+void RingBuffer::commit(size_t size) {
+    m_write_position += size;
+}
+
+void RingBuffer::peek(void* dest, size_t offset, size_t size) const {
+    const auto start = static_cast<size_t>((m_read_position + offset) & m_mask);
+    const auto first = std::min(size, capacity() - start);
+
+    memcpy(dest, m_storage.data() + start, first);
+    memcpy(static_cast<std::byte*>(dest) + first, m_storage.data(), size - first);
+}
+
+const std::byte* RingBuffer::data(size_t offset, size_t size) {
+    const auto start = static_cast<size_t>((m_read_position + offset) & m_mask);
+
+    if (start + size <= capacity())
+    {
+        return m_storage.data() + start;
+    }
+
+    // Wraps around the end, linearize into the scratch buffer
+    if (m_scratch.size() < size)
+    {
+        m_scratch.resize(size);
+    }
+
+    peek(m_scratch.data(), offset, size);
+
+    return m_scratch.data();
+}
+
+void RingBuffer::consume(size_t size) {
+    m_read_position += std::min(size, this->size());
+}
+
+void RingBuffer::clear() {
+    m_read_position = 0;
+    m_write_position = 0;
+}
+
+void RingBuffer::reserve(size_t capacity) {
+    if (capacity <= this->capacity())
+    {
+        return;
+    }
+
+    const auto content_size = size();
+    std::vector<std::byte> storage(round_up_to_power_of_two(capacity));
+
+    peek(storage.data(), 0, content_size);
+
+    m_storage = std::move(storage);
+    m_read_position = 0;
+    m_write_position = content_size;
+    m_mask = m_storage.size() - 1;
+}
+
+size_t RingBuffer::size() const {
+    return static_cast<size_t>(m_write_position - m_read_position);
+}
+
+size_t RingBuffer::capacity() const {
+    return m_storage.size();
+}
+
+bool RingBuffer::empty() const {
+    return m_write_position == m_read_position;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Byte ring buffer for the receive path of the packet streams.
+
+    'recv' writes straight into the free space ('write_ptr' / 'writable'),
+    and packets are read in place ('data'), so nothing is copied on the way
+    to the deserializers and nothing is erased from the front.
+    Only a packet that wraps around the end of the storage is copied,
+    into a scratch buffer that is reused for the lifetime of the ring.
+
+    The capacity is fixed, except for 'reserve', which is used when a single
+    packet does not fit. It's not thread safe.
+*/
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity);
+
+    // Contiguous free space to receive into, may be smaller than the total free space
+    std::byte* write_ptr();
+    size_t writable() const;
+
+    // Marks 'size' bytes at 'write_ptr()' as received
+    void commit(size_t size);
+
+    // Copies 'size' bytes starting 'offset' bytes after the read position
+    void peek(void* dest, size_t offset, size_t size) const;
+
+    /*
+        Returns 'size' contiguous bytes starting 'offset' bytes after the read position.
+        The pointer stays valid until the next call to 'data', 'consume' or 'reserve'.
+    */
+    const std::byte* data(size_t offset, size_t size);
+
+    void consume(size_t size);
+    void clear();
+
+    // Grows the storage to hold at least 'capacity' bytes, keeping the content
+    void reserve(size_t capacity);
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+private:
+    std::vector<std::byte>  m_storage;
+    std::vector<std::byte>  m_scratch;
+
+    // Monotonic positions, the index into the storage is 'position & m_mask'
+    uint64_t                m_read_position;
+    uint64_t                m_write_position;
+    uint64_t                m_mask;
+};
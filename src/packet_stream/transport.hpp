@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <exception>
+#include "../packet_template/packet_template.hpp"
+
+class NetReactor;
+class TickPhaseTimer;
+
+/*
+    Client end of a connection to the game server.
+    Implemented by PacketStreamClient (TCP) and LoopbackClientTransport (in-process).
+*/
+class ClientTransport {
+public:
+    virtual ~ClientTransport() = default;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool is_running() const = 0;
+
+    // Returns the latest frame
+    virtual std::optional<FrameSnapshot> poll_frame() = 0;
+
+    // Moves every queued frame to the back of 'frames' in arrival order, returns the number of frames
+    virtual size_t poll_frames(std::vector<FrameSnapshot>& frames) = 0;
+
+    virtual std::optional<Packet> poll_packet() = 0;
+
+    virtual bool send_packet(const Packet& packet) = 0;
+
+    // Returns std::exception_ptr if the connection has failed
+    virtual std::exception_ptr get_recv_exception() const = 0;
+};
+
+/*
+    Server end of a connection, owned by a GameSession.
+    Implemented by PacketStreamServer (TCP) and LoopbackServerTransport (in-process).
+*/
+class ServerTransport {
+public:
+    virtual ~ServerTransport() = default;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool is_running() const = 0;
+
+    // Returns false if the transport can't be driven by the reactor, 'start()' should be used then
+    virtual bool attach(NetReactor& reactor) = 0;
+
+    virtual std::optional<Packet> poll_packet() = 0;
+    virtual bool send_packet(const Packet& packet) = 0;
+    virtual bool send_frame(const FrameSnapshot& frame) = 0;
+
+    // Encoding of the following frames, as negotiated by the session handshake
+    virtual void set_frame_encoding(FrameEncoding encoding) = 0;
+
+    // 'send_frame()' marks TickPhase::Serialize on 'timer' once the frame is encoded, nullptr stops it
+    virtual void set_phase_timer(TickPhaseTimer* timer) = 0;
+
+    // Returns std::exception_ptr if the connection has failed
+    virtual std::exception_ptr get_recv_exception() const = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Datagram channel
+
+    Runs next to the packet stream, which still carries the handshake and goodbye messages.
+    Frames and inputs go over datagrams instead, so a lost datagram never holds back the
+    ones behind it.
+*/
+
+// A magic number to reject stray datagrams
+constexpr uint32_t DATAGRAM_MAGIC_NUMBER = 0x2C6E91B4;
+
+// Datagrams stay below the usual path MTU, so the network never fragments them
+constexpr size_t MAX_DATAGRAM_SIZE = 1200;
+
+enum class DatagramType : uint8_t {
+    Bind,           // Client -> Server: tells the server where to send frames
+    Input,          // Client -> Server: the latest ClientInputs, newest last
+    Frame,          // Server -> Client: one fragment of a FrameSnapshot or FrameDelta
+    FrameAck        // Client -> Server: ClientFrameAck
+};
+
+/*
+    Datagram header (24bytes)
+*/
+struct DatagramHeader {
+    uint32_t        magic_number;
+    uint32_t        sequence;           // Per sender, shared by the fragments of one frame
+    uint64_t        token;              // ServerAccept::datagram_token
+    DatagramType    type;
+    uint8_t         fragment_index;
+    uint8_t         fragment_count;
+    uint8_t         reserved[5];
+};
+
+constexpr size_t DATAGRAM_HEADER_SIZE = 24;
+static_assert(sizeof(DatagramHeader) == DATAGRAM_HEADER_SIZE);
+
+constexpr size_t MAX_DATAGRAM_PAYLOAD_SIZE = MAX_DATAGRAM_SIZE - DATAGRAM_HEADER_SIZE;
+
+// Bigger frames fall back to the packet stream
+constexpr size_t MAX_FRAME_FRAGMENTS = 255;
@@ -3,6 +3,7 @@
 #include <string>
 #include "frame/frame_enums.hpp"
 #include "frame/frame_structs.hpp"
+#include "frame/frame_view.hpp"
 
 std::string frame_to_json_str(const FrameSnapshot& frame);
 void print_frame(const FrameSnapshot& frame);
\ No newline at end of file
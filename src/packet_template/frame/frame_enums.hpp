@@ -218,4 +218,15 @@ inline ItemState operator&(ItemState lhs, ItemState rhs) {
     return static_cast<ItemState>(
         static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs)
     );
-}
\ No newline at end of file
+}
+/*
+    Frame encoding, negotiated by ClientHello and ServerAccept
+*/
+enum class FrameEncoding : uint8_t {
+    Full,       // Entities as their snapshot structs
+    Compact     // Quantized and bit-packed entities, see compact_entity_codec.hpp
+};
+
+constexpr uint32_t frame_encoding_bit(FrameEncoding encoding) {
+    return 1u << static_cast<uint32_t>(encoding);
+}
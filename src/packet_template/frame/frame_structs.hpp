@@ -105,6 +105,14 @@ struct BossSnapshot {
 constexpr size_t BOSS_SNAPSHOT_SIZE = 36;
 static_assert(sizeof(BossSnapshot) == BOSS_SNAPSHOT_SIZE);
 
+/*
+    Bullet owners, the values of BulletSnapshot::owner
+*/
+enum BulletOwner : uint8_t {
+    BULLET_OWNER_ENEMY      = 0,        // Hits players
+    BULLET_OWNER_PLAYER     = 1,        // Hits enemies and bosses
+};
+
 /*
     Bullet snapshot (32bytes)
 */
@@ -158,7 +166,10 @@ struct FrameSnapshot {
     GameDifficulty  difficulty;
     GameState       state;
 
-    /***** 16 bytes total *****/
+    // Sequence of the last ClientInput applied to the player
+    uint32_t        last_input_sequence;
+
+    /***** 24 bytes total *****/
 
     // Stage snapshot               [8bytes]
     StageSnapshot                   stage;
@@ -184,4 +195,16 @@ struct FrameSnapshot {
     std::vector<ItemSnapshot>       item_vector;
 };
 
-constexpr size_t FRAME_SNAPSHOT_FIXED_HEADER_SIZE = 20;
+constexpr size_t FRAME_SNAPSHOT_FIXED_HEADER_SIZE = 24;
+
+/*
+    Frame acknowledgement (4bytes)
+    Sent by the client for every frame it has reconstructed, so the server
+    can use that frame as the baseline of the next FrameDelta
+*/
+struct ClientFrameAck {
+    uint32_t    frame_timestamp;
+};
+
+constexpr size_t CLIENT_FRAME_ACK_SIZE = 4;
+static_assert(sizeof(ClientFrameAck) == CLIENT_FRAME_ACK_SIZE);
@@ -0,0 +1,83 @@
+#include <cstring>
+#include "frame_view.hpp"
+
+namespace {
+    /*
+        Takes [uint32 count][T * count] at 'src' and advances it.
+        The count is checked against the rest of the payload, nothing is copied.
+    */
+    template <typename T>
+    bool take_entities(EntitySpan<T>& entities, const std::byte*& src, const std::byte* end) {
+        uint32_t count;
+
+        if (static_cast<size_t>(end - src) < sizeof(count))
+        {
+            return false;
+        }
+
+        memcpy(&count, src, sizeof(count));
+        src += sizeof(count);
+
+        if (static_cast<size_t>(end - src) / sizeof(T) < count)
+        {
+            return false;
+        }
+
+        entities = EntitySpan<T>(src, count);
+        src += sizeof(T) * count;
+
+        return true;
+    }
+}
+
+std::optional<FrameView> FrameView::parse(const std::byte* bytes, size_t size) {
+    if (size < FRAME_SNAPSHOT_FIXED_HEADER_SIZE + STAGE_SNAPSHOT_SIZE)
+    {
+        return std::nullopt;
+    }
+
+    const auto bytes_end = bytes + size;
+    auto bytes_offset = bytes;
+
+    FrameView view;
+
+    memcpy(&view.m_header, bytes_offset, FRAME_SNAPSHOT_FIXED_HEADER_SIZE);
+    bytes_offset += FRAME_SNAPSHOT_FIXED_HEADER_SIZE;
+
+    memcpy(&view.m_stage, bytes_offset, STAGE_SNAPSHOT_SIZE);
+    bytes_offset += STAGE_SNAPSHOT_SIZE;
+
+    const auto valid = take_entities(view.m_players, bytes_offset, bytes_end)
+        && take_entities(view.m_enemies, bytes_offset, bytes_end)
+        && take_entities(view.m_bosses,  bytes_offset, bytes_end)
+        && take_entities(view.m_bullets, bytes_offset, bytes_end)
+        && take_entities(view.m_items,   bytes_offset, bytes_end);
+
+    if (!valid)
+    {
+        return std::nullopt;
+    }
+
+    return view;
+}
+
+FrameView::FrameView(const FrameSnapshot& frame)
+    : m_stage(frame.stage)
+    , m_players(frame.player_vector)
+    , m_enemies(frame.enemy_vector)
+    , m_bosses(frame.boss_vector)
+    , m_bullets(frame.bullet_vector)
+    , m_items(frame.item_vector)
+{
+    // The header is the first 24 bytes of FrameSnapshot, as in 'serialize_frame_into()'
+    memcpy(&m_header, &frame, FRAME_SNAPSHOT_FIXED_HEADER_SIZE);
+}
+
+size_t FrameView::sprite_count() const {
+    return 1 + // stage
+        static_cast<size_t>(m_players.size()) +
+        m_enemies.size() +
+        m_bosses.size() +
+        m_bullets.size() +
+        m_items.size();
+}
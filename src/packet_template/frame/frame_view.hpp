@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include "frame_enums.hpp"
+#include "frame_structs.hpp"
+
+/*
+    Read-only run of entity snapshots somewhere in memory, e.g. inside a received payload.
+    The bytes don't have to be aligned for T, entities are copied out one at a time.
+*/
+template <typename T>
+class EntitySpan {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = T;
+
+        explicit Iterator(const std::byte* position) : m_position(position) {}
+
+        T operator*() const {
+            T entity;
+            memcpy(&entity, m_position, sizeof(T));
+
+            return entity;
+        }
+
+        Iterator& operator++() {
+            m_position += sizeof(T);
+
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_position == other.m_position; }
+        bool operator!=(const Iterator& other) const { return m_position != other.m_position; }
+
+    private:
+        const std::byte* m_position;
+    };
+
+    EntitySpan() : m_data(nullptr), m_count(0) {}
+    EntitySpan(const std::byte* data, uint32_t count) : m_data(data), m_count(count) {}
+
+    explicit EntitySpan(const std::vector<T>& entities)
+        : m_data(reinterpret_cast<const std::byte*>(entities.data()))
+        , m_count(static_cast<uint32_t>(entities.size()))
+    {}
+
+    uint32_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    T operator[](size_t index) const {
+        T entity;
+        memcpy(&entity, m_data + index * sizeof(T), sizeof(T));
+
+        return entity;
+    }
+
+    Iterator begin() const { return Iterator(m_data); }
+    Iterator end() const { return Iterator(m_data + static_cast<size_t>(m_count) * sizeof(T)); }
+
+    // Overwrites 'out', reusing its capacity
+    void copy_to(std::vector<T>& out) const {
+        out.resize(m_count);
+
+        if (m_count > 0)
+        {
+            memcpy(out.data(), m_data, static_cast<size_t>(m_count) * sizeof(T));
+        }
+    }
+
+private:
+    const std::byte*    m_data;
+    uint32_t            m_count;
+};
+
+/*
+    The fixed header of a frame, laid out as on the wire (24bytes)
+*/
+struct FrameViewHeader {
+    uint32_t        client_id;
+    uint32_t        opponent_id;
+    uint32_t        timestamp;
+    uint32_t        score;
+
+    GameMode        mode;
+    GameVariant     variant;
+    GameDifficulty  difficulty;
+    GameState       state;
+
+    uint32_t        last_input_sequence;
+};
+
+static_assert(sizeof(FrameViewHeader) == FRAME_SNAPSHOT_FIXED_HEADER_SIZE);
+
+/*
+    Non-owning view of a frame, over a FrameSnapshot payload or over a FrameSnapshot.
+
+    'parse()' checks every count against the payload once, after that the spans can be
+    read without further bounds checks. The view is valid as long as the bytes or the
+    frame it was made from are unchanged.
+*/
+class FrameView {
+public:
+    // Returns std::nullopt if the payload is truncated or a count exceeds it
+    static std::optional<FrameView> parse(const std::byte* bytes, size_t size);
+
+    explicit FrameView(const FrameSnapshot& frame);
+
+    const FrameViewHeader& header() const { return m_header; }
+    const StageSnapshot& stage() const { return m_stage; }
+
+    EntitySpan<PlayerSnapshot>  players() const { return m_players; }
+    EntitySpan<EnemySnapshot>   enemies() const { return m_enemies; }
+    EntitySpan<BossSnapshot>    bosses() const  { return m_bosses; }
+    EntitySpan<BulletSnapshot>  bullets() const { return m_bullets; }
+    EntitySpan<ItemSnapshot>    items() const   { return m_items; }
+
+    // Every entity plus the stage
+    size_t sprite_count() const;
+
+private:
+    FrameView() = default;
+
+    FrameViewHeader             m_header;
+    StageSnapshot               m_stage;
+
+    EntitySpan<PlayerSnapshot>  m_players;
+    EntitySpan<EnemySnapshot>   m_enemies;
+    EntitySpan<BossSnapshot>    m_bosses;
+    EntitySpan<BulletSnapshot>  m_bullets;
+    EntitySpan<ItemSnapshot>    m_items;
+};
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include "greeting_enums.hpp"
+#include "../frame/frame_enums.hpp"
 
 constexpr uint32_t MAX_CLIENT_NAME_SIZE = 32;
 
@@ -11,9 +12,12 @@ constexpr uint32_t MAX_CLIENT_NAME_SIZE = 32;
 struct ClientHello {
     uint32_t client_name_size;
     char client_name[MAX_CLIENT_NAME_SIZE];
+
+    // frame_encoding_bit() of every FrameEncoding the client decodes, Full is always supported
+    uint32_t frame_encodings;
 };
 
-constexpr size_t CLIENT_HELLO_SIZE = 36;
+constexpr size_t CLIENT_HELLO_SIZE = 40;
 static_assert(sizeof(ClientHello) == CLIENT_HELLO_SIZE);
 
 /*
@@ -21,8 +25,18 @@ static_assert(sizeof(ClientHello) == CLIENT_HELLO_SIZE);
 */
 struct ServerAccept {
     uint32_t assigned_client_id;
+
+    // Encoding of the frames of this session, picked from ClientHello::frame_encodings
+    FrameEncoding frame_encoding;
+    uint8_t reserved[3];
+
+    // Identifies the session on the datagram channel, 0 if the server has no datagram channel
+    uint64_t datagram_token;
 };
 
+constexpr size_t SERVER_ACCEPT_SIZE = 16;
+static_assert(sizeof(ServerAccept) == SERVER_ACCEPT_SIZE);
+
 /*
     Goodbye
 */
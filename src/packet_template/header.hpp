@@ -22,6 +22,10 @@ enum class PayloadType : uint32_t {
     ServerReconnectResponse,
     ClientInput,
     FrameSnapshot,
+    FrameDelta,         // FrameSnapshot encoded against a baseline the client has acknowledged
+    ClientFrameAck,
+    FrameCompact,       // FrameSnapshot in FrameEncoding::Compact
+    FrameDeltaCompact,  // FrameDelta in FrameEncoding::Compact
     // Chat,
     // Info,
     // Error
@@ -15,6 +15,10 @@
 struct ClientInput {
     uint32_t    client_id;
     uint32_t    frame_timestamp;
+
+    // Increases by one per input, the server echoes the last applied one in FrameSnapshot
+    uint32_t    input_sequence;
+
     GameInput   game_input;
 };
 
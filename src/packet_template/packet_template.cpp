@@ -14,6 +14,7 @@ PayloadType get_payload_type(const PacketPayload& payload) {
         else if constexpr (std::is_same_v<T, ServerReconnectResponse>)  return PayloadType::ServerReconnectResponse;
         else if constexpr (std::is_same_v<T, ClientInput>)              return PayloadType::ClientInput;
         else if constexpr (std::is_same_v<T, FrameSnapshot>)            return PayloadType::FrameSnapshot;
+        else if constexpr (std::is_same_v<T, ClientFrameAck>)           return PayloadType::ClientFrameAck;
         else                                                            return PayloadType::Unknown;
     }, payload);
 }
\ No newline at end of file
@@ -17,7 +17,8 @@ using PacketPayload = std::variant<
     ClientReconnectRequest,
     ServerReconnectResponse,
     FrameSnapshot,
-    ClientInput
+    ClientInput,
+    ClientFrameAck
 >;
 
 struct Packet {
@@ -0,0 +1,69 @@
+#include "player_predictor.hpp"
+#include "../game_server/player_movement.hpp"
+
+namespace {
+    // Stop predicting ahead if the server hasn't acknowledged anything for this many inputs (two seconds)
+    constexpr size_t MAX_PENDING_INPUTS = 2 * game_logic_constants::TICK_RATE;
+}
+
+PlayerPredictor::PlayerPredictor()
+    : m_next_sequence(1)
+    , m_last_timestamp(0)
+    , m_has_state(false)
+    , m_player{}
+{}
+
+uint32_t PlayerPredictor::apply_input(const ArrowState& arrows) {
+    const auto sequence = m_next_sequence++;
+    const auto direction = get_direction_from_arrows(arrows);
+
+    if (m_pending_inputs.size() >= MAX_PENDING_INPUTS)
+    {
+        m_pending_inputs.pop_front();
+    }
+
+    m_pending_inputs.push_back(PendingInput{ sequence, direction });
+
+    if (m_has_state)
+    {
+        apply_player_input(m_player, direction);
+    }
+
+    return sequence;
+}
+
+void PlayerPredictor::reconcile(const FrameSnapshot& frame) {
+    if (frame.player_vector.empty() || (m_has_state && frame.timestamp <= m_last_timestamp))
+    {
+        return;
+    }
+
+    // Drop the inputs the server has already applied
+    while (!m_pending_inputs.empty() && m_pending_inputs.front().sequence <= frame.last_input_sequence)
+    {
+        m_pending_inputs.pop_front();
+    }
+
+    // Replay the rest on top of the authoritative state
+    m_player = frame.player_vector[0];
+
+    for (const auto& input : m_pending_inputs)
+    {
+        apply_player_input(m_player, input.direction);
+    }
+
+    m_last_timestamp = frame.timestamp;
+    m_has_state = true;
+}
+
+bool PlayerPredictor::has_state() const {
+    return m_has_state;
+}
+
+const PlayerSnapshot& PlayerPredictor::get_player() const {
+    return m_player;
+}
+
+size_t PlayerPredictor::pending_count() const {
+    return m_pending_inputs.size();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <cstdint>
+#include "../packet_template/frame.hpp"
+#include "../input_manager/input_snapshot.hpp"
+
+/*
+    Client side prediction of the local player.
+
+    Every input is one tick of movement, applied locally right away with the same
+    'apply_player_input()' the server runs, and kept until a frame acknowledges its sequence.
+    On each frame the player is reset to the acknowledged server state and the
+    unacknowledged inputs are replayed on top of it, so the ship moves without waiting
+    a round trip and still converges to the server.
+
+    The server applies one input per tick and repeats the last direction while none arrives,
+    the client sends one per tick and a stop on release so both run the same steps.
+*/
+class PlayerPredictor {
+public:
+    PlayerPredictor();
+
+    // Applies one tick of 'arrows' and returns the sequence to send with the ClientInput
+    uint32_t apply_input(const ArrowState& arrows);
+
+    // Rebases the prediction on 'frame', older frames than the last reconciled one are ignored
+    void reconcile(const FrameSnapshot& frame);
+
+    // False until the first frame with a player has been reconciled
+    bool has_state() const;
+    const PlayerSnapshot& get_player() const;
+
+    // Inputs sent but not yet applied by the server
+    size_t pending_count() const;
+
+private:
+    struct PendingInput {
+        uint32_t        sequence;
+        InputDirection  direction;
+    };
+
+    std::deque<PendingInput>    m_pending_inputs;
+    uint32_t                    m_next_sequence;
+    uint32_t                    m_last_timestamp;
+
+    bool                        m_has_state;
+    PlayerSnapshot              m_player;
+};
@@ -4,9 +4,25 @@
 #include "../transformer/transformer.hpp"
 #include "../game_server/game_logic_constants.hpp"
 
+namespace {
+    constexpr size_t SPRITE_TYPE_COUNT = static_cast<size_t>(SpriteType::Item) + 1;
+    constexpr size_t SPRITE_NAME_COUNT = 256;
+
+    constexpr auto IDLE_ANIMATION = "idle";
+
+    size_t sprite_lookup_index(SpriteType type, uint8_t name) {
+        return static_cast<size_t>(type) * SPRITE_NAME_COUNT + name;
+    }
+}
+
 bool RenderableResolver::load_sprites(sol::state& lua, const std::string& registry_path) {
-    // Clear sprite cache
-    m_sprite_cache.clear();
+    // Clear the tables
+    m_animation_table.clear();
+    m_sprite_lookup.assign(SPRITE_TYPE_COUNT * SPRITE_NAME_COUNT, -1);
+    m_animation_ids.clear();
+    m_animation_names.clear();
+
+    m_idle_animation = get_animation_id(IDLE_ANIMATION);
 
     // Clear resource cache
     m_mesh_factory.clear_cache();
@@ -21,61 +37,117 @@ bool RenderableResolver::load_sprites(sol::state& lua, const std::string& regist
         return false;
     }
 
-    for (const auto& sprite : sprites_opt.value())
+    const auto& sprites = sprites_opt.value();
+
+    // Number the animations first, every sprite gets a slot for each of them
+    for (const auto& sprite : sprites)
     {
-        const auto mesh_name = std::string(assets_constants::MESH_DIR) + "/" + sprite.dimensions.mesh;
+        for (const auto& anim : sprite.animations)
+        {
+            get_animation_id(anim.first);
+        }
+    }
 
-        // Load mesh
-        m_mesh_factory.load_mesh(lua, mesh_name);
+    const auto animation_count = m_animation_names.size();
+    m_animation_table.resize(sprites.size() * animation_count);
 
-        // Load shader
-        for (const auto& anim : sprite.animations)
+    for (size_t sprite_index = 0; sprite_index < sprites.size(); sprite_index++)
+    {
+        const auto& sprite = sprites[sprite_index];
+
+        if (static_cast<size_t>(sprite.type) >= SPRITE_TYPE_COUNT)
         {
-            const auto shader_name = std::string(assets_constants::SHADER_DIR) + "/" + anim.second.shader;
-            m_shader_factory.load_shader(lua, shader_name);
+            std::cerr << "[RenderableResolver] ERROR: Invalid sprite type: " << static_cast<int>(sprite.type) << "\n";
+
+            continue;
         }
 
+        const auto first_slot = sprite_index * animation_count;
+        m_sprite_lookup[sprite_lookup_index(sprite.type, sprite.name)] = static_cast<int32_t>(first_slot);
+
+        const auto mesh_name = std::string(assets_constants::MESH_DIR) + "/" + sprite.dimensions.mesh;
         const auto texture_name = std::string(assets_constants::TEXTURE_DIR) + "/" + sprite.texture_atlas.image;
 
-        // Load texture
+        // Load mesh and texture
+        m_mesh_factory.load_mesh(lua, mesh_name);
         m_texture_factory.load_texture(texture_name);
 
-        // Create a tag for the sprite
-        auto tag = SpriteTag {
-            sprite.type,
-            sprite.name,
-            0
-        };
+        const auto mesh = m_mesh_factory.get_mesh(mesh_name);
+        const auto texture = m_texture_factory.get_texture(texture_name);
+
+        if (mesh == nullptr)
+        {
+            std::cerr << "[RenderableResolver] ERROR: Failed to resolve resource: " << mesh_name << "\n";
+
+            continue;
+        }
+
+        if (texture == nullptr)
+        {
+            std::cerr << "[RenderableResolver] ERROR: Failed to resolve texture: " << texture_name << "\n";
+
+            continue;
+        }
+
+        // Calculate the sprite scale based on the view port size (px)
+        const auto scale = glm::vec2(
+            sprite.dimensions.width / game_logic_constants::GAME_WIDTH * sprite.dimensions.scale,
+            sprite.dimensions.height / game_logic_constants::GAME_HEIGHT * sprite.dimensions.scale
+        );
+
+        for (const auto& [anim_name, anim] : sprite.animations)
+        {
+            const auto shader_name = std::string(assets_constants::SHADER_DIR) + "/" + anim.shader;
+
+            // Load shader
+            m_shader_factory.load_shader(lua, shader_name);
+
+            const auto shader = m_shader_factory.get_shader(shader_name);
+
+            if (shader == nullptr)
+            {
+                std::cerr << "[RenderableResolver] ERROR: Failed to resolve shader: " << shader_name << "\n";
+
+                continue;
+            }
+
+            // Resolve texture region
+            auto region = SpriteTextureRegion{ 0.0f, 0.0f, 1.0f, 1.0f };
+            auto region_pair = sprite.texture_atlas.regions.find(anim.region);
+
+            if (region_pair != sprite.texture_atlas.regions.end())
+            {
+                region = region_pair->second;
+            }
+
+            auto& slot = m_animation_table[first_slot + m_animation_ids[anim_name]];
 
-        // Register the sprite
-        m_sprite_cache[tag] = sprite;
+            slot.resource   = RenderableResource{ mesh, shader, texture };
+            slot.scale      = scale;
+            slot.uv_region  = glm::vec4(region.u0, region.v0, region.u1, region.v1);
+            slot.valid      = true;
+        }
     }
 
     return true;
 }
 
-std::vector<RenderableInstance> RenderableResolver::resolve(const FrameSnapshot& frame) {
-    const auto sprite_count = 1 + // stage
-            frame.player_count +
-            frame.enemy_count  +
-            frame.boss_count   +
-            frame.bullet_count +
-            frame.item_count;
+void RenderableResolver::resolve(const FrameView& frame, std::vector<RenderableInstance>& renderable_instances) {
+    const auto sprite_count = frame.sprite_count();
 
-    auto renderable_instances = std::vector<RenderableInstance>{};
+    renderable_instances.clear();
     renderable_instances.reserve(sprite_count);
 
     // Stage
     {
-        auto stage = frame.stage;
-        auto instance_opt = make_instance(stage);
+        auto instance_opt = make_instance(frame.stage());
 
         if (instance_opt.has_value())
             renderable_instances.push_back(instance_opt.value());
     }
 
     // Players
-    for (const auto& player : frame.player_vector)
+    for (const auto player : frame.players())
     {
         auto instance_opt = make_instance(player);
 
@@ -84,7 +156,7 @@ std::vector<RenderableInstance> RenderableResolver::resolve(const FrameSnapshot&
     }
 
     // Enemies
-    for (const auto& enemy : frame.enemy_vector)
+    for (const auto enemy : frame.enemies())
     {
         auto instance_opt = make_instance(enemy);
 
@@ -93,7 +165,7 @@ std::vector<RenderableInstance> RenderableResolver::resolve(const FrameSnapshot&
     }
 
     // Bosses
-    for (const auto& boss : frame.boss_vector)
+    for (const auto boss : frame.bosses())
     {
         auto instance_opt = make_instance(boss);
 
@@ -102,7 +174,7 @@ std::vector<RenderableInstance> RenderableResolver::resolve(const FrameSnapshot&
     }
 
     // Bullets
-    for (const auto& bullet : frame.bullet_vector)
+    for (const auto bullet : frame.bullets())
     {
         auto instance_opt = make_instance(bullet);
 
@@ -111,132 +183,86 @@ std::vector<RenderableInstance> RenderableResolver::resolve(const FrameSnapshot&
     }
 
     // Items
-    for (const auto& item : frame.item_vector)
+    for (const auto item : frame.items())
     {
          auto instance_opt = make_instance(item);
 
         if (instance_opt.has_value())
             renderable_instances.push_back(instance_opt.value());      
     }
-
-    return renderable_instances;
-}
-
-std::optional<RenderableInstance> RenderableResolver::make_instance(const StageSnapshot& stage) {
-    return std::nullopt;    // Implement soon
 }
 
-std::optional<RenderableInstance> RenderableResolver::make_instance(const PlayerSnapshot& player) {
-    auto sprite_pair = m_sprite_cache.find(SpriteTag{
-        SpriteType::Player,
-        player.name,
-        player.id
-    });
+const ResolvedAnimation* RenderableResolver::find_animation(SpriteType type, uint8_t name, size_t animation) const {
+    const auto type_index = static_cast<size_t>(type);
 
-    if (sprite_pair == m_sprite_cache.end())
+    if (type_index >= SPRITE_TYPE_COUNT || m_sprite_lookup.empty())
     {
-        std::cerr << "[RenderableResolver] ERROR: Sprite not found: " << player.name << "\n";
-
-        return std::nullopt;
+        return nullptr;
     }
 
-    auto sprite = sprite_pair->second;
-
-    /*
-        Resolve resource names
-    */
-   
-    // Resolve mesh
-    const auto mesh_name = std::string(assets_constants::MESH_DIR) + "/" + sprite.dimensions.mesh;
-
-    // Resolve shader
-    const auto shader_key = "idle";
+    const auto first_slot = m_sprite_lookup[sprite_lookup_index(type, name)];
 
-    auto shader_pair = sprite.animations.find(shader_key);
-    if (shader_pair == sprite.animations.end())
+    if (first_slot < 0)
     {
-        std::cerr << "[RenderableResolver] ERROR: Sprite { name: '"
-                  << static_cast<int>(sprite.name)
-                  << "', "
-                  << "type: '"
-                  << static_cast<int>(sprite.type)
-                  << "' } doesn't have a field: " << shader_key << "\n"; 
-
-        return std::nullopt;
+        return nullptr;
     }
 
-    const auto shader_name = std::string(assets_constants::SHADER_DIR) + "/" + shader_pair->second.shader;
+    const auto& slot = m_animation_table[static_cast<size_t>(first_slot) + animation];
 
-    // Resolve texture
-    const auto texture_name = std::string(assets_constants::TEXTURE_DIR) + "/" + sprite.texture_atlas.image;
+    return slot.valid ? &slot : nullptr;
+}
 
-    /*
-        Retrieve resource cache
-    */
-    const auto mesh     = m_mesh_factory.get_mesh(mesh_name);
-    const auto shader   = m_shader_factory.get_shader(shader_name);
-    const auto texture  = m_texture_factory.get_texture(texture_name);
+size_t RenderableResolver::get_animation_id(const std::string& animation_name) {
+    auto it = m_animation_ids.find(animation_name);
 
-    if (mesh == nullptr)
+    if (it != m_animation_ids.end())
     {
-        std::cerr << "[RenderableResolver] ERROR: Failed to resolve resource: " << mesh_name << "\n"; 
-
-        return std::nullopt;
+        return it->second;
     }
 
-    if (shader == nullptr)
-    {
-        std::cerr << "[RenderableResolver] ERROR: Failed to resolve shader: " << shader_name << "\n"; 
+    const auto id = m_animation_names.size();
 
-        return std::nullopt;
-    }
-
-    if (texture == nullptr)
-    {
-        std::cerr << "[RenderableResolver] ERROR: Failed to resolve texture: " << texture_name << "\n"; 
+    m_animation_ids[animation_name] = id;
+    m_animation_names.push_back(animation_name);
 
-        return std::nullopt;
-    }
+    return id;
+}
 
-    auto resource = RenderableResource{
-        mesh,
-        shader,
-        texture
-    }; 
+std::optional<RenderableInstance> RenderableResolver::make_instance(const StageSnapshot& stage) {
+    return std::nullopt;    // Implement soon
+}
 
-    /*
-        Create uniforms
-    */
+std::optional<RenderableInstance> RenderableResolver::make_instance(const PlayerSnapshot& player) {
+    const auto animation = find_animation(SpriteType::Player, player.name, m_idle_animation);
 
-    // Calculate the player scale based on the view port size (px)
-    const auto player_scale_x = sprite.dimensions.width / game_logic_constants::GAME_WIDTH * sprite.dimensions.scale;
-    const auto player_scale_y = sprite.dimensions.height / game_logic_constants::GAME_HEIGHT * sprite.dimensions.scale;
+    if (animation == nullptr)
+    {
+        std::cerr << "[RenderableResolver] ERROR: Sprite not found: { name: '"
+                  << static_cast<int>(player.name)
+                  << "', animation: '" << IDLE_ANIMATION << "' }\n";
 
-    // Create model matrix
-    // auto model = make_model_matrix(
-    //     player.pos.x,
-    //     player.pos.y,
-    //     player.angle,
-    //     player_scale_x,
-    //     player_scale_y
-    // );
+        return std::nullopt;
+    }
 
-    auto offset = glm::vec2(player.pos.x, player.pos.y);
+    auto instance = SpriteInstanceData{
+        glm::vec2(player.pos.x, player.pos.y),
+        animation->scale,
+        player.angle,
+        animation->uv_region
+    };
 
     // Create time
     /*
         To-Do: Implement an AnimationTracker like this
         time = anim_tracker.get_anim time(name, id);
     */
-    auto time = 0.0f;
-
-    auto uniforms = std::unordered_map<std::string, UniformValue>{
-        {"offset", offset},
-        {"time", time}        
-    };
+    auto uniforms = InstanceUniforms{};
+    uniforms.time = 0.0f;
 
     return RenderableInstance{
-        std::make_shared<RenderableResource>(resource),
+        &animation->resource,
+        RenderLayer::Player,
+        instance,
         uniforms
     };
 }
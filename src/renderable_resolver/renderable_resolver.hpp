@@ -17,11 +17,27 @@
 #include "../assets_factory/texture_factory.hpp"
 #include "../packet_template/packet_template.hpp"
 
+// Everything 'resolve()' needs for one (SpriteType, name, animation), precomputed by 'load_sprites()'
+struct ResolvedAnimation {
+    RenderableResource  resource;
+    glm::vec2           scale;
+    glm::vec4           uv_region;
+    bool                valid = false;
+};
+
 // A resolver that takes a frame snapshot and resolves the required renderable instances
 class RenderableResolver {
 public:
     bool load_sprites(sol::state& lua, const std::string& registry_path);
-    std::vector<RenderableInstance> resolve(const FrameSnapshot& frame);
+
+    /*
+        Clears 'renderable_instances' and fills it with the instances of 'frame',
+        a view over either a received payload or a FrameSnapshot.
+        Pass the same vector every frame to reuse its capacity.
+
+        The instances point into the resolver, they are valid until the next 'load_sprites()'.
+    */
+    void resolve(const FrameView& frame, std::vector<RenderableInstance>& renderable_instances);
 
 private:
     std::optional<RenderableInstance> make_instance(const StageSnapshot& stage);
@@ -31,9 +47,26 @@ private:
     std::optional<RenderableInstance> make_instance(const BulletSnapshot& bullet);
     std::optional<RenderableInstance> make_instance(const ItemSnapshot& item);
 
-    std::unordered_map<SpriteTag, Sprite> m_sprite_cache;
+    // Returns nullptr if the sprite or its animation is not registered
+    const ResolvedAnimation* find_animation(SpriteType type, uint8_t name, size_t animation) const;
+
+    // Returns the id of an animation name, assigning a new one if needed
+    size_t get_animation_id(const std::string& animation_name);
+
+    /*
+        Resolved animations, 'm_animation_names.size()' slots per registered sprite.
+        'm_sprite_lookup[type * SPRITE_NAME_COUNT + name]' is the first slot of a sprite, or -1.
+    */
+    std::vector<ResolvedAnimation>                  m_animation_table;
+    std::vector<int32_t>                            m_sprite_lookup;
+
+    // Load time only, 'resolve()' uses the ids below
+    std::unordered_map<std::string, size_t>         m_animation_ids;
+    std::vector<std::string>                        m_animation_names;
+
+    size_t                                          m_idle_animation;
 
     MeshFactory     m_mesh_factory;
     ShaderFactory   m_shader_factory;
     TextureFactory  m_texture_factory;
-};
\ No newline at end of file
+};
@@ -0,0 +1,39 @@
+#include "render_list_buffer.hpp"
+
+RenderListBuffer::RenderListBuffer()
+    : m_has_pending(false)
+{}
+
+std::vector<RenderableInstance>& RenderListBuffer::back() {
+    return m_back;
+}
+
+void RenderListBuffer::publish() {
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Replaces the pending list if the consumer hasn't picked it up yet
+        std::swap(m_back, m_pending);
+        m_has_pending = true;
+    }
+
+    m_published.notify_one();
+}
+
+bool RenderListBuffer::acquire(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(m_mutex);
+
+    if (!m_published.wait_for(lock, timeout, [this] { return m_has_pending; }))
+    {
+        return false;
+    }
+
+    std::swap(m_front, m_pending);
+    m_has_pending = false;
+
+    return true;
+}
+
+const std::vector<RenderableInstance>& RenderListBuffer::front() const {
+    return m_front;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <condition_variable>
+#include "renderer.hpp"
+
+/*
+    Hands resolved render lists from the network thread to the render thread.
+
+    The producer fills 'back()' and calls 'publish()', the consumer calls 'acquire()' and draws 'front()'.
+    Only the latest list is kept, so a slow consumer skips lists instead of queueing them,
+    and the producer never waits for the consumer beyond a pointer swap.
+    The three vectors are recycled, so their capacity is reused.
+*/
+class RenderListBuffer {
+public:
+    RenderListBuffer();
+
+    // Delete copy constructor and copy assignment operator
+    RenderListBuffer(const RenderListBuffer&) = delete;
+    RenderListBuffer& operator=(const RenderListBuffer&) = delete;
+
+    // Producer side
+    std::vector<RenderableInstance>& back();
+    void publish();
+
+    /*
+        Consumer side, waits up to 'timeout' for a list newer than 'front()'.
+        Returns true if 'front()' has been replaced, false on timeout.
+    */
+    bool acquire(std::chrono::milliseconds timeout);
+    const std::vector<RenderableInstance>& front() const;
+
+private:
+    std::vector<RenderableInstance> m_back;
+    std::vector<RenderableInstance> m_front;
+
+    std::mutex                      m_mutex;
+    std::condition_variable         m_published;
+    std::vector<RenderableInstance> m_pending;
+    bool                            m_has_pending;
+};
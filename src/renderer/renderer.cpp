@@ -1,31 +1,164 @@
 #include <iostream>
+#include <algorithm>
+#include <tuple>
+#include <cstddef>
+#include <cstring>
 #include "renderer.hpp"
 
+namespace {
+    constexpr size_t INITIAL_INSTANCE_CAPACITY = 1024;
+
+    // Vertex buffer binding of the instance attributes
+    constexpr GLuint INSTANCE_BUFFER_BINDING = 2;
+
+    const std::vector<InstanceAttribute> SPRITE_INSTANCE_ATTRIBUTES = {
+        { 2, 2, offsetof(SpriteInstanceData, offset) },
+        { 3, 2, offsetof(SpriteInstanceData, scale) },
+        { 4, 1, offsetof(SpriteInstanceData, rotation) },
+        { 5, 4, offsetof(SpriteInstanceData, uv_region) }
+    };
+
+    auto batch_key(const RenderableInstance& renderable) {
+        const auto& resource = *renderable.resource;
+
+        return std::make_tuple(
+            renderable.layer,
+            resource.shader.get(),
+            resource.texture.get(),
+            resource.mesh.get()
+        );
+    }
+}
+
+Renderer::Renderer()
+    : m_instance_stream(INITIAL_INSTANCE_CAPACITY * sizeof(SpriteInstanceData))
+{}
+
+Renderer::~Renderer() = default;
+
 void Renderer::draw(const std::vector<RenderableInstance>& renderable_instances) {
-    for (const auto& renderable : renderable_instances)
+    m_stats = RendererStats{};
+
+    m_draw_order.clear();
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(renderable_instances.size()); i++)
     {
-        auto mesh = renderable.resource->mesh;
-        auto shader = renderable.resource->shader;
-        auto texture = renderable.resource->texture;
+        const auto& resource = renderable_instances[i].resource;
 
-        if (mesh == nullptr || shader == nullptr || texture == nullptr)
+        if (resource == nullptr || resource->mesh == nullptr || resource->shader == nullptr || resource->texture == nullptr)
         {
             std::cerr << "[Renderer] WARNING: Missing renderable resource (mesh/shader/texture), skipping" << "\n";
 
             continue;
         }
 
-        // Bind current resources
-        shader->use();
-        mesh->bind();
-        texture->bind();
+        m_draw_order.push_back(i);
+    }
 
-        // Set unifroms
-        for (auto& [name, value] : renderable.uniforms)
+    if (m_draw_order.empty())
+    {
+        return;
+    }
+
+    // Stable, so instances with the same key keep the submission order
+    std::stable_sort(m_draw_order.begin(), m_draw_order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return batch_key(renderable_instances[lhs]) < batch_key(renderable_instances[rhs]);
+    });
+
+    // Write the instance data straight into the mapped region
+    const auto upload_size = m_draw_order.size() * sizeof(SpriteInstanceData);
+    auto dest = m_instance_stream.begin_write(upload_size);
+
+    for (auto index : m_draw_order)
+    {
+        std::memcpy(dest, &renderable_instances[index].instance, sizeof(SpriteInstanceData));
+        dest += sizeof(SpriteInstanceData);
+    }
+
+    m_instance_stream.end_write(upload_size);
+
+    const Shader*       bound_shader  = nullptr;
+    const Texture2D*    bound_texture = nullptr;
+    const Mesh*         bound_mesh    = nullptr;
+
+    size_t batch_begin = 0;
+
+    while (batch_begin < m_draw_order.size())
+    {
+        const auto& first = renderable_instances[m_draw_order[batch_begin]];
+        const auto key = batch_key(first);
+
+        size_t batch_end = batch_begin + 1;
+
+        while (batch_end < m_draw_order.size())
+        {
+            const auto& next = renderable_instances[m_draw_order[batch_end]];
+
+            if (batch_key(next) != key || next.uniforms != first.uniforms)
+            {
+                break;
+            }
+
+            batch_end++;
+        }
+
+        auto& shader  = *first.resource->shader;
+        auto& texture = *first.resource->texture;
+        auto& mesh    = *first.resource->mesh;
+
+        // Bind only what has changed since the last batch
+        if (bound_shader != &shader)
+        {
+            shader.use();
+            bound_shader = &shader;
+            m_stats.state_changes++;
+        }
+
+        if (bound_texture != &texture)
         {
-            shader->set_uniform(name, value);
+            texture.bind();
+            bound_texture = &texture;
+            m_stats.state_changes++;
         }
 
-        mesh->draw();
+        if (bound_mesh != &mesh)
+        {
+            if (!mesh.has_instance_attributes())
+            {
+                mesh.set_instance_attributes(INSTANCE_BUFFER_BINDING, SPRITE_INSTANCE_ATTRIBUTES);
+            }
+
+            mesh.bind();
+            mesh.bind_instance_buffer(
+                INSTANCE_BUFFER_BINDING,
+                m_instance_stream.id(),
+                m_instance_stream.offset(),
+                static_cast<GLsizei>(sizeof(SpriteInstanceData))
+            );
+            bound_mesh = &mesh;
+            m_stats.state_changes++;
+        }
+
+        shader.set_instance_uniforms(first.uniforms);
+
+        mesh.draw_instanced(
+            static_cast<GLsizei>(batch_end - batch_begin),
+            static_cast<GLuint>(batch_begin)
+        );
+
+        m_stats.draw_calls++;
+
+        batch_begin = batch_end;
     }
-}
\ No newline at end of file
+
+    glBindVertexArray(0);
+
+    m_instance_stream.fence();
+
+    m_stats.instances = m_draw_order.size();
+    m_stats.buffer_stalls = m_instance_stream.stall_count();
+}
+
+const RendererStats& Renderer::get_stats() const {
+    return m_stats;
+}
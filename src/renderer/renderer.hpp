@@ -1,10 +1,11 @@
 #pragma once
 
-#include <unordered_map>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
 #include "../mesh/mesh.hpp"
+#include "../mesh/stream_buffer.hpp"
 #include "../shader/shader.hpp"
 #include "../texture/texture2d.hpp"
 
@@ -14,12 +15,67 @@ struct RenderableResource {
     std::shared_ptr<Texture2D>  texture;
 };
 
+// Instances are drawn layer by layer, the order inside a layer is up to the renderer
+enum class RenderLayer : uint8_t {
+    Stage,
+    Player,
+    Enemy,
+    Boss,
+    Bullet,
+    Item
+};
+
+/*
+    Per-instance data uploaded to the instance buffer.
+    Matches the instance attributes (location 2 - 5) of the sprite vertex shaders.
+*/
+struct SpriteInstanceData {
+    glm::vec2   offset;
+    glm::vec2   scale;
+    float       rotation;
+    glm::vec4   uv_region;  // u0, v0, u1, v1
+};
+
 struct RenderableInstance {
-    std::shared_ptr<RenderableResource>             resource;
-    std::unordered_map<std::string, UniformValue>   uniforms;
+    const RenderableResource*                       resource;
+    RenderLayer                                     layer;
+    SpriteInstanceData                              instance;
+
+    // Instances with different uniforms are split into separate batches
+    InstanceUniforms                                uniforms;
+};
+
+// Counters of the last 'draw()'
+struct RendererStats {
+    size_t instances        = 0;
+    size_t draw_calls       = 0;
+    size_t state_changes    = 0;    // Shader, mesh and texture binds
+    size_t buffer_stalls    = 0;    // Total waits on the instance buffer fences
 };
 
+/*
+    Sorts the instances by (layer, shader, texture, mesh) and draws each run
+    of equal keys and uniforms with a single glDrawElementsInstanced call.
+*/
 class Renderer {
 public:
+    Renderer();
+    ~Renderer();
+
+    // Delete copy constructor and copy assignment operator
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
     void draw(const std::vector<RenderableInstance>& renderable_instances);
-};
\ No newline at end of file
+
+    const RendererStats& get_stats() const;
+
+private:
+    // Triple-buffered, written in draw order
+    StreamBuffer                        m_instance_stream;
+
+    // Reused across frames
+    std::vector<uint32_t>               m_draw_order;
+
+    RendererStats                       m_stats;
+};
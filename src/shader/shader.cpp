@@ -185,6 +185,8 @@ void Shader::load_from_file(
     {
         m_uniform_location_cache[uni_ident.name] = uni_ident.location;
     }
+
+    cache_instance_uniform_locations();
 }
 
 void Shader::load_default_shader() {
@@ -224,6 +226,8 @@ void Shader::load_default_shader() {
 
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
+
+    cache_instance_uniform_locations();
 }
 
 void Shader::use() const {
@@ -351,6 +355,18 @@ void Shader::set_uniform(const std::string& name, UniformValue value) const {
     }
 }
 
+void Shader::set_instance_uniforms(const InstanceUniforms& uniforms) const {
+    if (m_instance_uniform_locations.time != -1)
+    {
+        glUniform1f(m_instance_uniform_locations.time, uniforms.time);
+    }
+}
+
+void Shader::cache_instance_uniform_locations() {
+    m_instance_uniform_locations = InstanceUniformLocations{};
+    m_instance_uniform_locations.time = name_to_location("time").value_or(-1);
+}
+
 std::optional<GLint> Shader::name_to_location(const std::string& name) const {
     auto it = m_uniform_location_cache.find(name);
     auto end = m_uniform_location_cache.end();
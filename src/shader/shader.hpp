@@ -39,6 +39,22 @@ struct UniformIdentity {
 
 UniformType get_uniform_type(const UniformValue& value);
 
+/*
+    Fixed-layout uniforms a sprite shader may declare.
+    Their locations are resolved once at load time, a shader that doesn't declare one just ignores it.
+*/
+struct InstanceUniforms {
+    float time = 0.0f;
+
+    bool operator==(const InstanceUniforms& other) const {
+        return time == other.time;
+    }
+
+    bool operator!=(const InstanceUniforms& other) const {
+        return !(*this == other);
+    }
+};
+
 class Shader {
 public:
     Shader();
@@ -67,6 +83,9 @@ public:
     void set_uniform(const std::string& name, const glm::mat4& mat) const;
     void set_uniform(const std::string& name, UniformValue value) const;
 
+    // No string lookup, used on the per-batch path
+    void set_instance_uniforms(const InstanceUniforms& uniforms) const;
+
     std::vector<std::string> get_uniform_names() const;
 
 private:
@@ -82,5 +101,13 @@ private:
     std::unordered_map<std::string, GLint> m_uniform_location_cache;
     std::optional<GLint> name_to_location(const std::string& name) const;
 
+    // Locations of 'InstanceUniforms', -1 if the shader doesn't declare the uniform
+    struct InstanceUniformLocations {
+        GLint time = -1;
+    };
+
+    InstanceUniformLocations m_instance_uniform_locations;
+    void cache_instance_uniform_locations();
+
     void delete_program();
 };
\ No newline at end of file
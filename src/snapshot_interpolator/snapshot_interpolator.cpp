@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cmath>
+#include "snapshot_interpolator.hpp"
+#include "../game_server/game_logic_constants.hpp"
+
+namespace {
+    using IdIndex = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    constexpr double TICKS_PER_SECOND = static_cast<double>(game_logic_constants::TICK_RATE);
+
+    // The render clock runs at most 10% faster or slower while catching up with the server time
+    constexpr double CLOCK_CORRECTION_GAIN      = 0.05;     // Speed change per tick of error
+    constexpr double CLOCK_MAX_CORRECTION       = 0.10;
+
+    // Beyond this error (in ticks) the render clock jumps instead of drifting
+    constexpr double CLOCK_SNAP_THRESHOLD_TICKS = 30.0;
+
+    constexpr float TWO_PI = 6.28318530718f;
+
+    double to_ticks(std::chrono::duration<double> duration) {
+        return duration.count() * TICKS_PER_SECOND;
+    }
+
+    template <typename Snapshot>
+    void build_index(const std::vector<Snapshot>& entities, IdIndex& index) {
+        index.clear();
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++)
+        {
+            index.emplace_back(static_cast<uint32_t>(entities[i].id), i);
+        }
+
+        std::sort(index.begin(), index.end());
+    }
+
+    template <typename Snapshot>
+    const Snapshot* find_by_id(const std::vector<Snapshot>& entities, const IdIndex& index, uint32_t id) {
+        const auto it = std::lower_bound(index.begin(), index.end(), std::make_pair(id, uint32_t{0}));
+
+        if (it == index.end() || it->first != id)
+        {
+            return nullptr;
+        }
+
+        return &entities[it->second];
+    }
+
+    // Entities that only exist in 'from' stay where they are
+    template <typename Snapshot>
+    void interpolate_entities(
+        const std::vector<Snapshot>& from,
+        const std::vector<Snapshot>& to,
+        float alpha,
+        IdIndex& index,
+        std::vector<Snapshot>& out
+    ) {
+        out.assign(from.begin(), from.end());
+
+        if (alpha <= 0.0f)
+        {
+            return;
+        }
+
+        build_index(to, index);
+
+        for (auto& entity : out)
+        {
+            const auto target = find_by_id(to, index, static_cast<uint32_t>(entity.id));
+
+            if (target == nullptr)
+            {
+                continue;
+            }
+
+            entity.pos.x += (target->pos.x - entity.pos.x) * alpha;
+            entity.pos.y += (target->pos.y - entity.pos.y) * alpha;
+
+            // Along the shorter arc, an angle wrapping from pi to -pi doesn't spin the entity around
+            entity.angle += std::remainder(target->angle - entity.angle, TWO_PI) * alpha;
+        }
+    }
+
+    /*
+        Moves the entities of 'newest' on by 'ticks', with the motion since 'previous'.
+        Entities missing from 'previous' use their velocity.
+    */
+    template <typename Snapshot>
+    void extrapolate_entities(
+        const std::vector<Snapshot>& previous,
+        const std::vector<Snapshot>& newest,
+        float gap_ticks,
+        float ticks,
+        IdIndex& index,
+        std::vector<Snapshot>& out
+    ) {
+        out.assign(newest.begin(), newest.end());
+
+        build_index(previous, index);
+
+        for (auto& entity : out)
+        {
+            auto velocity_x = entity.vel.x;
+            auto velocity_y = entity.vel.y;
+
+            const auto origin = find_by_id(previous, index, static_cast<uint32_t>(entity.id));
+
+            if (origin != nullptr && gap_ticks > 0.0f)
+            {
+                velocity_x = (entity.pos.x - origin->pos.x) / gap_ticks;
+                velocity_y = (entity.pos.y - origin->pos.y) / gap_ticks;
+            }
+
+            entity.pos.x += velocity_x * ticks;
+            entity.pos.y += velocity_y * ticks;
+        }
+    }
+
+    void copy_frame_header(const FrameSnapshot& frame, FrameSnapshot& out) {
+        out.client_id   = frame.client_id;
+        out.opponent_id = frame.opponent_id;
+        out.timestamp   = frame.timestamp;
+        out.score       = frame.score;
+        out.mode        = frame.mode;
+        out.variant     = frame.variant;
+        out.difficulty  = frame.difficulty;
+        out.state       = frame.state;
+        out.last_input_sequence = frame.last_input_sequence;
+        out.stage       = frame.stage;
+    }
+
+    void update_counts(FrameSnapshot& frame) {
+        frame.player_count  = static_cast<uint32_t>(frame.player_vector.size());
+        frame.enemy_count   = static_cast<uint32_t>(frame.enemy_vector.size());
+        frame.boss_count    = static_cast<uint32_t>(frame.boss_vector.size());
+        frame.bullet_count  = static_cast<uint32_t>(frame.bullet_vector.size());
+        frame.item_count    = static_cast<uint32_t>(frame.item_vector.size());
+    }
+}
+
+SnapshotInterpolator::SnapshotInterpolator(SnapshotInterpolatorConfig config)
+    : m_config(config)
+    , m_delay_ticks(to_ticks(config.interpolation_delay))
+    , m_max_extrapolation_ticks(to_ticks(config.max_extrapolation))
+    , m_clock_started(false)
+    , m_render_tick(0.0)
+{}
+
+void SnapshotInterpolator::push(FrameSnapshot frame, Clock::time_point arrival_time) {
+    if (!m_snapshots.empty())
+    {
+        const auto newest_timestamp = m_snapshots.back().timestamp;
+
+        // A timestamp far in the past means a new session, start over
+        if (frame.timestamp + m_config.capacity < newest_timestamp)
+        {
+            clear();
+        }
+        else if (frame.timestamp <= newest_timestamp)
+        {
+            return;
+        }
+    }
+
+    m_snapshots.push_back(std::move(frame));
+    m_newest_arrival = arrival_time;
+
+    while (m_snapshots.size() > std::max<size_t>(m_config.capacity, 2))
+    {
+        m_snapshots.pop_front();
+    }
+}
+
+bool SnapshotInterpolator::sample(Clock::time_point now, FrameSnapshot& out) {
+    if (m_snapshots.empty())
+    {
+        return false;
+    }
+
+    /*
+        Advance the render clock
+    */
+    const auto server_tick = m_snapshots.back().timestamp + to_ticks(now - m_newest_arrival);
+    const auto target_tick = server_tick - m_delay_ticks;
+
+    if (!m_clock_started || std::abs(target_tick - m_render_tick) > CLOCK_SNAP_THRESHOLD_TICKS)
+    {
+        m_render_tick = target_tick;
+        m_clock_started = true;
+    }
+    else
+    {
+        const auto correction = std::clamp(
+            (target_tick - m_render_tick) * CLOCK_CORRECTION_GAIN,
+            -CLOCK_MAX_CORRECTION,
+            +CLOCK_MAX_CORRECTION
+        );
+
+        m_render_tick += to_ticks(now - m_last_sample) * (1.0 + correction);
+    }
+
+    m_last_sample = now;
+
+    // Keep the last snapshot at or before the render time, and one more for extrapolation
+    while (m_snapshots.size() > 2 && m_snapshots[1].timestamp <= m_render_tick)
+    {
+        m_snapshots.pop_front();
+    }
+
+    const auto& from = m_snapshots.front();
+    const auto& to = m_snapshots.size() > 1 ? m_snapshots[1] : from;
+
+    if (m_render_tick < to.timestamp || m_snapshots.size() == 1)
+    {
+        // Interpolate between the two snapshots around the render time
+        const auto span = static_cast<double>(to.timestamp) - static_cast<double>(from.timestamp);
+        const auto alpha = span > 0.0
+            ? static_cast<float>(std::clamp((m_render_tick - from.timestamp) / span, 0.0, 1.0))
+            : 0.0f;
+
+        copy_frame_header(from, out);
+
+        interpolate_entities(from.player_vector, to.player_vector, alpha, m_id_index, out.player_vector);
+        interpolate_entities(from.enemy_vector,  to.enemy_vector,  alpha, m_id_index, out.enemy_vector);
+        interpolate_entities(from.boss_vector,   to.boss_vector,   alpha, m_id_index, out.boss_vector);
+        interpolate_entities(from.bullet_vector, to.bullet_vector, alpha, m_id_index, out.bullet_vector);
+        interpolate_entities(from.item_vector,   to.item_vector,   alpha, m_id_index, out.item_vector);
+    }
+    else
+    {
+        // The render time has passed the newest snapshot, keep moving for a while
+        const auto gap = static_cast<float>(to.timestamp - from.timestamp);
+        const auto ticks = static_cast<float>(std::min(m_render_tick - to.timestamp, m_max_extrapolation_ticks));
+
+        copy_frame_header(to, out);
+
+        extrapolate_entities(from.player_vector, to.player_vector, gap, ticks, m_id_index, out.player_vector);
+        extrapolate_entities(from.enemy_vector,  to.enemy_vector,  gap, ticks, m_id_index, out.enemy_vector);
+        extrapolate_entities(from.boss_vector,   to.boss_vector,   gap, ticks, m_id_index, out.boss_vector);
+        extrapolate_entities(from.bullet_vector, to.bullet_vector, gap, ticks, m_id_index, out.bullet_vector);
+        extrapolate_entities(from.item_vector,   to.item_vector,   gap, ticks, m_id_index, out.item_vector);
+    }
+
+    update_counts(out);
+
+    return true;
+}
+
+void SnapshotInterpolator::clear() {
+    m_snapshots.clear();
+    m_clock_started = false;
+    m_render_tick = 0.0;
+}
+
+double SnapshotInterpolator::render_tick() const {
+    return m_render_tick;
+}
+
+size_t SnapshotInterpolator::size() const {
+    return m_snapshots.size();
+}
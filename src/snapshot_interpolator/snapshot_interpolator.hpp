@@ -0,0 +1,64 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include "../packet_template/frame.hpp"
+
+struct SnapshotInterpolatorConfig {
+    // How far behind the newest snapshot the client renders
+    std::chrono::milliseconds   interpolation_delay     = std::chrono::milliseconds(50);
+
+    // How long entities keep moving past the newest snapshot before they freeze
+    std::chrono::milliseconds   max_extrapolation       = std::chrono::milliseconds(100);
+
+    size_t                      capacity                = 32;
+};
+
+/*
+    Client side buffer of timestamped frame snapshots.
+
+    The frames are rendered 'interpolation_delay' behind the newest one, so there are usually
+    two snapshots around the render time. Entities matched by id between them are interpolated,
+    which hides network jitter and lets the render rate exceed the server tick rate.
+    If the render time runs past the newest snapshot (packet loss), entities are extrapolated
+    for at most 'max_extrapolation'.
+
+    The render clock runs on local time and is slowly pulled toward the estimated server time,
+    so arrival jitter doesn't show up as speed changes.
+*/
+class SnapshotInterpolator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SnapshotInterpolator(SnapshotInterpolatorConfig config = SnapshotInterpolatorConfig());
+
+    // Stale and duplicate snapshots are dropped
+    void push(FrameSnapshot frame, Clock::time_point arrival_time);
+
+    // Writes the frame at 'now' into 'out', returns false if no snapshot has arrived yet
+    bool sample(Clock::time_point now, FrameSnapshot& out);
+
+    void clear();
+
+    // The server tick being rendered
+    double render_tick() const;
+    size_t size() const;
+
+private:
+    SnapshotInterpolatorConfig          m_config;
+    double                              m_delay_ticks;
+    double                              m_max_extrapolation_ticks;
+
+    std::deque<FrameSnapshot>           m_snapshots;
+    Clock::time_point                   m_newest_arrival;
+
+    bool                                m_clock_started;
+    double                              m_render_tick;
+    Clock::time_point                   m_last_sample;
+
+    // (id, index) pairs sorted by id, reused across samples
+    std::vector<std::pair<uint32_t, uint32_t>> m_id_index;
+};
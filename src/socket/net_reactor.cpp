@@ -0,0 +1,244 @@
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include "net_reactor.hpp"
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+#endif
+
+namespace {
+    constexpr int MAX_EVENTS        = 64;
+    constexpr int EPOLL_TIMEOUT_MS  = 100;   // How often the I/O threads check for stop
+}
+
+NetReactor::NetReactor(size_t io_thread_count)
+    : m_running(false)
+    , m_io_threads(std::max<size_t>(1, io_thread_count))
+    , m_next_token(1)
+    , m_next_io_index(0)
+{}
+
+NetReactor::~NetReactor() {
+    stop();
+}
+
+bool NetReactor::is_supported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool NetReactor::start() {
+#ifdef __linux__
+    if (m_running)
+    {
+        return true;
+    }
+
+    for (auto& io : m_io_threads)
+    {
+        io.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (io.epoll_fd < 0)
+        {
+            std::cerr << "[NetReactor] ERROR: epoll_create1 failed: " << strerror(errno) << "\n";
+
+            for (auto& created : m_io_threads)
+            {
+                if (created.epoll_fd >= 0)
+                {
+                    close(created.epoll_fd);
+                    created.epoll_fd = -1;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    m_running = true;
+
+    for (size_t i = 0; i < m_io_threads.size(); i++)
+    {
+        m_io_threads[i].thread = std::thread(&NetReactor::io_loop, this, i);
+    }
+
+    std::cout << "[NetReactor] DEBUG: Started with " << m_io_threads.size() << " I/O threads" << "\n";
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NetReactor::stop() {
+    if (!m_running.exchange(false))
+    {
+        return;
+    }
+
+    for (auto& io : m_io_threads)
+    {
+        if (io.thread.joinable())
+        {
+            io.thread.join();
+        }
+
+#ifdef __linux__
+        if (io.epoll_fd >= 0)
+        {
+            close(io.epoll_fd);
+            io.epoll_fd = -1;
+        }
+#endif
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_registrations.clear();
+
+    std::cout << "[NetReactor] DEBUG: I/O threads have been joined" << "\n";
+}
+
+bool NetReactor::is_running() const {
+    return m_running;
+}
+
+uint64_t NetReactor::add(SOCKET sock, ReactorHandler* handler) {
+#ifdef __linux__
+    if (!m_running || sock == INVALID_SOCKET || handler == nullptr)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto token = m_next_token++;
+    const auto io_index = m_next_io_index++ % m_io_threads.size();
+
+    epoll_event event = {};
+    event.events    = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64  = token;
+
+    if (epoll_ctl(m_io_threads[io_index].epoll_fd, EPOLL_CTL_ADD, sock, &event) < 0)
+    {
+        std::cerr << "[NetReactor] ERROR: epoll_ctl(ADD) failed: " << strerror(errno) << "\n";
+
+        return 0;
+    }
+
+    m_registrations[token] = Registration {
+        sock,
+        handler,
+        io_index
+    };
+
+    return token;
+#else
+    static_cast<void>(sock);
+    static_cast<void>(handler);
+
+    return 0;
+#endif
+}
+
+void NetReactor::remove(uint64_t token) {
+#ifdef __linux__
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_registrations.find(token);
+
+    if (it == m_registrations.end())
+    {
+        return;
+    }
+
+    auto& io = m_io_threads[it->second.io_index];
+
+    epoll_ctl(io.epoll_fd, EPOLL_CTL_DEL, it->second.sock, nullptr);
+    m_registrations.erase(it);
+
+    // Removing from inside a callback, the caller is the one running it
+    if (io.thread.get_id() == std::this_thread::get_id())
+    {
+        return;
+    }
+
+    m_callback_cv.wait(lock, [&] {
+        return io.active_token != token;
+    });
+#else
+    static_cast<void>(token);
+#endif
+}
+
+void NetReactor::io_loop(size_t io_index) {
+#ifdef __linux__
+    auto& io = m_io_threads[io_index];
+    epoll_event events[MAX_EVENTS];
+
+    while (m_running)
+    {
+        const auto ready = epoll_wait(io.epoll_fd, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            std::cerr << "[NetReactor] ERROR: epoll_wait failed: " << strerror(errno) << "\n";
+
+            break;
+        }
+
+        for (int i = 0; i < ready; i++)
+        {
+            const auto token = events[i].data.u64;
+            ReactorHandler* handler = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto it = m_registrations.find(token);
+
+                // Removed while the event was pending
+                if (it == m_registrations.end())
+                {
+                    continue;
+                }
+
+                handler = it->second.handler;
+                io.active_token = token;
+            }
+
+            /*
+                EPOLLRDHUP / EPOLLHUP / EPOLLERR are delivered to the handler as well.
+                Draining the socket makes recv report EOF or the error.
+            */
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                handler->on_readable();
+            }
+
+            // Comes along with the other events too, handlers without unsent data just return
+            if (events[i].events & EPOLLOUT)
+            {
+                handler->on_writable();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                io.active_token = 0;
+            }
+
+            m_callback_cv.notify_all();
+        }
+    }
+#else
+    static_cast<void>(io_index);
+#endif
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <condition_variable>
+#include "socket.hpp"
+
+/*
+    Implemented by objects that want to be notified when their socket is readable.
+    Notifications are edge-triggered, so 'on_readable' must drain the socket
+    until recv reports that it would block.
+
+    'on_writable' is called when the send buffer of the socket has room again,
+    handlers that keep unsent data flush it there.
+*/
+class ReactorHandler {
+public:
+    virtual ~ReactorHandler() = default;
+
+    virtual void on_readable() = 0;
+    virtual void on_writable() {}
+};
+
+/*
+    An epoll based reactor that multiplexes many sockets on a few I/O threads.
+    Each I/O thread owns its own epoll instance and sockets are spread across
+    them round-robin, so callbacks for one socket never run concurrently.
+
+    Only available on Linux. On other platforms 'start()' returns false and
+    callers are expected to fall back to a receive thread per connection.
+*/
+class NetReactor {
+public:
+    explicit NetReactor(size_t io_thread_count = 2);
+    ~NetReactor();
+
+    // Delete copy constructor and copy assignment operator
+    NetReactor(const NetReactor&) = delete;
+    NetReactor& operator=(const NetReactor&) = delete;
+
+    static bool is_supported();
+
+    bool start();
+    void stop();
+    bool is_running() const;
+
+    // Returns a token used for 'remove', or 0 on failure
+    uint64_t add(SOCKET sock, ReactorHandler* handler);
+
+    /*
+        Unregisters the socket. When called from outside the reactor, this blocks
+        until any in-flight callback for the token has returned, so the handler
+        can be destroyed right after.
+    */
+    void remove(uint64_t token);
+
+private:
+    struct IoThread {
+        int             epoll_fd    = -1;
+        std::thread     thread;
+        uint64_t        active_token = 0;   // The token whose callback is running right now
+    };
+
+    struct Registration {
+        SOCKET          sock;
+        ReactorHandler* handler;
+        size_t          io_index;
+    };
+
+    void io_loop(size_t io_index);
+
+    std::atomic<bool>                           m_running;
+    std::vector<IoThread>                       m_io_threads;
+
+    std::mutex                                  m_mutex;
+    std::condition_variable                     m_callback_cv;
+    std::unordered_map<uint64_t, Registration>  m_registrations;
+    uint64_t                                    m_next_token;
+    size_t                                      m_next_io_index;
+};
@@ -3,44 +3,176 @@
 #include <limits>
 #include "socket.hpp"
 
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <poll.h>
+#endif
+
 namespace {
     constexpr size_t TEMP_BUFFER_SIZE = 4096;
 
+    /*
+        poll() rather than select(), FD_SET is undefined for descriptors
+        above FD_SETSIZE and a server with many connections gets there
+    */
+    ssize_t wait_for_ready(SOCKET sock, short events, long sec, long usec) {
+        // Rounded up, so a short wait doesn't become a busy loop
+        const auto timeout_ms = static_cast<int>(sec * 1000 + (usec + 999) / 1000);
+
+#ifdef _WIN32
+        WSAPOLLFD fd = {};
+        fd.fd = sock;
+        fd.events = events;
+
+        return WSAPoll(&fd, 1, timeout_ms);
+#else
+        pollfd fd = {};
+        fd.fd = sock;
+        fd.events = events;
+
+        return poll(&fd, 1, timeout_ms);
+#endif
+    }
+
     ssize_t wait_for_read_ready(SOCKET sock, long sec, long usec) {
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(sock, &readfds);
+        return wait_for_ready(sock, POLLIN, sec, usec);
+    }
 
-        timeval timeout;
-        timeout.tv_sec = sec;
-        timeout.tv_usec = usec;
+    bool would_block() {
+#ifdef _WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+    }
 
-        return select(sock + 1, &readfds, nullptr, nullptr, &timeout);
+    ssize_t wait_for_write_ready(SOCKET sock, long sec, long usec) {
+        return wait_for_ready(sock, POLLOUT, sec, usec);
     }
 
-    ssize_t socket_send(SOCKET sock, const std::vector<std::byte>& bytes) {
-        // Check for overflow
+    ssize_t socket_try_send(SOCKET sock, const std::byte* data, size_t size) {
 #ifdef _WIN32
-        if (bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max()))
+        if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
         {
             return SOCKET_ERROR;
         }
 
-        int safe_size = static_cast<int>(bytes.size());
+        int safe_size = static_cast<int>(size);
         int frags = 0;
 #else
-        size_t safe_size = bytes.size();
+        size_t safe_size = size;
         int frags = MSG_NOSIGNAL;
 #endif
-        return send(
+        auto result = send(
             sock,
             /*
                 Convert std::byte* into const char*
             */
-            reinterpret_cast<const char*>(bytes.data()),
+            reinterpret_cast<const char*>(data),
             safe_size,
             frags
         );
+
+        if (result == SOCKET_ERROR && would_block())
+        {
+            return SOCKET_SEND_WOULD_BLOCK;
+        }
+
+        return result;
+    }
+
+    ssize_t socket_send(SOCKET sock, const std::byte* data, size_t size) {
+        // Check for overflow
+#ifdef _WIN32
+        if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            return SOCKET_ERROR;
+        }
+
+        int frags = 0;
+#else
+        int frags = MSG_NOSIGNAL;
+#endif
+        size_t sent = 0;
+
+        /*
+            Blocking sockets only, the server side sends with 'try_send_data' and keeps the rest.
+            A socket with a send timeout may still accept only part of the data,
+            so keep sending until everything is written or the peer stops reading
+        */
+        while (sent < size)
+        {
+#ifdef _WIN32
+            int safe_size = static_cast<int>(size - sent);
+#else
+            size_t safe_size = size - sent;
+#endif
+            auto result = send(
+                sock,
+                /*
+                    Convert std::byte* into const char*
+                */
+                reinterpret_cast<const char*>(data + sent),
+                safe_size,
+                frags
+            );
+
+            if (result > 0)
+            {
+                sent += static_cast<size_t>(result);
+
+                continue;
+            }
+
+            if (result == SOCKET_ERROR && would_block())
+            {
+                auto ready = wait_for_write_ready(sock, 1, 0);
+
+                if (ready == 0)
+                {
+                    return SOCKET_SEND_TIMEOUT;
+                }
+                else if (ready < 0)
+                {
+                    return SOCKET_ERROR;
+                }
+
+                continue;
+            }
+
+            return SOCKET_ERROR;
+        }
+
+        return static_cast<ssize_t>(sent);
+    }
+
+    ssize_t socket_try_recv(SOCKET sock, std::byte* buffer, size_t size) {
+#ifdef _WIN32
+        if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            return SOCKET_ERROR;
+        }
+
+        int safe_size = static_cast<int>(size);
+#else
+        size_t safe_size = size;
+#endif
+        auto result = recv(
+            sock,
+            /*
+                Convert std::byte* into const char*
+            */
+            reinterpret_cast<char*>(buffer),
+            safe_size,
+            0
+        );
+
+        if (result == SOCKET_ERROR && would_block())
+        {
+            return SOCKET_RECV_WOULD_BLOCK;
+        }
+
+        return result;
     }
 
     ssize_t socket_recv(SOCKET sock, std::byte* buffer, size_t size) {
@@ -135,6 +267,66 @@ namespace {
         return buffer;
     }
 
+    bool socket_set_non_blocking(SOCKET sock, bool enabled) {
+#ifdef _WIN32
+        u_long mode = enabled ? 1 : 0;
+
+        return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+        int flags = fcntl(sock, F_GETFL, 0);
+
+        if (flags < 0)
+        {
+            return false;
+        }
+
+        flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+
+        return fcntl(sock, F_SETFL, flags) == 0;
+#endif
+    }
+
+    ssize_t socket_recv_from(SOCKET sock, std::byte* buffer, size_t size, DatagramAddress& peer) {
+#ifdef _WIN32
+        if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            return SOCKET_ERROR;
+        }
+
+        int safe_size = static_cast<int>(size);
+        int from_size = sizeof(sockaddr_in);
+#else
+        size_t safe_size = size;
+        socklen_t from_size = sizeof(sockaddr_in);
+#endif
+        sockaddr_in from = {};
+
+        auto result = recvfrom(
+            sock,
+            /*
+                Convert std::byte* into char*
+            */
+            reinterpret_cast<char*>(buffer),
+            safe_size,
+            0,
+            reinterpret_cast<sockaddr*>(&from),
+            &from_size
+        );
+
+        if (result == SOCKET_ERROR && would_block())
+        {
+            return SOCKET_RECV_WOULD_BLOCK;
+        }
+
+        if (result >= 0)
+        {
+            peer.address = from.sin_addr.s_addr;
+            peer.port = from.sin_port;
+        }
+
+        return result;
+    }
+
     void close_socket(SOCKET sock) {
         if (sock == INVALID_SOCKET)
         {
@@ -258,12 +450,16 @@ void ClientSocket::disconnect() {
 }
 
 ssize_t ClientSocket::send_data(const std::vector<std::byte>& data) {
+    return send_data(data.data(), data.size());
+}
+
+ssize_t ClientSocket::send_data(const std::byte* data, size_t size) {
     if (!m_server_connected)
     {
         return SOCKET_ERROR;
     }
 
-    return socket_send(m_server_sock, data);
+    return socket_send(m_server_sock, data, size);
 }
 
 ssize_t ClientSocket::recv_data(std::byte* buffer, size_t size) {
@@ -344,12 +540,25 @@ void ClientConnection::disconnect() {
 }
 
 ssize_t ClientConnection::send_data(const std::vector<std::byte>& data) {
+    return send_data(data.data(), data.size());
+}
+
+ssize_t ClientConnection::send_data(const std::byte* data, size_t size) {
     if (!m_client_connected)
     {
         return SOCKET_ERROR;
     }
 
-    return socket_send(m_client_sock, data);
+    return socket_send(m_client_sock, data, size);
+}
+
+ssize_t ClientConnection::try_send_data(const std::byte* data, size_t size) {
+    if (!m_client_connected)
+    {
+        return SOCKET_ERROR;
+    }
+
+    return socket_try_send(m_client_sock, data, size);
 }
 
 ssize_t ClientConnection::recv_data(std::byte* buffer, size_t size) {
@@ -370,6 +579,28 @@ std::optional<std::vector<std::byte>> ClientConnection::recv_exact(size_t size)
     return socket_recv_exact(m_client_sock, size);
 }
 
+bool ClientConnection::set_non_blocking(bool enabled) {
+    if (m_client_sock == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    return socket_set_non_blocking(m_client_sock, enabled);
+}
+
+ssize_t ClientConnection::try_recv_data(std::byte* buffer, size_t size) {
+    if (!m_client_connected)
+    {
+        return SOCKET_ERROR;
+    }
+
+    return socket_try_recv(m_client_sock, buffer, size);
+}
+
+SOCKET ClientConnection::get_native_handle() const {
+    return m_client_sock;
+}
+
 ServerSocket::ServerSocket(uint16_t server_port)
     : m_server_port(server_port)
     , m_listen_sock(INVALID_SOCKET)
@@ -485,4 +716,191 @@ std::optional<ClientConnection> ServerSocket::accept_client() {
     }
 
     return ClientConnection(client_socket);
-}
\ No newline at end of file
+}
+/*
+    Datagram
+*/
+bool operator==(const DatagramAddress& lhs, const DatagramAddress& rhs) {
+    return lhs.address == rhs.address && lhs.port == rhs.port;
+}
+
+bool operator!=(const DatagramAddress& lhs, const DatagramAddress& rhs) {
+    return !(lhs == rhs);
+}
+
+DatagramSocket::DatagramSocket()
+    : m_sock(INVALID_SOCKET)
+    , m_open(false)
+{}
+
+DatagramSocket::~DatagramSocket() {
+    close();
+}
+
+bool DatagramSocket::open(uint16_t port) {
+    if (m_open)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    WinsockManager::initialize();
+#endif
+
+    m_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (m_sock == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    sockaddr_in hint        = {};
+    hint.sin_family         = AF_INET;
+    hint.sin_port           = htons(port);
+    hint.sin_addr.s_addr    = htonl(INADDR_ANY);
+
+    auto bind_result = bind(
+        m_sock,
+        reinterpret_cast<sockaddr*>(&hint),
+        sizeof(hint)
+    );
+
+    if (bind_result == SOCKET_ERROR)
+    {
+        std::cerr << "[DatagramSocket] ERROR: Failed to bind port " << port << "\n";
+
+        close_socket(m_sock);
+        m_sock = INVALID_SOCKET;
+
+        return false;
+    }
+
+    m_open = true;
+
+    return true;
+}
+
+void DatagramSocket::close() {
+    m_open = false;
+
+    if (m_sock != INVALID_SOCKET)
+    {
+        close_socket(m_sock);
+        m_sock = INVALID_SOCKET;
+    }
+}
+
+bool DatagramSocket::is_open() const {
+    return m_open;
+}
+
+std::optional<DatagramAddress> DatagramSocket::resolve(std::string_view addr, uint16_t port) {
+    in_addr parsed = {};
+
+    // 'addr' points into a string literal, see socket_constants
+    if (inet_pton(AF_INET, addr.data(), &parsed) <= 0)
+    {
+        return std::nullopt;
+    }
+
+    return DatagramAddress {
+        parsed.s_addr,
+        htons(port)
+    };
+}
+
+ssize_t DatagramSocket::send_to(const DatagramAddress& peer, const std::byte* data, size_t size) {
+    if (!m_open)
+    {
+        return SOCKET_ERROR;
+    }
+
+    sockaddr_in to      = {};
+    to.sin_family       = AF_INET;
+    to.sin_port         = peer.port;
+    to.sin_addr.s_addr  = peer.address;
+
+#ifdef _WIN32
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        return SOCKET_ERROR;
+    }
+
+    int safe_size = static_cast<int>(size);
+    int flags = 0;
+#else
+    size_t safe_size = size;
+    int flags = MSG_NOSIGNAL;
+#endif
+
+    return sendto(
+        m_sock,
+        /*
+            Convert std::byte* into const char*
+        */
+        reinterpret_cast<const char*>(data),
+        safe_size,
+        flags,
+        reinterpret_cast<sockaddr*>(&to),
+        sizeof(to)
+    );
+}
+
+ssize_t DatagramSocket::recv_from(std::byte* buffer, size_t size, DatagramAddress& peer, long timeout_usec) {
+    if (!m_open)
+    {
+        return SOCKET_ERROR;
+    }
+
+    auto result = wait_for_read_ready(m_sock, timeout_usec / 1'000'000, timeout_usec % 1'000'000);
+
+    if (result == 0)
+    {
+        return SOCKET_RECV_TIMEOUT;
+    }
+    else if (result < 0)
+    {
+        return SOCKET_ERROR;
+    }
+
+    return socket_recv_from(m_sock, buffer, size, peer);
+}
+
+ssize_t DatagramSocket::try_recv_from(std::byte* buffer, size_t size, DatagramAddress& peer) {
+    if (!m_open)
+    {
+        return SOCKET_ERROR;
+    }
+
+    return socket_recv_from(m_sock, buffer, size, peer);
+}
+
+bool DatagramSocket::set_non_blocking(bool enabled) {
+    if (m_sock == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    return socket_set_non_blocking(m_sock, enabled);
+}
+
+SOCKET DatagramSocket::get_native_handle() const {
+    return m_sock;
+}
+
+uint16_t DatagramSocket::get_local_port() const {
+    sockaddr_in local = {};
+
+#ifdef _WIN32
+    int local_size = sizeof(local);
+#else
+    socklen_t local_size = sizeof(local);
+#endif
+
+    if (getsockname(m_sock, reinterpret_cast<sockaddr*>(&local), &local_size) == SOCKET_ERROR)
+    {
+        return 0;
+    }
+
+    return ntohs(local.sin_port);
+}
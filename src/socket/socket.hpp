@@ -39,8 +39,10 @@
     using SOCKET = int;
 #endif
 
-constexpr int SOCKET_RECV_TIMEOUT = -2;
-constexpr int SOCKET_SEND_TIMEOUT = -2;
+constexpr int SOCKET_RECV_TIMEOUT     = -2;
+constexpr int SOCKET_SEND_TIMEOUT     = -2;
+constexpr int SOCKET_RECV_WOULD_BLOCK = -3;   // Non-blocking socket has nothing to read right now
+constexpr int SOCKET_SEND_WOULD_BLOCK = -3;   // Non-blocking socket has no room in its send buffer
 
 class ClientSocket {
 public:
@@ -56,6 +58,7 @@ public:
     void disconnect();
 
     ssize_t send_data(const std::vector<std::byte>& data);
+    ssize_t send_data(const std::byte* data, size_t size);
     ssize_t recv_data(std::byte* buffer, size_t size);
     std::optional<std::vector<std::byte>> recv_exact(size_t size);
 
@@ -84,14 +87,75 @@ public:
     void disconnect();
 
     ssize_t send_data(const std::vector<std::byte>& data);
+    ssize_t send_data(const std::byte* data, size_t size);
     ssize_t recv_data(std::byte* buffer, size_t size);
     std::optional<std::vector<std::byte>> recv_exact(size_t size);
+
+    /*
+        Used by NetReactor: the socket is switched to non-blocking mode and
+        'try_recv_data' returns SOCKET_RECV_WOULD_BLOCK instead of waiting.
+        'try_send_data' may send only part of the data, and returns
+        SOCKET_SEND_WOULD_BLOCK when nothing could be sent.
+    */
+    bool set_non_blocking(bool enabled);
+    ssize_t try_recv_data(std::byte* buffer, size_t size);
+    ssize_t try_send_data(const std::byte* data, size_t size);
+    SOCKET get_native_handle() const;
     
 private:
     SOCKET              m_client_sock;
     std::atomic<bool>   m_client_connected;
 };
 
+/*
+    An IPv4 address and port of a datagram peer, both in network byte order
+*/
+struct DatagramAddress {
+    uint32_t    address = 0;
+    uint16_t    port    = 0;
+};
+
+bool operator==(const DatagramAddress& lhs, const DatagramAddress& rhs);
+bool operator!=(const DatagramAddress& lhs, const DatagramAddress& rhs);
+
+/*
+    A UDP socket. Unlike the stream sockets it has no connection,
+    every datagram is sent to and received from an explicit address.
+*/
+class DatagramSocket {
+public:
+    DatagramSocket();
+    ~DatagramSocket();
+
+    // Delete copy constructor and copy assignment operator
+    DatagramSocket(const DatagramSocket&) = delete;
+    DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+    // Binds to 'port' on every interface, 0 picks an ephemeral port
+    bool open(uint16_t port = 0);
+    void close();
+    bool is_open() const;
+
+    static std::optional<DatagramAddress> resolve(std::string_view addr, uint16_t port);
+
+    // Returns the number of bytes sent, datagrams are never split
+    ssize_t send_to(const DatagramAddress& peer, const std::byte* data, size_t size);
+
+    // Waits up to 'timeout_usec', returns SOCKET_RECV_TIMEOUT if nothing has arrived
+    ssize_t recv_from(std::byte* buffer, size_t size, DatagramAddress& peer, long timeout_usec);
+
+    // Non-blocking mode only, returns SOCKET_RECV_WOULD_BLOCK instead of waiting
+    ssize_t try_recv_from(std::byte* buffer, size_t size, DatagramAddress& peer);
+
+    bool set_non_blocking(bool enabled);
+    SOCKET get_native_handle() const;
+    uint16_t get_local_port() const;
+
+private:
+    SOCKET              m_sock;
+    std::atomic<bool>   m_open;
+};
+
 class ServerSocket {
 public:
     ServerSocket(uint16_t server_port);
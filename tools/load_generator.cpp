@@ -0,0 +1,487 @@
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include "config_constants.hpp"
+#include "socket/socket.hpp"
+#include "packet_stream/packet_stream.hpp"
+#include "packet_stream/datagram_transport.hpp"
+#include "game_server/game_server.hpp"
+#include "game_server/game_logic_constants.hpp"
+#include "game_simulation/input_log.hpp"
+
+/*
+    Headless bots against GameServerMaster, to see how many sessions a server can carry
+
+    Usage: load_generator [--sessions N] [--duration SEC] [--host ADDR] [--port PORT]
+                          [--script <input log>] [--seed N] [--tcp] [--local]
+
+    Every bot runs the handshake of 'App::run' (ClientHello, ClientGameRequest) and then
+    sends one ClientInput per server tick: a random walk, or the inputs of a recorded input
+    log when --script is given (each bot starts at a different offset).
+
+    --tcp       frames and inputs stay on the packet stream, a missing tick is then a tick the server skipped
+    --local     runs a GameServerMaster in this process and prints its tick overruns as well
+
+    Per session it reports the frame rate, percentiles of the inter-frame jitter (the distance
+    of each interval from the tick interval) and the ticks missing from the frame timestamps.
+    Frames are timestamped when the driver polls them, once per millisecond.
+*/
+namespace {
+    constexpr auto TICK_INTERVAL        = std::chrono::nanoseconds(1'000'000'000 / game_logic_constants::TICK_RATE);
+    constexpr auto POLL_INTERVAL        = std::chrono::milliseconds(1);
+    constexpr auto HANDSHAKE_TIMEOUT    = std::chrono::seconds(10);
+
+    // A bot that fell behind sends at most this many inputs at once
+    constexpr size_t MAX_INPUT_BURST    = 5;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct LoadOptions {
+        size_t          sessions        = 16;
+        double          duration_sec    = 30.0;
+        std::string     host            = std::string(socket_constants::SERVER_ADDR);
+        uint16_t        port            = socket_constants::SERVER_PORT;
+        std::string     script_path;
+        uint32_t        seed            = 1;
+        bool            use_datagrams   = socket_constants::ENABLE_DATAGRAM_TRANSPORT;
+        bool            local_server    = false;
+    };
+
+    enum class BotState : uint8_t {
+        WaitServerAccept,
+        WaitGameResponse,
+        Playing,
+        Failed
+    };
+
+    struct Bot {
+        std::shared_ptr<ClientSocket>       socket;
+        std::shared_ptr<ClientTransport>    transport;
+
+        BotState            state           = BotState::Failed;
+        Clock::time_point   phase_start;
+        Clock::time_point   next_input;
+
+        // Inputs
+        uint32_t            input_sequence  = 0;
+        size_t              script_index    = 0;
+        std::mt19937        random;
+        ArrowState          arrows;
+        uint32_t            hold_ticks      = 0;
+
+        // Frames
+        std::vector<FrameSnapshot>  received_frames;
+        bool                has_frame       = false;
+        Clock::time_point   first_frame_time;
+        Clock::time_point   last_frame_time;
+        uint32_t            last_timestamp  = 0;
+        uint64_t            frames          = 0;
+        uint64_t            missing_ticks   = 0;
+        uint64_t            stale_frames    = 0;    // Duplicated or reordered
+        std::vector<double> jitter_msec;
+    };
+
+    bool parse_options(int argc, char* argv[], LoadOptions& options) {
+        for (int i = 1; i < argc; i++)
+        {
+            const auto has_value = i + 1 < argc;
+
+            if (std::strcmp(argv[i], "--sessions") == 0 && has_value)
+            {
+                options.sessions = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (std::strcmp(argv[i], "--duration") == 0 && has_value)
+            {
+                options.duration_sec = std::strtod(argv[++i], nullptr);
+            }
+            else if (std::strcmp(argv[i], "--host") == 0 && has_value)
+            {
+                options.host = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--port") == 0 && has_value)
+            {
+                options.port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (std::strcmp(argv[i], "--script") == 0 && has_value)
+            {
+                options.script_path = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--seed") == 0 && has_value)
+            {
+                options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (std::strcmp(argv[i], "--tcp") == 0)
+            {
+                options.use_datagrams = false;
+            }
+            else if (std::strcmp(argv[i], "--local") == 0)
+            {
+                options.local_server = true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return options.sessions > 0 && options.duration_sec > 0.0;
+    }
+
+    // The game inputs of a recorded session, in the order they were received
+    std::vector<GameInput> load_script(const std::string& path) {
+        std::vector<GameInput> script;
+        auto log_opt = read_input_log(path);
+
+        if (log_opt.has_value())
+        {
+            for (const auto& record : log_opt->records)
+            {
+                if (record.kind == InputLogRecordKind::Input)
+                {
+                    script.push_back(record.input.game_input);
+                }
+            }
+        }
+
+        return script;
+    }
+
+    bool connect_bot(Bot& bot, const LoadOptions& options) {
+        bot.socket = std::make_shared<ClientSocket>(options.host, options.port);
+
+        if (!bot.socket->connect_to_server())
+        {
+            return false;
+        }
+
+        bot.transport = std::make_shared<PacketStreamClient>(bot.socket);
+
+        const auto datagram_address = DatagramSocket::resolve(options.host, options.port);
+
+        if (options.use_datagrams && datagram_address.has_value())
+        {
+            bot.transport = std::make_shared<DatagramClientTransport>(bot.transport, datagram_address.value());
+        }
+
+        bot.transport->start();
+
+        // Same as App::run
+        auto hello = ClientHello{};
+        hello.frame_encodings = frame_encoding_bit(FrameEncoding::Full);
+
+        if (socket_constants::ENABLE_COMPACT_FRAMES)
+        {
+            hello.frame_encodings |= frame_encoding_bit(FrameEncoding::Compact);
+        }
+
+        if (!bot.transport->send_packet(make_packet(hello)))
+        {
+            return false;
+        }
+
+        bot.state = BotState::WaitServerAccept;
+        bot.phase_start = Clock::now();
+
+        return true;
+    }
+
+    // Holds a random direction for a random number of ticks
+    void next_random_arrows(Bot& bot) {
+        if (bot.hold_ticks > 0)
+        {
+            bot.hold_ticks--;
+
+            return;
+        }
+
+        bot.arrows = ArrowState{};
+        bot.arrows.held = std::bitset<static_cast<size_t>(Arrow::Count)>(bot.random() & 0xF);
+        bot.hold_ticks = 10 + bot.random() % 50;
+    }
+
+    void send_inputs(Bot& bot, const std::vector<GameInput>& script, Clock::time_point now) {
+        // Drop the backlog instead of flooding the server after a stall
+        if (now - bot.next_input > MAX_INPUT_BURST * TICK_INTERVAL)
+        {
+            bot.next_input = now;
+        }
+
+        while (bot.next_input <= now)
+        {
+            bot.next_input += TICK_INTERVAL;
+
+            ClientInput input = {};
+
+            if (!script.empty())
+            {
+                input.game_input = script[bot.script_index];
+                bot.script_index = (bot.script_index + 1) % script.size();
+            }
+            else
+            {
+                next_random_arrows(bot);
+                input.game_input.arrows = bot.arrows;
+            }
+
+            input.input_sequence = ++bot.input_sequence;
+
+            bot.transport->send_packet(make_packet(input));
+        }
+    }
+
+    void receive_frames(Bot& bot, Clock::time_point now) {
+        bot.received_frames.clear();
+        bot.transport->poll_frames(bot.received_frames);
+
+        for (const auto& frame : bot.received_frames)
+        {
+            if (!bot.has_frame)
+            {
+                bot.has_frame = true;
+                bot.first_frame_time = now;
+            }
+            else if (frame.timestamp <= bot.last_timestamp)
+            {
+                bot.stale_frames++;
+
+                continue;
+            }
+            else
+            {
+                bot.missing_ticks += frame.timestamp - bot.last_timestamp - 1;
+
+                const auto interval = std::chrono::duration<double, std::milli>(now - bot.last_frame_time).count();
+                const auto tick_msec = std::chrono::duration<double, std::milli>(TICK_INTERVAL).count();
+
+                bot.jitter_msec.push_back(std::abs(interval - tick_msec));
+            }
+
+            bot.frames++;
+            bot.last_frame_time = now;
+            bot.last_timestamp = frame.timestamp;
+        }
+    }
+
+    // Advances the handshake or the game of one bot by one poll
+    void step_bot(Bot& bot, const std::vector<GameInput>& script, Clock::time_point now) {
+        if (bot.state == BotState::Failed)
+        {
+            return;
+        }
+
+        if (bot.transport->get_recv_exception() != nullptr || !bot.transport->is_running())
+        {
+            bot.state = BotState::Failed;
+
+            return;
+        }
+
+        if (bot.state == BotState::Playing)
+        {
+            send_inputs(bot, script, now);
+            receive_frames(bot, now);
+
+            return;
+        }
+
+        const auto expected = bot.state == BotState::WaitServerAccept
+            ? PayloadType::ServerAccept
+            : PayloadType::ServerGameResponse;
+
+        while (auto packet_opt = bot.transport->poll_packet())
+        {
+            if (packet_opt->header.payload_type != expected)
+            {
+                continue;
+            }
+
+            if (bot.state == BotState::WaitServerAccept)
+            {
+                bot.transport->send_packet(make_packet<ClientGameRequest>({}));
+                bot.state = BotState::WaitGameResponse;
+            }
+            else
+            {
+                bot.state = BotState::Playing;
+                bot.next_input = now;
+            }
+
+            bot.phase_start = now;
+
+            return;
+        }
+
+        if (now - bot.phase_start > HANDSHAKE_TIMEOUT)
+        {
+            bot.state = BotState::Failed;
+        }
+    }
+
+    double percentile(std::vector<double>& sorted_values, double p) {
+        if (sorted_values.empty())
+        {
+            return 0.0;
+        }
+
+        return sorted_values[static_cast<size_t>(p * static_cast<double>(sorted_values.size() - 1) + 0.5)];
+    }
+
+    void print_stats(const std::string& name, std::vector<double> jitter, uint64_t frames, double seconds, uint64_t missing, uint64_t stale) {
+        std::sort(jitter.begin(), jitter.end());
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << name << ": " << frames << " frames, "
+                  << (seconds > 0.0 ? static_cast<double>(frames) / seconds : 0.0) << " frames/s, jitter p50 "
+                  << percentile(jitter, 0.50) << " ms, p90 " << percentile(jitter, 0.90) << " ms, p99 "
+                  << percentile(jitter, 0.99) << " ms, max " << (jitter.empty() ? 0.0 : jitter.back()) << " ms, "
+                  << missing << " missing ticks, " << stale << " stale frames" << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+
+    if (!parse_options(argc, argv, options))
+    {
+        std::cerr << "Usage: load_generator [--sessions N] [--duration SEC] [--host ADDR] [--port PORT] "
+                  << "[--script <input log>] [--seed N] [--tcp] [--local]" << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<GameServerMaster> local_server;
+
+    if (options.local_server)
+    {
+        local_server = std::make_shared<GameServerMaster>(options.port, options.sessions);
+
+        if (!local_server->initialize())
+        {
+            std::cerr << "[load_generator] ERROR: Failed to initialize the local server" << "\n";
+
+            return EXIT_FAILURE;
+        }
+
+        local_server->run_async();
+        local_server->wait_for_accept_ready(100, 50);
+    }
+
+    const auto script = options.script_path.empty()
+        ? std::vector<GameInput>{}
+        : load_script(options.script_path);
+
+    if (!options.script_path.empty() && script.empty())
+    {
+        std::cerr << "[load_generator] ERROR: No inputs in " << options.script_path << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Bot> bots(options.sessions);
+
+    for (size_t i = 0; i < bots.size(); i++)
+    {
+        bots[i].random.seed(options.seed + static_cast<uint32_t>(i));
+        bots[i].script_index = script.empty() ? 0 : i * 97 % script.size();
+
+        if (!connect_bot(bots[i], options))
+        {
+            std::cerr << "[load_generator] ERROR: Session " << i << " failed to connect" << "\n";
+        }
+    }
+
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration_sec));
+
+    while (true)
+    {
+        const auto now = Clock::now();
+
+        if (now >= end)
+        {
+            break;
+        }
+
+        for (auto& bot : bots)
+        {
+            step_bot(bot, script, now);
+        }
+
+        std::this_thread::sleep_until(now + POLL_INTERVAL);
+    }
+
+    // Report
+    std::vector<double> all_jitter;
+    uint64_t all_frames = 0;
+    uint64_t all_missing = 0;
+    uint64_t all_stale = 0;
+    double all_seconds = 0.0;
+    size_t playing = 0;
+
+    for (size_t i = 0; i < bots.size(); i++)
+    {
+        auto& bot = bots[i];
+
+        if (bot.transport != nullptr && bot.transport->is_running())
+        {
+            bot.transport->send_packet(make_packet<ClientGoodbye>({}));
+            bot.transport->stop();
+        }
+
+        if (!bot.has_frame)
+        {
+            std::cout << "session " << i << ": no frames" << "\n";
+
+            continue;
+        }
+
+        const auto seconds = std::chrono::duration<double>(bot.last_frame_time - bot.first_frame_time).count();
+
+        print_stats("session " + std::to_string(i), bot.jitter_msec, bot.frames, seconds, bot.missing_ticks, bot.stale_frames);
+
+        all_jitter.insert(all_jitter.end(), bot.jitter_msec.begin(), bot.jitter_msec.end());
+        all_frames  += bot.frames;
+        all_missing += bot.missing_ticks;
+        all_stale   += bot.stale_frames;
+        all_seconds += seconds;
+        playing++;
+    }
+
+    std::cout << playing << " of " << bots.size() << " sessions received frames" << "\n";
+
+    if (playing > 0)
+    {
+        // Per session average rate, percentiles over every interval
+        print_stats("all", std::move(all_jitter), all_frames, all_seconds, all_missing, all_stale);
+    }
+
+    if (local_server != nullptr)
+    {
+        const auto stats = local_server->get_tick_stats();
+
+        std::cout << "server: tick " << stats.tick << ", " << stats.sessions << " sessions, last tick "
+                  << stats.duration.count() << " us, " << stats.overruns << " overruns, "
+                  << stats.skipped_ticks << " skipped ticks" << "\n";
+
+        local_server->stop();
+    }
+
+    for (auto& bot : bots)
+    {
+        if (bot.socket != nullptr)
+        {
+            bot.socket->disconnect();
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
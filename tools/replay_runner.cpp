@@ -0,0 +1,242 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sol/sol.hpp>
+#include "config_constants.hpp"
+#include "bullet_pattern/pattern_compiler.hpp"
+#include "game_simulation/game_simulation.hpp"
+#include "game_simulation/input_log.hpp"
+#include "game_simulation/state_hash.hpp"
+#include "packet_serializer/frame_serializer.hpp"
+
+/*
+    Runs an input log through the simulation as fast as the CPU allows, no sleeps and no sockets
+
+    Usage: replay_runner <log> [--hashes] [--frames <path>] [--expect <hash>] [--ignore-patterns]
+
+    --hashes            prints "<tick> <state hash>" after every step
+    --frames <path>     writes every frame, serialized as on the wire and prefixed with its uint32_t size
+    --expect <hash>     fails unless the state hash after the last step is <hash> (hex), for regression tests
+    --ignore-patterns   replays even if the attack patterns differ from the recorded ones (for profiling)
+
+    Always prints the final state hash, the replay speed and the slowest ticks.
+    The attack patterns are compiled from assets/pattern/patterns.lua. The log holds the hash
+    of the patterns it was recorded with, other patterns are reported as a pattern mismatch
+    and the log is not replayed, since the state hashes could never match.
+*/
+namespace {
+    constexpr size_t SLOWEST_TICK_COUNT = 5;
+
+    struct TickTime {
+        uint64_t    tick;
+        double      usec;
+    };
+
+    struct RunnerOptions {
+        std::string             log_path;
+        std::string             frames_path;
+        bool                    print_hashes    = false;
+        bool                    check_hash      = false;
+        uint64_t                expected_hash   = 0;
+        bool                    ignore_patterns = false;
+    };
+
+    bool parse_options(int argc, char* argv[], RunnerOptions& options) {
+        for (int i = 1; i < argc; i++)
+        {
+            const auto has_value = i + 1 < argc;
+
+            if (std::strcmp(argv[i], "--hashes") == 0)
+            {
+                options.print_hashes = true;
+            }
+            else if (std::strcmp(argv[i], "--frames") == 0 && has_value)
+            {
+                options.frames_path = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--expect") == 0 && has_value)
+            {
+                options.check_hash = true;
+                options.expected_hash = std::strtoull(argv[++i], nullptr, 16);
+            }
+            else if (std::strcmp(argv[i], "--ignore-patterns") == 0)
+            {
+                options.ignore_patterns = true;
+            }
+            else if (argv[i][0] != '-' && options.log_path.empty())
+            {
+                options.log_path = argv[i];
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return !options.log_path.empty();
+    }
+
+    std::shared_ptr<const PatternLibrary> load_patterns() {
+        sol::state lua;
+        lua.open_libraries(
+            sol::lib::base,
+            sol::lib::package,
+            sol::lib::math
+        );
+
+        std::string lua_package_path = std::string(assets_constants::PATTERN_DIR)   + "/?.lua;"
+                                     + std::string(assets_constants::SPRITE_DIR)    + "/?.lua;";
+
+        lua.script("package.path = package.path .. \";" + lua_package_path + "\"");
+
+        auto library_opt = load_pattern_library(lua, std::string(assets_constants::PATTERN_DIR) + "/patterns.lua");
+
+        if (!library_opt.has_value())
+        {
+            return nullptr;
+        }
+
+        return std::make_shared<const PatternLibrary>(std::move(library_opt.value()));
+    }
+
+    // Keeps the slowest ticks, sorted from the slowest
+    void track_slowest(std::vector<TickTime>& slowest, const TickTime& time) {
+        auto it = slowest.begin();
+
+        while (it != slowest.end() && it->usec >= time.usec)
+        {
+            it++;
+        }
+
+        if (it - slowest.begin() < static_cast<std::ptrdiff_t>(SLOWEST_TICK_COUNT))
+        {
+            slowest.insert(it, time);
+
+            if (slowest.size() > SLOWEST_TICK_COUNT)
+            {
+                slowest.pop_back();
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    RunnerOptions options;
+
+    if (!parse_options(argc, argv, options))
+    {
+        std::cerr << "Usage: replay_runner <log> [--hashes] [--frames <path>] [--expect <hash>] [--ignore-patterns]" << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    auto log_opt = read_input_log(options.log_path);
+
+    if (!log_opt.has_value())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const auto& log = log_opt.value();
+
+    auto patterns = load_patterns();
+
+    if (patterns == nullptr)
+    {
+        std::cerr << "[replay_runner] ERROR: Failed to load the attack patterns" << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream frames_file;
+
+    if (!options.frames_path.empty())
+    {
+        frames_file.open(options.frames_path, std::ios::binary | std::ios::trunc);
+
+        if (!frames_file.is_open())
+        {
+            std::cerr << "[replay_runner] ERROR: Failed to open " << options.frames_path << "\n";
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    GameSimulation simulation(log.seed, patterns);
+
+    const auto patterns_hash = simulation.compute_patterns_hash();
+    const auto patterns_match = log.patterns_hash == patterns_hash;
+
+    if (!patterns_match)
+    {
+        std::cerr << "[replay_runner] ERROR: Pattern mismatch, the log was recorded with patterns "
+                  << std::hex << log.patterns_hash << " but " << assets_constants::PATTERN_DIR
+                  << "/patterns.lua compiles to " << patterns_hash << std::dec << "\n";
+
+        if (!options.ignore_patterns)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::byte> frame_buffer;
+    std::vector<TickTime> slowest;
+
+    auto tick_start = std::chrono::steady_clock::now();
+    const auto start = tick_start;
+
+    const auto steps = replay_input_log(log, simulation, [&](uint64_t tick) {
+        // The inputs of the tick are part of its time
+        const auto tick_end = std::chrono::steady_clock::now();
+        track_slowest(slowest, TickTime{ tick, std::chrono::duration<double, std::micro>(tick_end - tick_start).count() });
+
+        if (options.print_hashes)
+        {
+            std::cout << tick << " " << std::hex << std::setw(16) << std::setfill('0')
+                      << simulation.compute_state_hash() << std::dec << "\n";
+        }
+
+        if (frames_file.is_open())
+        {
+            frame_buffer.clear();
+            serialize_frame_into(simulation.get_frame(), frame_buffer);
+
+            const auto size = static_cast<uint32_t>(frame_buffer.size());
+            frames_file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            frames_file.write(reinterpret_cast<const char*>(frame_buffer.data()), static_cast<std::streamsize>(size));
+        }
+
+        tick_start = std::chrono::steady_clock::now();
+    });
+
+    const auto msec = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const auto hash = simulation.compute_state_hash();
+
+    std::cout << "seed " << std::hex << log.seed << std::dec << ", " << log.records.size() << " records, "
+              << steps << " ticks in " << msec << " ms, "
+              << (msec > 0.0 ? static_cast<double>(steps) / msec : 0.0) << " ticks/ms" << "\n";
+
+    for (const auto& time : slowest)
+    {
+        std::cout << "slow tick " << time.tick << ": " << time.usec << " us" << "\n";
+    }
+
+    std::cout << "final hash " << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << "\n";
+
+    if (options.check_hash && hash != options.expected_hash)
+    {
+        // With other patterns a different hash is expected, it says nothing about determinism
+        const auto reason = patterns_match ? "The replay diverged" : "The patterns differ";
+
+        std::cerr << "[replay_runner] ERROR: " << reason << ", expected hash " << std::hex << options.expected_hash << std::dec << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}